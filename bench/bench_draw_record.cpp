@@ -0,0 +1,523 @@
+// bench_draw_record.cpp
+// Cas nahravania command buffera pre N rozsahov chunkov (bez okna, staci Vulkan device,
+// napr. lavapipe). Porovnava tri sposoby, ako World::draw posiela geometriu:
+//   bind/chunk  - VBO/IBO bind + vkCmdDrawIndexed na kazdy chunk (pred GeometryPool)
+//   direct      - bind raz na stranku + vkCmdDrawIndexed na kazdy rozsah
+//   mdi         - prikazy do namapovaneho bufferu + jeden vkCmdDrawIndexedIndirect na stranku
+// Meria sa vkBeginCommandBuffer .. vkEndCommandBuffer (pri mdi vratane zapisu prikazov),
+// median z --iters opakovani. Kazdy sposob sa raz aj odosle, nech driver overi, ze plati.
+//
+// Druha tabulka: direct a mdi paralelne cez ParallelRecorder (ako World::recordParallel) -
+// rozsahy sa rozdelia medzi 1, 2, 4... vlakien, kazde nahra vlastny secondary buffer a primary
+// ich vykona. Meria sa cely frame (rozdelenie, secondary buffery, primary s vkCmdExecuteCommands).
+//
+//   bench_draw_record [--iters N] [--shaders dir] [--threads N]
+#include <vulkan/vulkan.h>
+#include "parallel_record.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef BENCH_SHADER_DIR
+#define BENCH_SHADER_DIR "shaders"
+#endif
+
+#define BENCH_CHECK(call)                                                          \
+    do {                                                                           \
+        VkResult r_ = (call);                                                      \
+        if (r_ != VK_SUCCESS) {                                                    \
+            std::fprintf(stderr, "[Bench] %s failed (%d)\n", #call, (int)r_);      \
+            std::exit(1);                                                          \
+        }                                                                          \
+    } while (0)
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint32_t RANGES_PER_PAGE = 1000;   // ~ chunkov v jednej stranke GeometryPool
+static constexpr uint32_t INDICES_PER_RANGE = 600;
+static constexpr uint32_t VERTS_PER_RANGE = 400;
+static constexpr uint32_t EXTENT = 64;              // offscreen ciel
+
+struct Gpu {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice phys = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t family = 0;
+    VkQueue queue = VK_NULL_HANDLE;
+    bool multiDraw = false;
+    uint32_t maxDrawCount = 1;
+};
+
+static uint32_t memoryType(const Gpu& g, uint32_t bits, VkMemoryPropertyFlags props)
+{
+    VkPhysicalDeviceMemoryProperties mp{};
+    vkGetPhysicalDeviceMemoryProperties(g.phys, &mp);
+    for (uint32_t i = 0; i < mp.memoryTypeCount; ++i)
+        if ((bits & (1u << i)) && (mp.memoryTypes[i].propertyFlags & props) == props) return i;
+    std::fprintf(stderr, "[Bench] no memory type\n");
+    std::exit(1);
+}
+
+static void makeBuffer(const Gpu& g, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags props,
+    VkBuffer& buf, VkDeviceMemory& mem)
+{
+    VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bi.size = size;
+    bi.usage = usage;
+    BENCH_CHECK(vkCreateBuffer(g.device, &bi, nullptr, &buf));
+    VkMemoryRequirements req{};
+    vkGetBufferMemoryRequirements(g.device, buf, &req);
+    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    ai.allocationSize = req.size;
+    ai.memoryTypeIndex = memoryType(g, req.memoryTypeBits, props);
+    BENCH_CHECK(vkAllocateMemory(g.device, &ai, nullptr, &mem));
+    BENCH_CHECK(vkBindBufferMemory(g.device, buf, mem, 0));
+}
+
+static std::vector<char> readSpv(const std::string& path)
+{
+    std::ifstream f(path, std::ios::ate | std::ios::binary);
+    if (!f) { std::fprintf(stderr, "[Bench] cannot open %s\n", path.c_str()); std::exit(1); }
+    std::vector<char> code((size_t)f.tellg());
+    f.seekg(0);
+    f.read(code.data(), code.size());
+    return code;
+}
+
+static VkShaderModule shaderModule(const Gpu& g, const std::string& path)
+{
+    const std::vector<char> code = readSpv(path);
+    VkShaderModuleCreateInfo ci{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    ci.codeSize = code.size();
+    ci.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    VkShaderModule m = VK_NULL_HANDLE;
+    BENCH_CHECK(vkCreateShaderModule(g.device, &ci, nullptr, &m));
+    return m;
+}
+
+static Gpu createGpu()
+{
+    Gpu g;
+    VkApplicationInfo app{ VK_STRUCTURE_TYPE_APPLICATION_INFO };
+    app.pApplicationName = "bench_draw_record";
+    app.apiVersion = VK_API_VERSION_1_2;
+    VkInstanceCreateInfo ici{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+    ici.pApplicationInfo = &app;
+    BENCH_CHECK(vkCreateInstance(&ici, nullptr, &g.instance));
+
+    uint32_t n = 0;
+    vkEnumeratePhysicalDevices(g.instance, &n, nullptr);
+    std::vector<VkPhysicalDevice> devs(n);
+    vkEnumeratePhysicalDevices(g.instance, &n, devs.data());
+    for (VkPhysicalDevice d : devs) {
+        uint32_t fc = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(d, &fc, nullptr);
+        std::vector<VkQueueFamilyProperties> fams(fc);
+        vkGetPhysicalDeviceQueueFamilyProperties(d, &fc, fams.data());
+        for (uint32_t i = 0; i < fc && !g.phys; ++i)
+            if (fams[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) { g.phys = d; g.family = i; }
+        if (g.phys) break;
+    }
+    if (!g.phys) { std::fprintf(stderr, "[Bench] no Vulkan device with graphics\n"); std::exit(1); }
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(g.phys, &props);
+    VkPhysicalDeviceFeatures supported{};
+    vkGetPhysicalDeviceFeatures(g.phys, &supported);
+    g.multiDraw = supported.multiDrawIndirect == VK_TRUE;
+    g.maxDrawCount = g.multiDraw ? std::max(1u, props.limits.maxDrawIndirectCount) : 1;
+    std::printf("[Bench] %s, multiDrawIndirect %s\n", props.deviceName, g.multiDraw ? "yes" : "no");
+
+    const float prio = 1.0f;
+    VkDeviceQueueCreateInfo qci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+    qci.queueFamilyIndex = g.family;
+    qci.queueCount = 1;
+    qci.pQueuePriorities = &prio;
+    VkPhysicalDeviceFeatures feats{};
+    feats.multiDrawIndirect = supported.multiDrawIndirect;
+    VkDeviceCreateInfo dci{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+    dci.queueCreateInfoCount = 1;
+    dci.pQueueCreateInfos = &qci;
+    dci.pEnabledFeatures = &feats;
+    BENCH_CHECK(vkCreateDevice(g.phys, &dci, nullptr, &g.device));
+    vkGetDeviceQueue(g.device, g.family, 0, &g.queue);
+    return g;
+}
+
+enum class Mode { BindPerChunk, Direct, Mdi };
+static const char* modeName(Mode m)
+{
+    return m == Mode::BindPerChunk ? "bind/chunk" : m == Mode::Direct ? "direct" : "mdi";
+}
+
+struct Scene {
+    uint32_t ranges = 0, pages = 0;
+    std::vector<VkBuffer> vbo, ibo;       // jedna dvojica na stranku
+    std::vector<VkDeviceMemory> mem;
+    VkBuffer indirect = VK_NULL_HANDLE;   // host-visible, trvalo namapovany
+    VkDeviceMemory indirectMem = VK_NULL_HANDLE;
+    VkDrawIndexedIndirectCommand* cmds = nullptr;
+};
+
+static Scene createScene(const Gpu& g, uint32_t ranges)
+{
+    Scene s;
+    s.ranges = ranges;
+    s.pages = (ranges + RANGES_PER_PAGE - 1) / RANGES_PER_PAGE;
+    for (uint32_t p = 0; p < s.pages; ++p) {
+        VkBuffer v, i;
+        VkDeviceMemory vm, im;
+        makeBuffer(g, VkDeviceSize(RANGES_PER_PAGE) * VERTS_PER_RANGE * 44, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, v, vm);
+        // indexy su nuly => degenerovane trojuholniky, GPU skoro nic nerobi
+        makeBuffer(g, VkDeviceSize(RANGES_PER_PAGE) * INDICES_PER_RANGE * 4, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, i, im);
+        void* p0 = nullptr;
+        BENCH_CHECK(vkMapMemory(g.device, im, 0, VK_WHOLE_SIZE, 0, &p0));
+        std::memset(p0, 0, size_t(RANGES_PER_PAGE) * INDICES_PER_RANGE * 4);
+        vkUnmapMemory(g.device, im);
+        s.vbo.push_back(v); s.ibo.push_back(i);
+        s.mem.push_back(vm); s.mem.push_back(im);
+    }
+    makeBuffer(g, VkDeviceSize(ranges) * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, s.indirect, s.indirectMem);
+    void* p = nullptr;
+    BENCH_CHECK(vkMapMemory(g.device, s.indirectMem, 0, VK_WHOLE_SIZE, 0, &p));
+    s.cmds = static_cast<VkDrawIndexedIndirectCommand*>(p);
+    return s;
+}
+
+static void destroyScene(const Gpu& g, Scene& s)
+{
+    vkUnmapMemory(g.device, s.indirectMem);
+    vkDestroyBuffer(g.device, s.indirect, nullptr);
+    vkFreeMemory(g.device, s.indirectMem, nullptr);
+    for (VkBuffer b : s.vbo) vkDestroyBuffer(g.device, b, nullptr);
+    for (VkBuffer b : s.ibo) vkDestroyBuffer(g.device, b, nullptr);
+    for (VkDeviceMemory m : s.mem) vkFreeMemory(g.device, m, nullptr);
+}
+
+struct Target {
+    VkRenderPass pass = VK_NULL_HANDLE;
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory mem = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFramebuffer fb = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
+
+static Target createTarget(const Gpu& g, const std::string& shaderDir)
+{
+    Target t;
+    const VkFormat fmt = VK_FORMAT_R8G8B8A8_UNORM;
+    VkAttachmentDescription att{};
+    att.format = fmt;
+    att.samples = VK_SAMPLE_COUNT_1_BIT;
+    att.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    att.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    att.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    att.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    att.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    att.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    VkAttachmentReference ref{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    VkSubpassDescription sub{};
+    sub.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    sub.colorAttachmentCount = 1;
+    sub.pColorAttachments = &ref;
+    VkRenderPassCreateInfo rp{ VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    rp.attachmentCount = 1;
+    rp.pAttachments = &att;
+    rp.subpassCount = 1;
+    rp.pSubpasses = &sub;
+    BENCH_CHECK(vkCreateRenderPass(g.device, &rp, nullptr, &t.pass));
+
+    VkImageCreateInfo ii{ VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    ii.imageType = VK_IMAGE_TYPE_2D;
+    ii.format = fmt;
+    ii.extent = { EXTENT, EXTENT, 1 };
+    ii.mipLevels = 1;
+    ii.arrayLayers = 1;
+    ii.samples = VK_SAMPLE_COUNT_1_BIT;
+    ii.tiling = VK_IMAGE_TILING_OPTIMAL;
+    ii.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    BENCH_CHECK(vkCreateImage(g.device, &ii, nullptr, &t.image));
+    VkMemoryRequirements req{};
+    vkGetImageMemoryRequirements(g.device, t.image, &req);
+    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    ai.allocationSize = req.size;
+    ai.memoryTypeIndex = memoryType(g, req.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    BENCH_CHECK(vkAllocateMemory(g.device, &ai, nullptr, &t.mem));
+    BENCH_CHECK(vkBindImageMemory(g.device, t.image, t.mem, 0));
+    VkImageViewCreateInfo vi{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    vi.image = t.image;
+    vi.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    vi.format = fmt;
+    vi.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    BENCH_CHECK(vkCreateImageView(g.device, &vi, nullptr, &t.view));
+    VkFramebufferCreateInfo fi{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+    fi.renderPass = t.pass;
+    fi.attachmentCount = 1;
+    fi.pAttachments = &t.view;
+    fi.width = EXTENT;
+    fi.height = EXTENT;
+    fi.layers = 1;
+    BENCH_CHECK(vkCreateFramebuffer(g.device, &fi, nullptr, &t.fb));
+
+    // triangle.vert/.frag: bez vertex vstupu, takze staci prazdny layout a VBO sa len bindne
+    VkShaderModule vs = shaderModule(g, shaderDir + "/triangle.vert.spv");
+    VkShaderModule fs = shaderModule(g, shaderDir + "/triangle.frag.spv");
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0] = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT, vs, "main", nullptr };
+    stages[1] = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_FRAGMENT_BIT, fs, "main", nullptr };
+    VkPipelineVertexInputStateCreateInfo vin{ VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    VkPipelineInputAssemblyStateCreateInfo ia{ VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkViewport viewport{ 0, 0, (float)EXTENT, (float)EXTENT, 0, 1 };
+    VkRect2D scissor{ { 0, 0 }, { EXTENT, EXTENT } };
+    VkPipelineViewportStateCreateInfo vps{ VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    vps.viewportCount = 1; vps.pViewports = &viewport;
+    vps.scissorCount = 1; vps.pScissors = &scissor;
+    VkPipelineRasterizationStateCreateInfo rs{ VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    rs.polygonMode = VK_POLYGON_MODE_FILL;
+    rs.cullMode = VK_CULL_MODE_NONE;
+    rs.lineWidth = 1.0f;
+    VkPipelineMultisampleStateCreateInfo ms{ VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    VkPipelineColorBlendAttachmentState cba{};
+    cba.colorWriteMask = 0xF;
+    VkPipelineColorBlendStateCreateInfo cbs{ VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    cbs.attachmentCount = 1;
+    cbs.pAttachments = &cba;
+    VkPipelineLayoutCreateInfo plci{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    BENCH_CHECK(vkCreatePipelineLayout(g.device, &plci, nullptr, &t.layout));
+    VkGraphicsPipelineCreateInfo pci{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+    pci.stageCount = 2;
+    pci.pStages = stages;
+    pci.pVertexInputState = &vin;
+    pci.pInputAssemblyState = &ia;
+    pci.pViewportState = &vps;
+    pci.pRasterizationState = &rs;
+    pci.pMultisampleState = &ms;
+    pci.pColorBlendState = &cbs;
+    pci.layout = t.layout;
+    pci.renderPass = t.pass;
+    BENCH_CHECK(vkCreateGraphicsPipelines(g.device, VK_NULL_HANDLE, 1, &pci, nullptr, &t.pipeline));
+    vkDestroyShaderModule(g.device, vs, nullptr);
+    vkDestroyShaderModule(g.device, fs, nullptr);
+    return t;
+}
+
+static void destroyTarget(const Gpu& g, Target& t)
+{
+    vkDestroyPipeline(g.device, t.pipeline, nullptr);
+    vkDestroyPipelineLayout(g.device, t.layout, nullptr);
+    vkDestroyFramebuffer(g.device, t.fb, nullptr);
+    vkDestroyImageView(g.device, t.view, nullptr);
+    vkDestroyImage(g.device, t.image, nullptr);
+    vkFreeMemory(g.device, t.mem, nullptr);
+    vkDestroyRenderPass(g.device, t.pass, nullptr);
+}
+
+static void beginPass(const Target& t, VkCommandBuffer cb, VkSubpassContents contents)
+{
+    VkCommandBufferBeginInfo bi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    BENCH_CHECK(vkBeginCommandBuffer(cb, &bi));
+    VkClearValue clear{};
+    VkRenderPassBeginInfo rp{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    rp.renderPass = t.pass;
+    rp.framebuffer = t.fb;
+    rp.renderArea.extent = { EXTENT, EXTENT };
+    rp.clearValueCount = 1;
+    rp.pClearValues = &clear;
+    vkCmdBeginRenderPass(cb, &rp, contents);
+}
+
+// rozsahy [from, to) ako World::draw (bind na stranku); vrati pocet vkCmdDraw* volani
+static uint32_t drawRanges(const Gpu& g, Scene& s, Mode mode, VkCommandBuffer cb, uint32_t from, uint32_t to)
+{
+    uint32_t calls = 0;
+    for (uint32_t p = from / RANGES_PER_PAGE; p * RANGES_PER_PAGE < to; ++p) {
+        const uint32_t first = std::max(from, p * RANGES_PER_PAGE);
+        const uint32_t n = std::min((p + 1) * RANGES_PER_PAGE, to) - first;
+        const uint32_t local = first - p * RANGES_PER_PAGE;   // index rozsahu v stranke
+        const VkDeviceSize off = 0;
+        if (mode != Mode::BindPerChunk) {
+            vkCmdBindVertexBuffers(cb, 0, 1, &s.vbo[p], &off);
+            vkCmdBindIndexBuffer(cb, s.ibo[p], 0, VK_INDEX_TYPE_UINT32);
+        }
+        if (mode == Mode::Mdi && g.multiDraw) {
+            for (uint32_t i = 0; i < n; ++i) {
+                VkDrawIndexedIndirectCommand& c = s.cmds[first + i];
+                c.indexCount = INDICES_PER_RANGE;
+                c.instanceCount = 1;
+                c.firstIndex = (local + i) * INDICES_PER_RANGE;
+                c.vertexOffset = int32_t((local + i) * VERTS_PER_RANGE);
+                c.firstInstance = 0;
+            }
+            for (uint32_t done = 0; done < n; done += g.maxDrawCount, ++calls)
+                vkCmdDrawIndexedIndirect(cb, s.indirect,
+                    VkDeviceSize(first + done) * sizeof(VkDrawIndexedIndirectCommand),
+                    std::min(g.maxDrawCount, n - done), sizeof(VkDrawIndexedIndirectCommand));
+            continue;
+        }
+        for (uint32_t i = 0; i < n; ++i, ++calls) {
+            if (mode == Mode::BindPerChunk) {
+                vkCmdBindVertexBuffers(cb, 0, 1, &s.vbo[p], &off);
+                vkCmdBindIndexBuffer(cb, s.ibo[p], 0, VK_INDEX_TYPE_UINT32);
+            }
+            vkCmdDrawIndexed(cb, INDICES_PER_RANGE, 1, (local + i) * INDICES_PER_RANGE,
+                int32_t((local + i) * VERTS_PER_RANGE), 0);
+        }
+    }
+    return calls;
+}
+
+// jeden frame scenou ako World::draw; vrati pocet vkCmdDraw* volani
+static uint32_t record(const Gpu& g, const Target& t, Scene& s, Mode mode, VkCommandBuffer cb)
+{
+    beginPass(t, cb, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, t.pipeline);
+    const uint32_t calls = drawRanges(g, s, mode, cb, 0, s.ranges);
+    vkCmdEndRenderPass(cb);
+    BENCH_CHECK(vkEndCommandBuffer(cb));
+    return calls;
+}
+
+// ten isty frame cez secondary buffery: uloha = suvisly kus rozsahov (ako World::recordParallel)
+static uint32_t recordParallel(const Gpu& g, const Target& t, Scene& s, Mode mode, ParallelRecorder& rec,
+    VkCommandBuffer cb)
+{
+    VkCommandBufferInheritanceInfo inh{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inh.renderPass = t.pass;
+    inh.framebuffer = t.fb;
+    static std::vector<VkCommandBuffer> secondaries;
+    std::atomic<uint32_t> calls{ 0 };
+    const uint32_t jobs = (uint32_t)rec.threadCount();
+    const bool ok = rec.record(g.device, 0, inh, jobs, [&](VkCommandBuffer scb, uint32_t j) {
+        vkCmdBindPipeline(scb, VK_PIPELINE_BIND_POINT_GRAPHICS, t.pipeline);   // stav sa nededi
+        const uint32_t from = uint32_t(uint64_t(s.ranges) * j / jobs);
+        const uint32_t to = uint32_t(uint64_t(s.ranges) * (j + 1) / jobs);
+        calls += drawRanges(g, s, mode, scb, from, to);
+        }, secondaries);
+    if (!ok) { std::fprintf(stderr, "[Bench] parallel record failed\n"); std::exit(1); }
+    beginPass(t, cb, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(cb, (uint32_t)secondaries.size(), secondaries.data());
+    vkCmdEndRenderPass(cb);
+    BENCH_CHECK(vkEndCommandBuffer(cb));
+    return calls;
+}
+
+static void submitAndWait(const Gpu& g, VkCommandBuffer cb, VkFence fence)
+{
+    VkSubmitInfo si{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    si.commandBufferCount = 1;
+    si.pCommandBuffers = &cb;
+    BENCH_CHECK(vkQueueSubmit(g.queue, 1, &si, fence));
+    BENCH_CHECK(vkWaitForFences(g.device, 1, &fence, VK_TRUE, UINT64_MAX));
+    BENCH_CHECK(vkResetFences(g.device, 1, &fence));
+}
+
+int main(int argc, char** argv)
+{
+    int iters = 200;
+    int maxThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::string shaderDir = BENCH_SHADER_DIR;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--iters") && i + 1 < argc) iters = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--shaders") && i + 1 < argc) shaderDir = argv[++i];
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr, "usage: %s [--iters N] [--shaders dir] [--threads N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Gpu g = createGpu();
+    Target t = createTarget(g, shaderDir);
+
+    VkCommandPoolCreateInfo pci{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    pci.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pci.queueFamilyIndex = g.family;
+    VkCommandPool pool = VK_NULL_HANDLE;
+    BENCH_CHECK(vkCreateCommandPool(g.device, &pci, nullptr, &pool));
+    VkCommandBufferAllocateInfo cai{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cai.commandPool = pool;
+    cai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cai.commandBufferCount = 1;
+    VkCommandBuffer cb = VK_NULL_HANDLE;
+    BENCH_CHECK(vkAllocateCommandBuffers(g.device, &cai, &cb));
+    VkFenceCreateInfo fci{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence = VK_NULL_HANDLE;
+    BENCH_CHECK(vkCreateFence(g.device, &fci, nullptr, &fence));
+
+    std::printf("%8s %-11s %8s %10s %10s %10s\n", "ranges", "mode", "calls", "median us", "min us", "ns/range");
+    for (uint32_t ranges : { 100u, 1000u, 10000u }) {
+        Scene s = createScene(g, ranges);
+        for (Mode mode : { Mode::BindPerChunk, Mode::Direct, Mode::Mdi }) {
+            if (mode == Mode::Mdi && !g.multiDraw) continue;
+            std::vector<double> us;
+            uint32_t calls = 0;
+            for (int it = 0; it < iters; ++it) {
+                BENCH_CHECK(vkResetCommandBuffer(cb, 0));
+                const auto t0 = Clock::now();
+                calls = record(g, t, s, mode, cb);
+                us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+            }
+            // posledny zaznam naozaj vykonaj (validacia / driver)
+            submitAndWait(g, cb, fence);
+
+            std::sort(us.begin(), us.end());
+            const double med = us[us.size() / 2];
+            std::printf("%8u %-11s %8u %10.1f %10.1f %10.1f\n",
+                ranges, modeName(mode), calls, med, us.front(), med * 1000.0 / ranges);
+        }
+        destroyScene(g, s);
+    }
+
+    std::printf("\n%8s %-11s %8s %8s %10s %10s %8s\n", "ranges", "mode", "threads", "calls", "median us", "min us", "speedup");
+    for (uint32_t ranges : { 10000u, 20000u }) {
+        Scene s = createScene(g, ranges);
+        for (Mode mode : { Mode::Direct, Mode::Mdi }) {
+            if (mode == Mode::Mdi && !g.multiDraw) continue;
+            double base = 0.0;
+            for (int threads = 1; threads <= maxThreads; threads *= 2) {
+                ParallelRecorder rec;
+                if (!rec.init(g.device, g.family, 1, threads)) return 1;
+                std::vector<double> us;
+                uint32_t calls = 0;
+                for (int it = 0; it < iters; ++it) {
+                    BENCH_CHECK(vkResetCommandBuffer(cb, 0));
+                    const auto t0 = Clock::now();
+                    calls = recordParallel(g, t, s, mode, rec, cb);
+                    us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+                }
+                submitAndWait(g, cb, fence);
+                BENCH_CHECK(vkResetCommandBuffer(cb, 0));   // odkazuje na secondary buffery rec
+                rec.shutdown(g.device);
+
+                std::sort(us.begin(), us.end());
+                const double med = us[us.size() / 2];
+                if (threads == 1) base = med;
+                std::printf("%8u %-11s %8d %8u %10.1f %10.1f %7.2fx\n",
+                    ranges, modeName(mode), threads, calls, med, us.front(), base / med);
+            }
+        }
+        destroyScene(g, s);
+    }
+
+    vkDestroyFence(g.device, fence, nullptr);
+    vkDestroyCommandPool(g.device, pool, nullptr);
+    destroyTarget(g, t);
+    vkDestroyDevice(g.device, nullptr);
+    vkDestroyInstance(g.instance, nullptr);
+    return 0;
+}
@@ -0,0 +1,217 @@
+// bench_mesher.cpp
+// Meshuje pevny korpus chunkov (world_gen2 seedy, flat, heightmap, synteticke worst-case)
+// a vypise ms/chunk, quady, bajty vertexov a alokacie. Pocty quadov porovna so zlatym
+// suborom, nech optimalizacia meshera nezmeni vystup potichu.
+//
+//   bench_mesher [--iters N] [--golden path] [--update]
+//
+// Navratovy kod 1 = niektory pocet quadov nesedi so zlatym suborom.
+#include "world/chunk.hpp"
+#include "world/mesher.hpp"
+#include "world/world_gen.hpp"
+#include "world/world_gen2.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_GOLDEN_PATH
+#define BENCH_GOLDEN_PATH "bench/mesher_golden.txt"
+#endif
+
+// --- pocitadlo alokacii (cely proces; meria sa len okolo volani meshera) ---
+static std::atomic<uint64_t> g_allocs{ 0 };
+
+void* operator new(std::size_t n) {
+    ++g_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// --- korpus ---
+struct CorpusEntry {
+    std::string name;
+    std::function<void(Chunk&)> fill;
+};
+
+// 3D sachovnica: kazdy plny voxel ma 6 volnych stien a greedy nema co zlucit
+static void fillCheckerboard(Chunk& c, int height) {
+    for (int y = 0; y < height; ++y)
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                if (((x + y + z) & 1) == 0) c.set(x, y, z, BLOCK_STONE);
+}
+
+// stlpce s nahodnou vyskou a materialom: vela malych obdlznikov, ziadne velke plochy
+static void fillNoiseColumns(Chunk& c, uint32_t seed) {
+    uint32_t s = seed;
+    auto next = [&s] { s = s * 1664525u + 1013904223u; return s >> 8; };
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+            const int h = 8 + int(next() % 48);
+            const BlockID id = BlockID(1 + next() % 5);
+            for (int y = 0; y < h; ++y) c.set(x, y, z, id);
+        }
+}
+
+static std::vector<CorpusEntry> buildCorpus() {
+    std::vector<CorpusEntry> v;
+    const uint32_t seeds[] = { 1337u, 42u, 9001u };
+    const ChunkCoord coords[] = { { 0, 0, 0 }, { 3, 0, -2 }, { 96, 0, -96 } };   // posledny = ocean pri 1337
+    for (uint32_t seed : seeds)
+        for (const ChunkCoord& cc : coords) {
+            char name[64];
+            std::snprintf(name, sizeof(name), "gen_s%u_%d_%d", seed, cc.cx, cc.cz);
+            v.push_back({ name, [seed, cc](Chunk& c) { generateChunk(c, cc, seed); } });
+        }
+    v.push_back({ "flat_4", [](Chunk& c) { generateFlatChunk(c, 4, BLOCK_GRASS); } });
+    v.push_back({ "flat_32", [](Chunk& c) { generateFlatChunk(c, 32, BLOCK_STONE); } });
+    v.push_back({ "heightmap_default", [](Chunk& c) { generateHeightmapChunk(c); } });
+    v.push_back({ "heightmap_rough", [](Chunk& c) { generateHeightmapChunk(c, 20, 16, 0.25f); } });
+    v.push_back({ "noise_columns", [](Chunk& c) { fillNoiseColumns(c, 7u); } });
+    v.push_back({ "checker3d_16", [](Chunk& c) { fillCheckerboard(c, 16); } });
+    return v;
+}
+
+// --- zlaty subor: "meno quads regionQuads" na riadok, # = komentar ---
+struct Golden { uint64_t quads = 0, regionQuads = 0; };
+
+static bool loadGolden(const char* path, std::map<std::string, Golden>& out) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) return false;
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char name[128]; unsigned long long q = 0, rq = 0;
+        if (std::sscanf(line, "%127s %llu %llu", name, &q, &rq) == 3) out[name] = { q, rq };
+    }
+    std::fclose(f);
+    return true;
+}
+
+static bool saveGolden(const char* path, const std::vector<std::pair<std::string, Golden>>& rows) {
+    FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+    std::fprintf(f, "# bench_mesher golden quad counts (regenerate: bench_mesher --update)\n");
+    std::fprintf(f, "# name quads regionQuads\n");
+    for (auto& r : rows)
+        std::fprintf(f, "%s %llu %llu\n", r.first.c_str(),
+            (unsigned long long)r.second.quads, (unsigned long long)r.second.regionQuads);
+    std::fclose(f);
+    return true;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+static double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    int iters = 5;
+    const char* goldenPath = BENCH_GOLDEN_PATH;
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--iters") && i + 1 < argc) iters = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--golden") && i + 1 < argc) goldenPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--update")) update = true;
+        else {
+            std::fprintf(stderr, "usage: %s [--iters N] [--golden path] [--update]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::map<std::string, Golden> golden;
+    const bool haveGolden = loadGolden(goldenPath, golden);
+    if (!haveGolden && !update)
+        std::printf("[Bench] golden file %s not found (run with --update to create it)\n", goldenPath);
+
+    std::printf("%-22s %9s %9s %10s %10s %8s %10s %8s\n",
+        "chunk", "ms/chunk", "quads", "vtx KB", "allocs", "rgn ms", "rgn quads", "golden");
+
+    std::vector<std::pair<std::string, Golden>> rows;
+    int mismatches = 0;
+    double totalMs = 0.0, totalRegionMs = 0.0;
+    uint64_t totalQuads = 0;
+    auto chunk = std::make_unique<Chunk>();
+
+    for (const CorpusEntry& e : buildCorpus()) {
+        std::fill(chunk->blocks.begin(), chunk->blocks.end(), BLOCK_AIR);
+        e.fill(*chunk);
+
+        // cely chunk cez meshChunk (novy MeshData kazdy raz, ako v API)
+        MeshData m;
+        uint64_t allocs = 0;
+        double ms = 0.0;
+        for (int it = 0; it < iters; ++it) {
+            const uint64_t a0 = g_allocs.load();
+            auto t0 = Clock::now();
+            m = meshChunk(*chunk);
+            ms += msSince(t0);
+            allocs = g_allocs.load() - a0;   // posledna (tepla) iteracia
+        }
+        ms /= iters;
+        const uint64_t quads = m.indices.size() / 6;
+        const uint64_t vtxBytes = m.vertices.size() * sizeof(float);
+
+        // po regionoch 32^3 (ako edity) az po najvyssi plny riadok
+        const int topY = chunkTopY(*chunk);
+        uint64_t regionQuads = 0;
+        double regionMs = 0.0;
+        for (int it = 0; it < iters; ++it) {
+            uint64_t q = 0;
+            auto t0 = Clock::now();
+            for (int y = 0; y < topY; y += REGION_SIZE)
+                for (int z = 0; z < CHUNK_SIZE; z += REGION_SIZE)
+                    for (int x = 0; x < CHUNK_SIZE; x += REGION_SIZE)
+                        q += meshChunkRegion(*chunk, x, y, z, x + REGION_SIZE, y + REGION_SIZE, z + REGION_SIZE).indices.size() / 6;
+            regionMs += msSince(t0);
+            regionQuads = q;
+        }
+        regionMs /= iters;
+
+        const char* status = "-";
+        auto g = golden.find(e.name);
+        if (g != golden.end()) {
+            if (g->second.quads == quads && g->second.regionQuads == regionQuads) status = "ok";
+            else { status = "MISMATCH"; ++mismatches; }
+        }
+        else if (haveGolden) status = "new";
+
+        std::printf("%-22s %9.3f %9llu %10.1f %10llu %8.3f %10llu %8s\n", e.name.c_str(), ms,
+            (unsigned long long)quads, vtxBytes / 1024.0, (unsigned long long)allocs,
+            regionMs, (unsigned long long)regionQuads, status);
+        if (g != golden.end() && std::strcmp(status, "MISMATCH") == 0)
+            std::printf("    expected quads=%llu regionQuads=%llu\n",
+                (unsigned long long)g->second.quads, (unsigned long long)g->second.regionQuads);
+
+        rows.push_back({ e.name, Golden{ quads, regionQuads } });
+        totalMs += ms; totalRegionMs += regionMs; totalQuads += quads;
+    }
+
+    std::printf("[Bench] %zu chunks, avg %.3f ms/chunk (regions %.3f), %llu quads total, %d iteration(s)\n",
+        rows.size(), totalMs / rows.size(), totalRegionMs / rows.size(), (unsigned long long)totalQuads, iters);
+
+    if (update) {
+        if (!saveGolden(goldenPath, rows)) {
+            std::fprintf(stderr, "[Bench] cannot write %s\n", goldenPath);
+            return 2;
+        }
+        std::printf("[Bench] golden written to %s\n", goldenPath);
+        return 0;
+    }
+    if (mismatches) {
+        std::printf("[Bench] %d quad count mismatch(es) against %s\n", mismatches, goldenPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,288 @@
+// bench_occlusion.cpp
+// Softverovy occlusion culling (SoftOcclusion) bez GPU: vygeneruje (2R+1)^2 chunkov
+// (world_gen2), occludery = chunkOccluders, testovane boxy = regiony 32^3 (ako casti meshu,
+// tesny box voxelov s volnou stenou). Kamera ide po skriptovanych cestach (walk, orbit,
+// high, underground) a pre kazdu sa vypise, kolko regionov po frustum teste zakryl raster,
+// cas rasteru/testov pre 1 a N vlakien.
+//
+// Kontrola: z kazdeho zakryteho regionu sa vystreli luce (voxel DDA) z kamery do vzorky
+// jeho povrchovych voxelov vo frustum; luc, ktory nenarazi na opaque voxel = "leak"
+// (region bol naozaj viditelny). Pri konzervativnom teste ma byt 0.
+//
+//   bench_occlusion [--radius R] [--occ-radius N] [--frames F] [--threads N] [--seed S]
+//
+// Navratovy kod 1 = niektory leak.
+#include "occlusion.hpp"
+#include "frustum.hpp"
+#include "world/block_props.hpp"
+#include "world/chunk.hpp"
+#include "world/world_gen2.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+struct BenchRegion {
+    float mn[3], mx[3];
+    std::vector<glm::ivec3> samples;   // povrchove voxely (world voxel coords) pre luce
+};
+
+struct BenchChunk {
+    int cx, cz;
+    std::vector<uint64_t> opaque;            // bit na voxel, Chunk::index
+    std::vector<OccluderBox> occluders;
+};
+
+struct BenchWorld {
+    int radius = 4;
+    std::vector<BenchChunk> chunks;          // (2R+1)^2, riadok po riadku z
+    std::vector<BenchRegion> regions;
+
+    const BenchChunk* chunkAt(int cx, int cz) const {
+        if (cx < -radius || cx > radius || cz < -radius || cz > radius) return nullptr;
+        const int n = 2 * radius + 1;
+        return &chunks[size_t(cz + radius) * n + size_t(cx + radius)];
+    }
+    // world voxel; mimo vygenerovanej oblasti vzduch
+    bool opaqueAt(int x, int y, int z) const {
+        if (y < 0 || y >= CHUNK_HEIGHT) return false;
+        const int cx = (int)std::floor(x / float(CHUNK_SIZE)), cz = (int)std::floor(z / float(CHUNK_SIZE));
+        const BenchChunk* c = chunkAt(cx, cz);
+        if (!c) return false;
+        const size_t i = (size_t)Chunk::index(x - cx * CHUNK_SIZE, y, z - cz * CHUNK_SIZE);
+        return (c->opaque[i >> 6] >> (i & 63)) & 1u;
+    }
+    int groundY(int x, int z) const {
+        for (int y = CHUNK_HEIGHT - 1; y >= 0; --y) if (opaqueAt(x, y, z)) return y + 1;
+        return 0;
+    }
+};
+
+static void buildWorld(BenchWorld& w, uint32_t seed) {
+    const auto t0 = std::chrono::steady_clock::now();
+    auto chunk = std::make_unique<Chunk>();
+    size_t occluders = 0;
+    double occMs = 0.0;
+    for (int cz = -w.radius; cz <= w.radius; ++cz)
+        for (int cx = -w.radius; cx <= w.radius; ++cx) {
+            std::fill(chunk->blocks.begin(), chunk->blocks.end(), BlockID(0));
+            generateChunk(*chunk, { cx, 0, cz }, seed);
+            BenchChunk bc{ cx, cz, {}, {} };
+            const size_t n = chunk->blocks.size();
+            bc.opaque.assign((n + 63) / 64, 0);
+            for (size_t i = 0; i < n; ++i)
+                if (blockOpaque(chunk->blocks[i])) bc.opaque[i >> 6] |= uint64_t(1) << (i & 63);
+
+            const int topY = chunkTopY(*chunk);
+            const auto o0 = std::chrono::steady_clock::now();
+            chunkOccluders(*chunk, topY, cx, 0, cz, bc.occluders);
+            occMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - o0).count();
+            occluders += bc.occluders.size();
+            w.chunks.push_back(std::move(bc));
+        }
+
+    // regiony: tesny box opaque voxelov, ktore maju aspon jednu volnu stenu
+    for (const BenchChunk& c : w.chunks) {
+        for (int ry = 0; ry < REGIONS_Y; ++ry)
+            for (int rz = 0; rz < REGIONS_Z; ++rz)
+                for (int rx = 0; rx < REGIONS_X; ++rx) {
+                    glm::ivec3 lo(INT32_MAX), hi(INT32_MIN);
+                    std::vector<glm::ivec3> surf;
+                    for (int y = ry * REGION_SIZE; y < (ry + 1) * REGION_SIZE; ++y)
+                        for (int z = rz * REGION_SIZE; z < (rz + 1) * REGION_SIZE; ++z)
+                            for (int x = rx * REGION_SIZE; x < (rx + 1) * REGION_SIZE; ++x) {
+                                const int X = c.cx * CHUNK_SIZE + x, Z = c.cz * CHUNK_SIZE + z;
+                                if (!w.opaqueAt(X, y, Z)) continue;
+                                if (w.opaqueAt(X + 1, y, Z) && w.opaqueAt(X - 1, y, Z) && w.opaqueAt(X, y + 1, Z) &&
+                                    w.opaqueAt(X, y - 1, Z) && w.opaqueAt(X, y, Z + 1) && w.opaqueAt(X, y, Z - 1)) continue;
+                                const glm::ivec3 v(X, y, Z);
+                                lo = glm::min(lo, v); hi = glm::max(hi, v);
+                                surf.push_back(v);
+                            }
+                    if (surf.empty()) continue;
+                    BenchRegion r;
+                    for (int a = 0; a < 3; ++a) {
+                        r.mn[a] = (lo[a] - 0.5f) * VOXEL_SCALE;
+                        r.mx[a] = (hi[a] + 0.5f) * VOXEL_SCALE;
+                    }
+                    const size_t step = std::max<size_t>(1, surf.size() / 96);
+                    for (size_t i = 0; i < surf.size(); i += step) r.samples.push_back(surf[i]);
+                    w.regions.push_back(std::move(r));
+                }
+    }
+    const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("[Bench] %zu chunks, %zu regions, %zu occluder boxes (%.3f ms/chunk), built in %.0f ms\n",
+        w.chunks.size(), w.regions.size(), occluders, occMs / w.chunks.size(), ms);
+}
+
+// voxel DDA z kamery do stredu voxela t; true = po ceste ziadny opaque voxel
+static bool rayReaches(const BenchWorld& w, const glm::vec3& eyeWorld, const glm::ivec3& t) {
+    // voxel v pokryva [v - 0.5, v + 0.5] => posun o 0.5, nech je to [v, v + 1)
+    const glm::vec3 o = eyeWorld / VOXEL_SCALE + 0.5f;
+    const glm::vec3 target = glm::vec3(t) + 0.5f;
+    const glm::vec3 d = target - o;
+    glm::ivec3 v((int)std::floor(o.x), (int)std::floor(o.y), (int)std::floor(o.z));
+    if (w.opaqueAt(v.x, v.y, v.z)) return false;   // kamera v skale nic nevidi
+    glm::ivec3 step;
+    glm::vec3 tMax, tDelta;
+    for (int a = 0; a < 3; ++a) {
+        step[a] = d[a] > 0.0f ? 1 : (d[a] < 0.0f ? -1 : 0);
+        tDelta[a] = step[a] ? std::fabs(1.0f / d[a]) : 1e30f;
+        const float edge = step[a] > 0 ? std::floor(o[a]) + 1.0f : std::floor(o[a]);
+        tMax[a] = step[a] ? (edge - o[a]) / d[a] : 1e30f;
+    }
+    for (int guard = 0; guard < 100000; ++guard) {
+        if (v == t) return true;
+        const int a = (tMax.x < tMax.y) ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+        if (tMax[a] > 1.0f) return v == t;
+        v[a] += step[a];
+        tMax[a] += tDelta[a];
+        if (v == t) return true;
+        if (w.opaqueAt(v.x, v.y, v.z)) return false;
+    }
+    return false;
+}
+
+static bool pointInFrustum(const Frustum& f, const glm::vec3& p) {
+    for (const glm::vec4& pl : f.planes)
+        if (glm::dot(glm::vec3(pl), p) + pl.w < 0.0f) return false;
+    return true;
+}
+
+struct CameraPose { glm::vec3 eye, target; };
+
+struct PathResult {
+    double visible = 0, occluded = 0, occluders = 0, tris = 0, rasterUs = 0, testUs = 0;
+    int frames = 0;
+    uint64_t leaks = 0, rays = 0;
+};
+
+int main(int argc, char** argv) {
+    int radius = 4, occRadius = 3, frames = 120, threadsN = 0;
+    uint32_t seed = 1337u;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--radius") && i + 1 < argc) radius = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--occ-radius") && i + 1 < argc) occRadius = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frames = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threadsN = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else {
+            std::fprintf(stderr, "usage: %s [--radius R] [--occ-radius N] [--frames F] [--threads N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    BenchWorld w;
+    w.radius = radius;
+    buildWorld(w, seed);
+
+    AabbSoA boxes;
+    boxes.clear();
+    for (const BenchRegion& r : w.regions) boxes.push(r.mn, r.mx);
+
+    const float extent = radius * CHUNK_SIZE * VOXEL_SCALE;   // polovica sirky sveta (world units)
+    auto ground = [&](float x, float z) {
+        return w.groundY((int)std::lround(x / VOXEL_SCALE), (int)std::lround(z / VOXEL_SCALE)) * VOXEL_SCALE;
+    };
+    struct Path { const char* name; CameraPose(*pose)(float, float, const decltype(ground)&); };
+    // t v [0, 1)
+    const Path paths[] = {
+        { "walk", [](float t, float ext, const decltype(ground)& g) {
+            const float x = -0.6f * ext + 1.2f * ext * t, z = 3.0f;
+            const glm::vec3 eye(x, g(x, z) + 1.7f, z);
+            return CameraPose{ eye, eye + glm::vec3(1.0f, -0.05f, 0.25f * std::sin(t * 6.2831853f)) };
+        } },
+        { "orbit", [](float t, float ext, const decltype(ground)& g) {
+            const float a = t * 6.2831853f, r = 0.45f * ext;
+            const float x = r * std::cos(a), z = r * std::sin(a);
+            const glm::vec3 eye(x, g(x, z) + 6.0f, z);
+            return CameraPose{ eye, glm::vec3(0.0f, g(0.0f, 0.0f), 0.0f) };
+        } },
+        { "high", [](float t, float ext, const decltype(ground)& g) {
+            const float a = t * 6.2831853f;
+            const glm::vec3 eye(0.2f * ext * std::cos(a), g(0.0f, 0.0f) + 80.0f, 0.2f * ext * std::sin(a));
+            return CameraPose{ eye, eye + glm::vec3(std::cos(a), -0.8f, std::sin(a)) };
+        } },
+        { "underground", [](float t, float, const decltype(ground)& g) {
+            const float a = t * 6.2831853f;
+            const glm::vec3 eye(1.0f, g(1.0f, 1.0f) - 20.0f, 1.0f);
+            return CameraPose{ eye, eye + glm::vec3(std::cos(a), 0.1f, std::sin(a)) };
+        } },
+    };
+
+    const int threadCounts[2] = { 1, threadsN };
+    int totalLeaks = 0;
+    std::printf("%-12s %7s %8s %9s %9s %8s %9s %9s %7s %8s\n",
+        "path", "threads", "frustum", "occluded", "occl %", "boxes", "raster us", "test us", "rays", "leaks");
+    for (int tc : threadCounts) {
+        SoftOcclusion occ;
+        occ.start(tc);
+        for (const Path& p : paths) {
+            PathResult res;
+            std::vector<uint8_t> vis(w.regions.size());
+            for (int fi = 0; fi < frames; ++fi) {
+                const CameraPose cp = p.pose(fi / float(frames), extent, ground);
+                glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+                proj[1][1] *= -1.0f;   // Vulkan, ako FPSCamera
+                const glm::mat4 vp = proj * glm::lookAt(cp.eye, cp.target, glm::vec3(0, 1, 0));
+                const Frustum f = frustumFromMatrix(vp);
+
+                occ.begin(vp, cp.eye);
+                const int ccx = (int)std::floor((cp.eye.x / VOXEL_SCALE + 0.5f) / CHUNK_SIZE);
+                const int ccz = (int)std::floor((cp.eye.z / VOXEL_SCALE + 0.5f) / CHUNK_SIZE);
+                for (const BenchChunk& c : w.chunks) {
+                    if (std::abs(c.cx - ccx) > occRadius || std::abs(c.cz - ccz) > occRadius) continue;
+                    for (const OccluderBox& b : c.occluders) occ.addOccluder(b);
+                }
+                occ.rasterize();
+
+                const auto t0 = std::chrono::steady_clock::now();
+                frustumCullAabbs(f, boxes, 0, boxes.size(), vis.data());
+                std::vector<uint32_t> hidden;
+                uint32_t nVis = 0;
+                for (uint32_t i = 0; i < boxes.size(); ++i) {
+                    if (!vis[i]) continue;
+                    ++nVis;
+                    if (occ.occluded(w.regions[i].mn, w.regions[i].mx)) hidden.push_back(i);
+                }
+                res.testUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+                res.visible += nVis;
+                res.occluded += hidden.size();
+                res.occluders += occ.stats().occluders;
+                res.tris += occ.stats().triangles;
+                res.rasterUs += occ.stats().rasterUs;
+                ++res.frames;
+
+                // luce len v jednom behu (vysledok nezavisi od poctu vlakien)
+                if (tc != 1) continue;
+                for (uint32_t i : hidden)
+                    for (const glm::ivec3& v : w.regions[i].samples) {
+                        if (!pointInFrustum(f, glm::vec3(v) * VOXEL_SCALE)) continue;
+                        ++res.rays;
+                        if (rayReaches(w, cp.eye, v)) {
+                            if (res.leaks < 4)
+                                std::printf("  leak: %s frame %d voxel (%d %d %d)\n", p.name, fi, v.x, v.y, v.z);
+                            ++res.leaks;
+                        }
+                    }
+            }
+            const double n = res.frames;
+            std::printf("%-12s %7d %8.0f %9.0f %8.1f%% %8.0f %9.1f %9.1f %7llu %8llu\n",
+                p.name, occ.stats().threads, res.visible / n, res.occluded / n,
+                res.visible > 0 ? 100.0 * res.occluded / res.visible : 0.0,
+                res.occluders / n, res.rasterUs / n, res.testUs / n,
+                (unsigned long long)res.rays, (unsigned long long)res.leaks);
+            totalLeaks += (int)res.leaks;
+        }
+    }
+    if (totalLeaks) {
+        std::printf("[Bench] %d leak(s): occluded region was visible\n", totalLeaks);
+        return 1;
+    }
+    return 0;
+}
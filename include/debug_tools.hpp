@@ -14,12 +14,118 @@ struct DebugStats {
     // frame
     float   fps = 0.0f;
     float   dt = 0.0f;
+    // frames in flight (drawFrameWithMVP), ms smoothed over ~1 s
+    uint32_t framesInFlight = 0;
+    float   cpuFrameMs = 0.0f;      // dt minus waiting for the frame slot / swapchain image
+    float   frameWaitMs = 0.0f;
+    float   frameRecordMs = 0.0f;   // command buffer recording + submit
+    float   fpsAvg = 0.0f;          // throughput
 
     // world
     World* worldRef = nullptr;     // read-only in UI; cast away const if you call io
     uint32_t chunksTotal = 0;
     uint32_t chunksReady = 0;   // have VBO+IBO+indices>0
     uint64_t tris = 0;
+    uint32_t chunksPerLod[MESH_LOD_COUNT] = {};
+    uint32_t drawCalls = 0;     // last frame (World::drawStats)
+    uint64_t drawTris = 0;
+    uint64_t dirSkippedTris = 0; // back-facing direction ranges not drawn
+
+    // async meshing
+    int      meshThreads = 0;
+    uint32_t meshPending = 0;   // queued + running jobs
+    uint64_t meshDone = 0;
+    uint64_t meshStale = 0;     // results dropped because the chunk changed/unloaded
+    float    meshLastMs = 0.0f;
+    float    meshAvgMs = 0.0f;
+    float    meshAllocsPerJob = 0.0f;
+
+    // mesh cache (content hash -> mesh)
+    float    cacheHitRate = 0.0f;   // 0..1
+    uint64_t cacheHits = 0, cacheDiskHits = 0;
+    uint64_t cacheBytes = 0;        // in memory
+    uint64_t cacheDiskBytes = 0;    // written this session
+    uint64_t cacheDiskUsed = 0;     // currently on disk (LRU budget)
+    double   cacheMsSaved = 0.0;    // meshing time skipped by hits
+
+    // GPU uploads (GpuUploader)
+    bool     uploadAsync = false;
+    bool     uploadDedicated = false;  // separate transfer queue family
+    uint64_t uploadBatches = 0;
+    uint64_t uploadBytes = 0;
+    uint32_t uploadInFlight = 0;       // submitted batches not finished yet
+    uint32_t uploadPendingChunks = 0;  // new layouts waiting for their copy
+    uint64_t stagingUsed = 0, stagingCapacity = 0;  // persistent staging ring
+    float    stagingAllocsPerSec = 0.0f;
+    float    stagingMBPerSec = 0.0f;
+    uint64_t stagingFull = 0;          // allocations that did not fit (deferred / streamed)
+    uint64_t stagingStreamed = 0;      // uploads split across several frames
+
+    // device-local chunk memory (GpuHeap)
+    uint32_t gpuBlocks = 0;            // live vkAllocateMemory blocks
+    uint32_t gpuDedicated = 0;
+    uint32_t gpuMaxAllocations = 0;    // device limit
+    uint32_t gpuAllocs = 0;            // sub-allocations
+    uint64_t gpuUsed = 0, gpuReserved = 0;
+    float    gpuFragmentation = 0.0f;
+    uint32_t gpuDraining = 0;          // block being compacted (0 = none, else index + 1)
+
+    // chunk geometry pages (GeometryPool)
+    uint32_t geoPages = 0;
+    uint64_t geoVertexUsed = 0, geoVertexCap = 0;
+    uint64_t geoIndexUsed = 0, geoIndexCap = 0;
+    float    geoFragmentation = 0.0f;
+    uint32_t geoDraining = 0;          // pages being emptied
+    uint64_t geoRelocated = 0;         // chunks moved by compaction
+    uint32_t drawBinds = 0;            // VBO/IBO binds last frame
+    uint32_t drawApiCalls = 0;         // vkCmdDraw* calls (multi-draw indirect batches many draws)
+    bool     drawIndirect = false;     // World::drawIndirect is ready
+    uint32_t drawIndirectOverflow = 0; // draws that did not fit the indirect buffer
+    bool     recordAvailable = false;  // World::recorder is ready
+    uint32_t recordSecondaries = 0;    // secondary command buffers this frame (0 = main thread only)
+    int      recordThreads = 0;
+    float    recordUs = 0.0f;
+    float    drawSortUs = 0.0f;        // front-to-back radix sort (0 = off or GPU path)
+    uint32_t drawPrepassCalls = 0;     // vkCmdDraw* of the depth prepass
+
+    // frustum culling (World::cull)
+    uint32_t cullChunksDrawn = 0, cullChunksCulled = 0;
+    uint32_t cullPartsDrawn = 0, cullPartsCulled = 0;   // regions / rims / LOD ranges
+    float    cullUs = 0.0f;
+    const char* cullIsa = "";
+    bool     occlOn = false;             // World::softOcclusion
+    uint32_t occlChunks = 0, occlParts = 0;   // occluded this frame (part of culled)
+    uint32_t occlBoxes = 0, occlTris = 0;
+    float    occlUs = 0.0f, occlRasterUs = 0.0f;
+    int      occlThreads = 0;
+    bool     caveOn = false;             // World::caveCulling
+    uint32_t caveChunks = 0, caveParts = 0, caveSections = 0;
+    float    caveUs = 0.0f;
+    bool     gpuCullAvailable = false;   // GpuCuller::ready()
+    bool     gpuCullOn = false;
+    uint32_t gpuCullRecords = 0, gpuCullDraws = 0, gpuCullPages = 0;
+    bool     hizAvailable = false;       // HiZPyramid::ready()
+    bool     hizOn = false;              // two-phase occlusion active this frame
+    uint32_t hizTested = 0, hizOccluded = 0, hizLateDraws = 0;
+
+    // upload scheduler (World::uploadQueue)
+    uint32_t uploadQueueDepth = 0;     // ready chunks waiting for budget
+    uint32_t uploadQueueEdits = 0;
+    uint32_t uploadFrameChunks = 0;
+    uint64_t uploadFrameBytes = 0;
+    float    uploadFrameMs = 0.0f;
+    float    uploadWaitAvgMs = 0.0f, uploadWaitMaxMs = 0.0f;   // ready -> sent
+
+    // deferred GPU frees (DeletionQueue)
+    uint64_t gpuLive = 0;              // geometry bytes still referenced by chunks
+    uint32_t deletePending = 0;        // ranges waiting for in-flight frames / uploads
+    uint64_t deletePendingBytes = 0;
+    uint64_t deleteRetired = 0;
+
+    // edit -> visible (remesh dirty parts + upload)
+    float    editLastMs = 0.0f, editAvgMs = 0.0f, editMaxMs = 0.0f;
+    uint32_t editParts = 0;     // parts re-uploaded by the last edit
+    uint64_t editBytes = 0;
 
     // camera
     glm::vec3 camPos{ 0 };
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include "vk_utils.hpp"
+#include "gpu_upload.hpp"
+
+struct DeletionStats {
+    uint32_t pending = 0;         // cakaju na GPU
+    uint64_t pendingBytes = 0;
+    uint64_t retired = 0;         // uz uvolnene (spolu)
+    uint64_t retiredBytes = 0;
+};
+
+// GPU zdroje (buffery, rozsahy v GeometryPool / GpuHeap), ktore este mozu citat rozbehnute
+// framy alebo do nich pisat upload batche. push() ich len zaradi; collect() ich uvolni, ked
+// frameTimeline (bez timeline: fence z drawFrameWithMVP) presiel vsetky framy odoslane pred
+// push a GpuUploader dokoncil vsetky batche s kopiami do nich. Nikdy sa neceka na device.
+//
+// push nepotrebuje ctx (World::destroyChunk ho nema): polozka dostane frame a ticket az
+// v najblizsom collect - neskor nez treba, takze bezpecne.
+class DeletionQueue {
+public:
+    using Fn = std::function<void(VulkanContext&)>;
+
+    void push(uint64_t bytes, Fn fn);
+    // raz za frame, pred novymi alokaciami (uvolnene miesto sa hned pouzije)
+    void collect(VulkanContext& ctx, const GpuUploader& up);
+    // shutdown po vkDeviceWaitIdle: uvolni vsetko hned
+    void flush(VulkanContext& ctx);
+
+    const DeletionStats& stats() const { return st; }
+
+private:
+    struct Entry {
+        uint64_t frame = 0;      // frameSerial v case zaradenia
+        uint64_t ticket = 0;     // posledny upload ticket v case zaradenia
+        bool     stamped = false;
+        uint64_t bytes = 0;
+        Fn       fn;
+    };
+    void retire(VulkanContext& ctx, Entry& e);
+
+    std::deque<Entry> entries;   // stamped na zaciatku, v poradi
+    DeletionStats st;
+};
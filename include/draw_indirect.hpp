@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include "vk_utils.hpp"
+
+struct IndirectDrawStats {
+    uint32_t commands = 0;    // prikazy v poslednom frame
+    uint32_t capacity = 0;
+    uint32_t overflow = 0;    // prikazy, ktore sa nezmestili (isli priamo)
+    uint64_t grows = 0;
+};
+
+// Multi-draw indirect z CPU: draw zapisuje VkDrawIndexedIndirectCommand do trvalo
+// namapovaneho host-visible bufferu a flush ich vykona jednym vkCmdDrawIndexedIndirect
+// (typicky raz na stranku GeometryPool). Vertexy su vo world space, takze prikazy sa lisia
+// len firstIndex / vertexOffset - origin chunku netreba (gl_DrawID ani instance data).
+//
+// Kazdy slot framu v lete ma svoj buffer; begin vezme buffer slotu ctx.currentFrame, ktoreho
+// fence uz presla, takze GPU z neho necita. Ked sa frame nezmesti, zvysok ide priamo a begin
+// buffer slotu zvacsi (ostatne sloty az ked na ne pride rad).
+
+// Cast bufferu slotu s vlastnym poctom a flush: jedno vlakno pri paralelnom nahravani
+// (IndirectDrawBuffer::reserve), alebo zvysok bufferu pre hlavne vlakno.
+struct IndirectDrawRange {
+    VkBuffer buf = VK_NULL_HANDLE;
+    VkDrawIndexedIndirectCommand* cmds = nullptr;   // prvy prikaz rozsahu
+    uint32_t base = 0;           // index prveho prikazu v bufferi
+    uint32_t cap = 0;
+    uint32_t count = 0;          // zapisane
+    uint32_t flushed = 0;        // [0, flushed) uz su v command bufferi
+    uint32_t demand = 0;         // kolko prikazov chcel (aj nad cap)
+    uint32_t maxDrawCount = 1;
+
+    // false => plny / prazdny rozsah, volajuci kresli priamo (po flush)
+    bool push(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset);
+    // prikazy od posledneho flush (VBO/IBO uz su bindnute); vrati pocet vkCmd* volani
+    uint32_t flush(VkCommandBuffer cb);
+};
+
+class IndirectDrawBuffer {
+public:
+    // false => bez multiDrawIndirect (draw ide priamo cez vkCmdDrawIndexed)
+    bool init(VulkanContext& ctx, uint32_t capacity);
+    void shutdown(VulkanContext& ctx);
+    bool ready() const { return cur->cmds != nullptr; }
+
+    // zaciatok nahravania framu: buffer slotu od zaciatku (pripadne vacsi)
+    void begin(VulkanContext& ctx);
+    // n prikazov zo zaciatku zvysku pre jedno vlakno; len pred prvym push framu.
+    // Nezmesti sa => prazdny rozsah (vlakno kresli priamo) a begin buffer zvacsi.
+    IndirectDrawRange reserve(uint32_t n);
+    // zvysok bufferu za rezervovanymi rozsahmi (hlavne vlakno)
+    IndirectDrawRange& commands() { return rest; }
+    bool push(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset) {
+        return rest.push(indexCount, firstIndex, vertexOffset);
+    }
+    uint32_t flush(VkCommandBuffer cb) { return rest.flush(cb); }
+
+    const IndirectDrawStats& stats() const { return st; }
+
+private:
+    struct Slot {
+        VkBuffer       buf = VK_NULL_HANDLE;
+        VkDeviceMemory mem = VK_NULL_HANDLE;
+        VkDrawIndexedIndirectCommand* cmds = nullptr;
+        uint32_t cap = 0;
+    };
+    bool create(VulkanContext& ctx, Slot& s, uint32_t capacity);
+    void destroy(VulkanContext& ctx, Slot& s);
+
+    Slot  slots[MAX_FRAMES_IN_FLIGHT];
+    Slot* cur = &slots[0];       // slot z posledneho begin
+    IndirectDrawRange rest;      // za rezervovanymi rozsahmi
+    uint32_t reserved = 0;       // prikazy v rezervovanych rozsahoch tento frame
+    uint32_t reservedDemand = 0; // aj tie, ktore sa nezmestili
+    uint32_t maxDrawCount = 1;   // VkPhysicalDeviceLimits::maxDrawIndirectCount
+    IndirectDrawStats st;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 6 rovin (nx, ny, nz, d): bod p je vnutri, ked n.p + d >= 0 pre vsetky
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+// Gribb/Hartmann z view-projection (FPSCamera::mvp). Near rovina je z >= -w, co plati
+// pre GL aj Vulkan hlbku (pre [0,1] je o kusok volnejsia => konzervativne).
+Frustum frustumFromMatrix(const glm::mat4& viewProj);
+
+// AABB v SoA (kazda os zvlast), aby SIMD testovalo AABB_LANES boxov jednou instrukciou.
+// Polia su o AABB_LANES dlhsie nez size() (prazdne boxy), takze sa posledna skupina
+// da nacitat cela aj z ktorehokolvek ofsetu.
+static constexpr uint32_t AABB_LANES = 8;
+
+struct AabbSoA {
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+    void clear();
+    uint32_t push(const float mn[3], const float mx[3]);   // vrati index
+    uint32_t size() const { return count; }
+
+private:
+    uint32_t count = 0;
+};
+
+// vis[i] = 1, ked boxy[first + i] mozu byt vo frustum (test p-vrcholu: box je vonku, ked
+// jeho najvzdialenejsi roh v smere normaly lezi za niektorou rovinou). Vrati pocet viditelnych.
+uint32_t frustumCullAabbs(const Frustum& f, const AabbSoA& boxes, uint32_t first, uint32_t count, uint8_t* vis);
+
+// "AVX" / "SSE2" / "scalar" - cim bol frustumCullAabbs skompilovany
+const char* frustumCullIsa();
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "gpu_heap.hpp"
+
+// Rozsah jedneho chunku v GeometryPool (v prvkoch od zaciatku stranky)
+struct GeoAlloc {
+    uint32_t page = TlsfAllocator::NONE;
+    uint32_t vertexNode = TlsfAllocator::NONE, indexNode = TlsfAllocator::NONE;
+    uint32_t firstVertex = 0, vertexCount = 0;
+    uint32_t firstIndex = 0, indexCount = 0;
+    explicit operator bool() const { return page != TlsfAllocator::NONE; }
+};
+
+struct GeometryPoolStats {
+    uint32_t pages = 0;
+    uint32_t ranges = 0;              // zive GeoAlloc
+    uint64_t vertexUsed = 0, vertexCap = 0;   // bajty
+    uint64_t indexUsed = 0, indexCap = 0;
+    float    fragmentation = 0.f;     // vertex strana: 1 - largestFree / free
+    uint32_t draining = 0;            // stranky, ktore sa vyprazdnuju
+    uint64_t relocated = 0;           // chunky presunute kvoli compaction
+};
+
+// Geometria vsetkych chunkov v par velkych strankach: jeden vertex + jeden index buffer
+// na stranku, rozsahy v nich pridava TLSF. Frame binduje raz na stranku a drawy sa lisia
+// len firstIndex / vertexOffset (zaklad pre indirect draw).
+//
+// Rast: ked sa rozsah nezmesti do ziadnej stranky, prida sa nova (existujuce sa nekopiruju,
+// kreslit sa z nich da dalej). Chunk vacsi nez stranka dostane vlastnu stranku na mieru.
+// Fragmentacia: susedne volne rozsahy TLSF hned spaja; riedka stranka (alebo stranka v bloku,
+// ktory vyprazdnuje GpuHeap) sa oznaci ako draining a World jej chunky preklada inam.
+class GeometryPool {
+public:
+    // pageBytes = vertex buffer stranky; index buffer ma 6 indexov na 4 vertexy (quady)
+    void init(GpuHeap& heap, VkDeviceSize pageBytes, uint32_t vertexStride);
+    void shutdown(VulkanContext& ctx);
+
+    bool alloc(VulkanContext& ctx, uint32_t vertices, uint32_t indices, GeoAlloc& out);
+    void free(VulkanContext& ctx, GeoAlloc& a);
+
+    uint32_t pageCount() const { return (uint32_t)pages.size(); }   // vratane prazdnych miest
+    VkBuffer vertexBuffer(uint32_t page) const { return pages[page].vbo; }
+    VkBuffer indexBuffer(uint32_t page) const { return pages[page].ibo; }
+
+    // raz za frame (vola aj GpuHeap::updateCompaction)
+    void updateCompaction();
+    // a lezi v stranke, ktora sa vyprazdnuje => chunk treba prelozit inam
+    bool shouldRelocate(const GeoAlloc& a) const { return a && pages[a.page].draining; }
+    void noteRelocated() { ++relocatedCount; }
+
+    GeometryPoolStats stats() const;
+
+private:
+    struct Page {
+        VkBuffer vbo = VK_NULL_HANDLE, ibo = VK_NULL_HANDLE;   // NULL => volne miesto vo vektore
+        GpuAlloc vmem, imem;
+        TlsfAllocator vertices, indices;   // v prvkoch
+        bool draining = false;
+    };
+    bool newPage(VulkanContext& ctx, uint32_t vertexCap, uint32_t indexCap, uint32_t& out);
+    void releasePage(VulkanContext& ctx, uint32_t p);
+    bool allocIn(uint32_t p, uint32_t vertices, uint32_t indices, GeoAlloc& out);
+
+    GpuHeap* heap = nullptr;
+    std::vector<Page> pages;
+    uint32_t stride = 0;
+    uint32_t pageVertices = 0, pageIndices = 0;
+    uint64_t relocatedCount = 0;
+    bool compactBlocked = false;
+};
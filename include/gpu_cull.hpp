@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <glm/glm.hpp>
+#include "vk_utils.hpp"
+#include "frustum.hpp"
+
+// Jedna opaque cast chunku pre shaders/cull.comp (std430, 64 B). page je index stranky
+// v poradi World::cullPages, outBase prvy prikaz jej oblasti v draw bufferi.
+struct GpuCullRecord {
+    float    aabbMin[3];
+    uint32_t page;
+    float    aabbMax[3];
+    uint32_t firstIndex;
+    int32_t  vertexOffset;
+    uint32_t dirCount[6];
+    uint32_t outBase;
+};
+static_assert(sizeof(GpuCullRecord) == 64, "std430 layout Record v cull.comp");
+
+// z jednej casti su najviac 3 suvisle rozsahy viditelnych smerov (ako drawChunkOpaque)
+static constexpr uint32_t GPU_CULL_DRAWS_PER_RECORD = 3;
+
+// All: len frustum. Early/Late: dvojfazovy Hi-Z - early kresli casti viditelne v minulom
+// frame, late testuje ostatne proti Hi-Z z hlbky early priechodu a kresli nove viditelne.
+enum class GpuCullPhase : uint32_t { All = 0, Early = 1, Late = 2 };
+
+struct GpuCullStats {
+    uint32_t records = 0;     // casti v poslednom dispatchi
+    uint32_t draws = 0;       // prikazy, ktore GPU zapisala (z minuleho framu, early + late)
+    uint32_t lateDraws = 0;   // z toho v late priechode (nove viditelne)
+    uint32_t tested = 0;      // casti vo frustum testovane proti Hi-Z
+    uint32_t occluded = 0;    // z nich zakryte
+    uint32_t pages = 0;
+    uint64_t uploads = 0;     // kolkokrat sa prepisali zaznamy (zmena chunkov)
+};
+
+// GPU-driven culling: compute shader otestuje boxy casti a zapise
+// VkDrawIndexedIndirectCommand + pocet na stranku GeometryPool; draw potom kresli
+// jednym vkCmdDrawIndexedIndirectCount na stranku, bez CPU prechodu cez casti.
+//
+// Zaznamy, pohlad (UBO) a pocty su v host-visible bufferoch (trvalo namapovane) - po fence
+// sa z poctov cita, kolko drawov GPU vyrobila. Maju ich sloty framov v lete (ctx.currentFrame)
+// spolu s prikazmi a descriptor setom: prepare zapisuje len do slotu, ktoreho fence presla.
+// Spolocny je len vis (viditelnost z minuleho framu), ten pise a cita iba GPU v poradi submitov.
+class GpuCuller {
+public:
+    // false => chyba feature (drawIndirectCount, multiDrawIndirect, compute na graphics
+    // queue) alebo cull.comp.spv; World potom kresli CPU cestou
+    bool init(VulkanContext& ctx, const std::string& shaderDir);
+    void shutdown(VulkanContext& ctx);
+    bool ready() const { return pipeline != VK_NULL_HANDLE; }
+
+    // po fence slotu ctx.currentFrame, pred dispatch: zaznamy (ak changed alebo ich slot este
+    // nema - recs musia ostat platne) a velkosti bufferov; precita pocty minuleho pouzitia slotu
+    bool prepare(VulkanContext& ctx, const GpuCullRecord* recs, uint32_t recCount, uint32_t pageCount,
+        bool changed);
+    // pohlad tohto framu (plati pre vsetky fazy)
+    void setView(const Frustum& f, const glm::mat4& viewProj, const glm::vec3& camPos);
+    // Hi-Z pre late fazu (HiZPyramid); volat po kazdej zmene jej obrazku a pred prepare (descriptor
+    // slotu sa prepise az v jeho prepare, ked ho GPU necita)
+    void setHiZ(VkImageView view, uint32_t levels, uint32_t depthWidth, uint32_t depthHeight);
+    // mimo render passu: (All/Early) vynuluj pocty, dispatch, bariera pre DRAW_INDIRECT
+    void record(VkCommandBuffer cb, GpuCullPhase phase);
+    // v render passe: prikazy stranky page z fazy (Late = druha sada), VBO/IBO uz su bindnute
+    void drawPage(VkCommandBuffer cb, GpuCullPhase phase, uint32_t page, uint32_t outBase, uint32_t maxDraws) const;
+
+    const GpuCullStats& stats() const { return st; }
+
+private:
+    // slot framu v lete
+    struct Frame {
+        VkDescriptorSet descSet = VK_NULL_HANDLE;
+        VkBuffer       recBuf = VK_NULL_HANDLE, drawBuf = VK_NULL_HANDLE, countBuf = VK_NULL_HANDLE;
+        VkBuffer       viewBuf = VK_NULL_HANDLE;
+        VkDeviceMemory recMem = VK_NULL_HANDLE, drawMem = VK_NULL_HANDLE, countMem = VK_NULL_HANDLE;
+        VkDeviceMemory viewMem = VK_NULL_HANDLE;
+        GpuCullRecord* recPtr = nullptr;     // trvalo namapovane
+        uint32_t*      countPtr = nullptr;
+        void*          viewPtr = nullptr;
+        uint64_t       recVersion = 0;       // verzia zaznamov v recBuf (0 = ziadne)
+        uint64_t       hizBound = 0;         // hizSerial, ktory je v descriptore (binding 4)
+        uint32_t       countPages = 0;       // stranky dispatchu, ktoreho pocty su v countBuf
+        bool           countsValid = false;  // countBuf obsahuje vysledok odoslaneho dispatchu
+        bool           late = false;         // ten frame mal aj late fazu
+    };
+
+    bool grow(VulkanContext& ctx, uint32_t recCap, uint32_t pageCap);
+    void destroyBuffers(VulkanContext& ctx);
+    bool createPlaceholder(VulkanContext& ctx);
+    void writeHiZDescriptor(VulkanContext& ctx, Frame& f);
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descPool = VK_NULL_HANDLE;
+    VkPipelineLayout      layout = VK_NULL_HANDLE;
+    VkPipeline            pipeline = VK_NULL_HANDLE;
+
+    Frame    frames[MAX_FRAMES_IN_FLIGHT];
+    Frame*   cur = &frames[0];           // slot z posledneho prepare
+    VkBuffer       visBuf = VK_NULL_HANDLE;
+    VkDeviceMemory visMem = VK_NULL_HANDLE;
+    uint64_t recVersion = 1;             // ++ pri kazdej zmene zaznamov
+    uint32_t recCap = 0, pageCap = 0;
+    uint32_t recCount = 0, pageCount = 0;
+    bool     visReset = true;            // zaznamy sa zmenili => vis od znova (vsetko early)
+
+    // Hi-Z (binding 4): kym ho HiZPyramid neda, 1x1 zastupca (late faza sa vtedy nevola)
+    VkImage        placeholder = VK_NULL_HANDLE;
+    VkDeviceMemory placeholderMem = VK_NULL_HANDLE;
+    VkImageView    placeholderView = VK_NULL_HANDLE;
+    VkSampler      sampler = VK_NULL_HANDLE;   // nearest; cull.comp cita len texelFetch
+    VkImageView    hizView = VK_NULL_HANDLE;
+    uint32_t       hizLevels = 0, depthW = 0, depthH = 0;
+    uint64_t       hizSerial = 0;   // ++ v kazdom setHiZ; handle noveho view moze byt rovnaky ako stary
+
+    GpuCullStats st;
+};
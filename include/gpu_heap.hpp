@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "vk_utils.hpp"
+
+// TLSF (two-level segregated fit) nad rozsahom [0, capacity): alloc/free v O(1),
+// susedne volne kusy sa hned spajaju. Nevie nic o Vulkane - ofsety su len cisla,
+// takze sa da pouzit na pamat aj na rozsahy vnutri jedneho velkeho buffera.
+class TlsfAllocator {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    TlsfAllocator() { init(0); }
+    void init(uint64_t capacity);
+    // vrati id kusu (pre free) alebo NONE; offset je zarovnany na align (mocnina 2)
+    uint32_t alloc(uint64_t size, uint64_t align, uint64_t& offset);
+    void free(uint32_t node);
+
+    uint64_t capacity() const { return cap; }
+    uint64_t used() const { return usedBytes; }
+    uint32_t allocations() const { return liveAllocs; }
+    uint64_t largestFree() const;
+    uint32_t freeRanges() const { return freeCount; }
+    bool empty() const { return liveAllocs == 0; }
+
+private:
+    static constexpr int SL_BITS = 4;                 // 16 pod-tried na kazdu mocninu 2
+    static constexpr int SL_COUNT = 1 << SL_BITS;
+    static constexpr int FL_COUNT = 64 - SL_BITS + 1;
+
+    struct Node {
+        uint64_t offset = 0, size = 0;
+        uint32_t prevPhys = NONE, nextPhys = NONE;   // susedia v adresnom priestore
+        uint32_t prevFree = NONE, nextFree = NONE;   // zoznam v triede
+        bool free = false;
+    };
+
+    static void mapping(uint64_t size, int& fl, int& sl);
+    uint32_t newNode();
+    void insertFree(uint32_t n);
+    void removeFree(uint32_t n);
+    uint32_t findFree(uint64_t size) const;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> unusedNodes;
+    uint32_t heads[FL_COUNT][SL_COUNT];
+    uint64_t flBits = 0;
+    uint32_t slBits[FL_COUNT] = {};
+    uint64_t cap = 0, usedBytes = 0;
+    uint32_t liveAllocs = 0, freeCount = 0;
+};
+
+// Pod-alokacia z GpuHeap: kus VkDeviceMemory bloku
+struct GpuAlloc {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0, size = 0;
+    uint32_t block = TlsfAllocator::NONE;
+    uint32_t node = TlsfAllocator::NONE;
+    explicit operator bool() const { return memory != VK_NULL_HANDLE; }
+};
+
+struct GpuHeapStats {
+    uint32_t blocks = 0;          // zive vkAllocateMemory (vratane dedicated)
+    uint32_t dedicated = 0;       // bloky pre jednu velku alokaciu
+    uint32_t allocations = 0;     // zive pod-alokacie
+    uint64_t reserved = 0;        // sucet velkosti blokov
+    uint64_t used = 0;
+    uint64_t largestFree = 0;     // najvacsi volny kus cez vsetky bloky
+    float    fragmentation = 0.f; // 1 - largestFree / free (0 = vsetko volne je jeden kus)
+    uint32_t draining = 0;        // blok, ktory sa vyprazdnuje (0 = ziadny, inak index + 1)
+    uint32_t maxAllocations = 0;  // VkPhysicalDeviceLimits::maxMemoryAllocationCount
+};
+
+// Device-local pamat pre buffery: velke bloky (blockBytes) z vkAllocateMemory,
+// v kazdom TLSF. Buffer dostane vlastny VkBuffer naviazany na ofset v bloku, takze
+// pocet vkAllocateMemory rastie s objemom dat, nie s poctom bufferov.
+//
+// Compaction: ked by sa volne miesto zmestilo do menej blokov, najprazdnejsi blok sa oznaci
+// ako draining - nove alokacie sa mu vyhybaju a vlastnici jeho bufferov (GeometryPool) ich
+// postupne nahradia inymi. Prazdny blok sa uvolni.
+class GpuHeap {
+public:
+    void init(VulkanContext& ctx, VkDeviceSize blockBytes);
+    void shutdown(VulkanContext& ctx);
+
+    bool alloc(VulkanContext& ctx, const VkMemoryRequirements& req, VkMemoryPropertyFlags props, GpuAlloc& out);
+    void free(VulkanContext& ctx, GpuAlloc& a);
+
+    // ako ::createBuffer, ale pamat je pod-alokacia
+    bool createBuffer(VulkanContext& ctx, VkDeviceSize size, VkBufferUsageFlags usage,
+        VkBuffer& buf, GpuAlloc& a, bool sharedWithTransfer = false);
+    void destroyBuffer(VulkanContext& ctx, VkBuffer& buf, GpuAlloc& a);
+
+    // raz za frame: ak sa oplati, vyber blok na vyprazdnenie (drzi sa, kym sa nevyprazdni)
+    void updateCompaction();
+    // a lezi v bloku, ktory sa vyprazdnuje => vlastnika treba prelozit inam
+    bool shouldRelocate(const GpuAlloc& a) const {
+        return a && drainBlock != TlsfAllocator::NONE && a.block == drainBlock;
+    }
+
+    GpuHeapStats stats() const;
+
+private:
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint32_t memoryType = 0;
+        bool dedicated = false;
+        TlsfAllocator tlsf;
+    };
+    bool newBlock(VulkanContext& ctx, uint32_t memoryType, VkDeviceSize size, bool dedicated, uint32_t& out);
+    void releaseBlock(VulkanContext& ctx, uint32_t b);
+
+    std::vector<Block> blocks;         // memory == NULL => volne miesto vo vektore
+    VkDeviceSize blockSize = 0;
+    uint32_t liveBlocks = 0;
+    uint32_t maxAllocs = 0;
+    uint32_t drainBlock = TlsfAllocator::NONE;
+    bool compactBlocked = false;
+};
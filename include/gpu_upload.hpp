@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "vk_utils.hpp"
+
+// Asynchronne kopie staging -> device-local buffery.
+// Vsetky kopie medzi dvoma flush() idu do jedneho command buffera a jedneho submitu (batch)
+// na ctx.transferQueue. Batch ma ticket = hodnota, ktoru po dokonceni signalizuje
+// ctx.uploadTimeline; CPU sa len pyta (poll), na queue sa nikdy neceka.
+//
+// Dva druhy kopii:
+//  copy()        - do bufferov, ktore este ziadny frame nekreslil (novy layout chunku);
+//                  chunk sa prepne na nove buffery az ked done(ticket)
+//  copyInPlace() - prepis bufferov, ktore kreslia skorsie framy: batch pocka na frame timeline
+//                  (starsie framy docitaju) a dalsi frame pocka na batch (ctx.uploadWaitValue)
+//
+// Bez timeline semaforov (stary driver) sa batch posle na graphics queue a pocka sa na idle
+// ako predtym; ticket je potom hotovy hned po flush().
+//
+// Staging je jeden perzistentne namapovany ring (host-visible, coherent). Kazdy batch si
+// pamata, pokial v ringu pisal; ked jeho ticket dobehne, tail sa posunie za neho.
+struct UploadStats {
+    uint64_t batches = 0;
+    uint64_t copies = 0;       // VkBufferCopy regiony
+    uint64_t bytes = 0;
+    uint32_t inFlight = 0;     // odoslane, este nedokoncene batche
+    bool     dedicatedQueue = false;
+    bool     async = false;
+
+    // staging ring
+    uint64_t ringCapacity = 0;
+    uint64_t ringUsed = 0;     // vratane odpadu na konci pri zabaleni
+    uint64_t stagingAllocs = 0;
+    uint64_t ringFull = 0;     // alokacie, ktore sa nezmestili (odlozene / po kuskoch)
+    uint64_t streamed = 0;     // viacframeove uploady (vacsie nez volne miesto)
+    float    allocsPerSec = 0.0f;
+    float    mbPerSec = 0.0f;
+};
+
+// Upload vacsi nez volne miesto v ringu: data sa odlozia bokom a GpuUploader::pump ich
+// posiela po kuskoch v dalsich batchoch (framoch).
+struct UploadStream {
+    struct Range { VkBuffer dst; VkDeviceSize src, dstOffset, size; };
+    std::vector<char>  data;
+    std::vector<Range> ranges;
+    size_t       range = 0;     // kurzor
+    VkDeviceSize offset = 0;    // uz poslane z ranges[range]
+    bool finished() const { return range >= ranges.size(); }
+};
+
+class GpuUploader {
+public:
+    bool init(VulkanContext& ctx, VkDeviceSize ringBytes);
+    void shutdown(VulkanContext& ctx);   // pocka na rozbehnute batche
+
+    // miesto v staging ringu platne do dokoncenia aktualneho batchu;
+    // nullptr = teraz sa nezmesti (skus v dalsom frame alebo po kuskoch cez pump)
+    char* allocStaging(VulkanContext& ctx, VkDeviceSize bytes, VkBuffer& buf, VkDeviceSize& offset);
+    VkDeviceSize ringCapacity() const { return ringSize; }
+    // posle z s, co sa zmesti do ringu; true = vsetko je nahrate (posledny kus ide s ticket())
+    bool pump(VulkanContext& ctx, UploadStream& s);
+
+    void copy(VulkanContext& ctx, VkBuffer src, VkBuffer dst, const VkBufferCopy* regions, uint32_t count);
+    void copyInPlace(VulkanContext& ctx, VkBuffer src, VkBuffer dst, const VkBufferCopy* regions, uint32_t count);
+
+    // ticket batchu, do ktoreho idu dalsie kopie
+    uint64_t ticket() const { return nextTicket; }
+    // po dokonceni tohto ticketu su hotove vsetky doteraz zaznamenane kopie (0 = ziadne)
+    uint64_t lastTicket() const { return cur.cmd ? nextTicket : nextTicket - 1; }
+    // odosli nahrate kopie (nic => nic); vrati ticket odoslaneho batchu alebo 0
+    uint64_t flush(VulkanContext& ctx);
+    // zisti dokoncene batche, uvolni ich staging; vrati najvyssi dokonceny ticket
+    uint64_t poll(VulkanContext& ctx);
+    bool done(uint64_t t) const { return t <= completed; }
+
+    const UploadStats& stats() const { return st; }
+
+private:
+    struct Batch {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        uint64_t ticket = 0;
+        bool inPlace = false;
+        VkDeviceSize ringEnd = 0;     // head ringu po poslednej alokacii batchu
+        VkDeviceSize ringBytes = 0;   // kolko ringu batch drzi (vratane odpadu)
+    };
+    Batch& recording(VulkanContext& ctx);
+    void   release(Batch& b);
+    bool   ringAlloc(VkDeviceSize bytes, VkDeviceSize& offset);
+    VkDeviceSize ringLargestFree() const;
+    void   updateRates();
+
+    VkBuffer ring = VK_NULL_HANDLE;
+    VkDeviceMemory ringMem = VK_NULL_HANDLE;
+    char* ringPtr = nullptr;
+    VkDeviceSize ringSize = 0, ringHead = 0, ringTail = 0, ringUsed = 0;
+
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    bool async = false;
+
+    Batch cur;                       // nahrava sa (cmd == NULL => este nezacal)
+    std::deque<Batch> inFlight;      // odoslane, podla ticketu
+    std::vector<VkCommandBuffer> freeCmds;
+    uint64_t nextTicket = 1;
+    uint64_t completed = 0;
+    UploadStats st;
+    // okno pre allocsPerSec / mbPerSec
+    std::chrono::steady_clock::time_point rateT0{};
+    uint64_t rateAllocs0 = 0, rateBytes0 = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "vk_utils.hpp"
+
+// Hierarchicka hlbka (Hi-Z) pre occlusion culling v cull.comp: R32F pyramida,
+// uroven 0 = max hlbka 2x2 pixelov depth bufferu, kazda dalsia polovica predoslej (nahor).
+// Stavia sa v tom istom command bufferi hned po opaque priechode (depth musi byt STORE
+// a SAMPLED, pozri ctx.depthSampled) a drzi layout GENERAL.
+class HiZPyramid {
+public:
+    // false => depth sa neda samplovat alebo chyba hiz.comp.spv; occlusion culling je vtedy vypnuty
+    bool init(VulkanContext& ctx, const std::string& shaderDir);
+    void shutdown(VulkanContext& ctx);
+    bool ready() const { return pipeline != VK_NULL_HANDLE && image != VK_NULL_HANDLE; }
+    // po zmene swapchainu (novy depth buffer): obrazky podla noveho rozlisenia
+    bool resize(VulkanContext& ctx);
+
+    // mimo render passu, po opaque priechode: depth -> pyramida, depth sa vrati do attachment layoutu
+    void build(VkCommandBuffer cb, const VulkanContext& ctx);
+
+    VkImageView view() const { return fullView; }
+    uint32_t levels() const { return (uint32_t)levelViews.size(); }
+    uint32_t depthWidth() const { return srcW; }
+    uint32_t depthHeight() const { return srcH; }
+    uint64_t generation() const { return gen; }   // rastie pri kazdom novom obrazku (descriptor v GpuCuller)
+
+private:
+    void destroyImage(VulkanContext& ctx);
+
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descPool = VK_NULL_HANDLE;
+    VkPipelineLayout      layout = VK_NULL_HANDLE;
+    VkPipeline            pipeline = VK_NULL_HANDLE;
+    VkSampler             sampler = VK_NULL_HANDLE;
+
+    VkImage        image = VK_NULL_HANDLE;
+    VkDeviceMemory mem = VK_NULL_HANDLE;
+    VkImageView    fullView = VK_NULL_HANDLE;
+    std::vector<VkImageView>     levelViews;
+    std::vector<VkDescriptorSet> levelSets;   // uroven i: src = i-1 (0: depth), dst = i
+    std::vector<VkExtent2D>      levelSize;
+    uint32_t srcW = 0, srcH = 0;
+    uint64_t gen = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "world/chunk.hpp"
+
+// Occluder: box, ktory je cely plny (opaque voxely), world-space
+struct OccluderBox {
+    float mn[3], mx[3];
+};
+
+// Boxy z vysky terenu: chunk sa rozdeli na stlpce OCCLUDER_TILE x OCCLUDER_TILE voxelov,
+// kazdy dostane box od najnizsieho povrchu svojich stlpcov dolu, kym su vsetky stlpce
+// plne opaque (jaskyna/previs => koniec, najviac 128 voxelov). Prazdne stlpce sa vynechaju.
+// topY = chunkTopY(c) (WorldChunk::topY), nech sa cely chunk neprechadza znova.
+static constexpr int OCCLUDER_TILE = 16;
+void chunkOccluders(const Chunk& c, int topY, int cx, int cy, int cz, std::vector<OccluderBox>& out);
+
+// rozlisenie hrubej hlbky softveroveho rasterizera
+static constexpr int SOFT_OCC_W = 256, SOFT_OCC_H = 128;
+
+struct SoftOcclusionStats {
+    uint32_t occluders = 0;    // boxy pridane v poslednom frame
+    uint32_t triangles = 0;    // po orezani na near
+    uint32_t tested = 0, occluded = 0;
+    float    rasterUs = 0.0f;  // rasterize()
+    int      threads = 1;      // vratane volajuceho vlakna
+};
+
+// CPU occlusion culling bez GPU: occludery (predne steny boxov) sa vykreslia do hlbky
+// 256x128 po pasoch na viacerych vlaknach, potom sa boxy chunkov/casti testuju proti nej.
+//
+// Konzervativne: pixel drzi najvzdialenejsiu hlbku trojuholnika v celom pixeli a obdlznik
+// testovaneho boxu sa rozsiri o 1 pixel, takze ho nezakryje pixel, ktory occluder pokryva
+// len ciastocne (pokrytie sa vzorkuje v strede pixelu).
+//
+// Postup za frame: begin -> addOccluder... -> rasterize -> occluded(...)
+class SoftOcclusion {
+public:
+    SoftOcclusion() = default;
+    ~SoftOcclusion();
+    SoftOcclusion(const SoftOcclusion&) = delete;
+    SoftOcclusion& operator=(const SoftOcclusion&) = delete;
+
+    // threads <= 0 => min(4, hardware_concurrency - 1); 1 => bez pomocnych vlakien.
+    // Vola sa aj lenivo z rasterize().
+    void start(int threads = 0);
+    void stop();
+
+    void begin(const glm::mat4& viewProj, const glm::vec3& camPos);
+    void addOccluder(const OccluderBox& b);
+    void rasterize();
+    // true => box je cely za occludermi (po rasterize)
+    bool occluded(const float mn[3], const float mx[3]);
+
+    const float* depth() const { return depthBuf.data(); }   // 1/w, SOFT_OCC_W * SOFT_OCC_H, riadok po riadku
+    const SoftOcclusionStats& stats() const { return st; }
+
+private:
+    struct Tri {
+        float e[3][3];    // hranove funkcie a*x + b*y + c >= 0 vnutri
+        float iw[3];      // 1/w ako rovina v obrazovke
+        int x0, y0, x1, y1;
+    };
+    void addPolygon(const glm::vec4* clip, int n);
+    void rasterBand(int band);
+    void runBands();
+    void workerMain();
+
+    glm::mat4 viewProj{ 1.0f };
+    glm::vec3 cam{ 0.0f };
+    std::vector<Tri>   tris;
+    std::vector<float> depthBuf;    // 1/w najblizsieho occludera (0 = nic), bez delenia v rastri
+    std::vector<float> blockMin;    // min 1/w (najvzdialenejsi) po blokoch 8x8 (rychly test)
+    SoftOcclusionStats st;
+
+    std::vector<std::thread> threads;
+    std::mutex mtx;
+    std::condition_variable cvWork, cvDone;
+    uint64_t jobGen = 0;
+    int bandsDone = 0;
+    std::atomic<int> nextBand{ 0 };
+    bool quit = false;
+    bool started = false;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ParallelRecordStats {
+    uint32_t jobs = 0;         // secondary command buffery v poslednom record()
+    int      threads = 1;      // vratane volajuceho vlakna
+    float    us = 0.0f;        // record() od resetu poolov po posledny vkEndCommandBuffer
+};
+
+// Paralelne nahravanie secondary command bufferov do jedneho render passu. Kazde vlakno ma
+// vlastny VkCommandPool na kazdy slot (frame v lete): pool nie je thread-safe a jeho buffery
+// sa mozu resetovat az ked GPU dokonci frame slotu (drawFrameWithMVP vola record po fence).
+//
+// Uloha = jeden secondary; berie ju hociktore vlakno, volajuce robi tiez. Buffer je zaciaty
+// s inheritance info a RENDER_PASS_CONTINUE, fn don len nahra prikazy (stav pipeline sa
+// do secondary nededi, fn si ho bindne sama).
+class ParallelRecorder {
+public:
+    using JobFn = std::function<void(VkCommandBuffer cb, uint32_t job)>;
+
+    ParallelRecorder() = default;
+    ~ParallelRecorder();
+    ParallelRecorder(const ParallelRecorder&) = delete;
+    ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+    // threads <= 0 => min(8, hardware_concurrency - 1); 1 => bez pomocnych vlakien
+    bool init(VkDevice device, uint32_t queueFamily, uint32_t slots, int threads = 0);
+    void shutdown(VkDevice device);   // po vkDeviceWaitIdle
+    bool ready() const { return !pools.empty(); }
+    int  threadCount() const { return st.threads; }
+
+    // jobs uloh do poolov slotu; out dostane buffery v poradi uloh (pre vkCmdExecuteCommands)
+    bool record(VkDevice device, uint32_t slot, const VkCommandBufferInheritanceInfo& inh,
+        uint32_t jobs, const JobFn& fn, std::vector<VkCommandBuffer>& out);
+
+    const ParallelRecordStats& stats() const { return st; }
+
+private:
+    struct Pool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> cbs;   // alokovane, [0, used) su v aktualnom record
+        uint32_t used = 0;
+    };
+    Pool& poolOf(int thread, uint32_t slot) { return pools[size_t(thread) * slotCount + slot]; }
+    void runJobs(int thread);
+    void workerMain(int thread);
+
+    std::vector<Pool> pools;   // [vlakno][slot]
+    uint32_t slotCount = 0;
+    ParallelRecordStats st;
+
+    // aktualny record(), plati pocas behu uloh
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t slot = 0, jobCount = 0;
+    const JobFn* job = nullptr;
+    const VkCommandBufferInheritanceInfo* inherit = nullptr;
+    std::vector<VkCommandBuffer>* results = nullptr;
+    std::atomic<bool> failed{ false };
+
+    std::vector<std::thread> threads;
+    std::mutex mtx;
+    std::condition_variable cvWork, cvDone;
+    uint64_t jobGen = 0;
+    uint32_t workersLeft = 0;     // pomocne vlakna, ktore este nedobehli jobGen
+    std::atomic<uint32_t> nextJob{ 0 };
+    bool quit = false;
+};
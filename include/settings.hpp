@@ -1,4 +1,7 @@
 #pragma once
 // L? radius in chunks: 2 => (2*2+1)=5x5
 extern int gViewDist;        // default set in .cpp
-extern int gUnloadSlack;     // keep a 1-ring cache
\ No newline at end of file
+extern int gUnloadSlack;     // keep a 1-ring cache
+// mesh cache na disku (saves/meshcache): vypnuta, kym ju nikto nezapne; budget v MB (LRU)
+extern bool gMeshDiskCache;
+extern int  gMeshDiskCacheMB;
\ No newline at end of file
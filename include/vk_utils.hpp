@@ -36,6 +36,25 @@
     } while (0)
 #endif
 
+// Framy v lete: CPU nahrava frame N+1, kym GPU este kresli N. Vsetko, co CPU pise pre jeden
+// frame (command buffer, uniformy) alebo co cita po jeho fence, je v slote; slot sa znova
+// pouzije az po svojej fence.
+static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+struct FrameResources {
+    VkCommandBuffer cmd{};
+    // prvy priechod cez secondary buffery (paralelne nahravanie): drawScene ide sem, za buffery vlakien
+    VkCommandBuffer cmdSecondary{};
+    VkSemaphore     imageAvailable{};
+    VkFence         inFlight{};          // signalizovana, kym slot nic nema na GPU
+    uint64_t        serial = 0;          // frameSerial posledneho submitu slotu
+
+    // lighting UBO + set 0 voxel pipeline (binding 2 ukazuje na UBO tohto slotu)
+    VkBuffer        lightingUBO = VK_NULL_HANDLE;
+    VkDeviceMemory  lightingUBOMemory = VK_NULL_HANDLE;
+    VkDescriptorSet descSet{};
+};
+
 struct VulkanContext {
     VkInstance instance{};
     VkDebugUtilsMessengerEXT debugMessenger{};
@@ -45,6 +64,12 @@ struct VulkanContext {
     uint32_t presentQueueFamily = 0;
     VkQueue graphicsQueue{};
     VkQueue  presentQueue{};
+    // uploady (GpuUploader): samostatna transfer rodina ak ju GPU ma, inak graphics
+    uint32_t transferQueueFamily = 0;
+    VkQueue  transferQueue{};
+    bool     timelineSemaphores = false;   // Vulkan 1.2 feature; bez neho su uploady synchronne
+    bool     multiDrawIndirect = false;    // viac prikazov v jednom indirect drawe
+    bool     drawIndirectCount = false;    // Vulkan 1.2: pocet drawov z GPU bufferu (GpuCuller)
     VkSurfaceKHR surface{};
 
     // Swapchain
@@ -56,16 +81,33 @@ struct VulkanContext {
 
     // Minimal render stuff
     VkRenderPass renderPass{};
+    // dvojfazove kreslenie (Hi-Z occlusion): opaque priechod ulozi depth, druhy nacita color aj depth.
+    // Lisia sa od renderPass len load/store/layoutmi => rovnake framebuffery aj pipeline.
+    VkRenderPass renderPassOpaque{};
+    VkRenderPass renderPassResume{};
     std::vector<VkFramebuffer> framebuffers;
 
-    uint32_t currentFrame = 0;
+    // 1..MAX_FRAMES_IN_FLIGHT, da sa menit aj za behu (sloty su vytvorene vsetky)
+    uint32_t framesInFlight = 2;
+    uint32_t currentFrame = 0;           // slot framu, ktory sa prave nahrava
 
     VkCommandPool commandPool{};
-    std::vector<VkCommandBuffer> commandBuffers;
+    FrameResources frames[MAX_FRAMES_IN_FLIGHT];
+    // na obrazok swapchainu: present ho drzi, kym obrazok znova nevrati acquire
+    std::vector<VkSemaphore> renderFinishedSemaphores;
+
+    // posledny drawFrameWithMVP (ms): cakanie na fence slotu + acquire, nahravanie + submit
+    float frameWaitMs = 0.0f;
+    float frameRecordMs = 0.0f;
 
-    VkSemaphore imageAvailableSemaphore{};
-    VkSemaphore renderFinishedSemaphore{};
-    VkFence inFlightFence{};
+    // timeline: kazdy submit v drawFrameWithMVP signalizuje ++frameSerial (zije s device,
+    // nie so swapchainom). Transfer, ktory prepisuje buffery pouzite skorsimi framami, na neho caka.
+    VkSemaphore frameTimeline{};
+    uint64_t    frameSerial = 0;     // pocet odoslanych framov (rastie aj bez timeline)
+    uint64_t    frameCompleted = 0;  // framy <= tejto hodnote GPU dokoncila (po fence slotu v drawFrameWithMVP)
+    // dalsi frame pocka (VERTEX_INPUT) na uploadTimeline >= uploadWaitValue; 0 = necaka
+    VkSemaphore uploadTimeline{};
+    uint64_t    uploadWaitValue = 0;
 
     // Pipeline
     VkPipelineLayout pipelineLayout{};
@@ -81,6 +123,14 @@ struct VulkanContext {
     // Voxel pipeline
     VkPipeline voxelPipeline{};
     VkPipelineLayout voxelPipelineLayout{};
+    VkPipeline voxelTranslucentPipeline{};   // voda: blend, bez depth write (World::drawTranslucent)
+    // depth prepass (World::depthPrepass): len vertex shader, bez farby; farebny priechod po nom
+    // kresli tie iste drawy s depth EQUAL bez zapisu => kazdy pixel sa tienuje raz
+    VkPipeline voxelDepthPipeline{};
+    VkPipeline voxelEqualPipeline{};
+    // debug overdraw: aditivne fragmenty namiesto textury, [1] = farebny priechod po prepasse
+    VkPipeline voxelOverdrawPipeline[2]{};
+    bool       voxelOverdraw = false;        // prepinac v overlayi (cmdBindVoxelState, clear na cierno)
 
     // --- Sky (fullscreen triangle) ---
     VkPipeline       skyPipeline = VK_NULL_HANDLE;
@@ -96,15 +146,10 @@ struct VulkanContext {
 
     // Descriptor set layout/pool/set
     VkDescriptorSetLayout descSetLayout{};
-    VkDescriptorPool      descPool{};
-    VkDescriptorSet       descSet{};
+    VkDescriptorPool      descPool{};   // sety su v frames[i].descSet
 
-    // UBO for lighting
-    VkBuffer       lightingUBO = VK_NULL_HANDLE;
-    VkDeviceMemory lightingUBOMemory = VK_NULL_HANDLE;
+    // UBO for lighting (one per frame slot, see FrameResources)
     VkDeviceSize   lightingUBOSize = sizeof(LightingUBO);
-    // Persistently mapped pointer (optional but were using it)
-    void* lightingUBOPtr = nullptr;
 
     // materials UBO
     VkBuffer       materialUBO = {};
@@ -116,6 +161,8 @@ struct VulkanContext {
     VkImage       depthImage{};
     VkDeviceMemory depthMemory{};
     VkImageView   depthView{};
+    bool          depthSampled = false;   // format vie SAMPLED => depth ma aj depthSampleView
+    VkImageView   depthSampleView{};      // len DEPTH aspekt, pre HiZPyramid
 
     float maxSamplerAnisotropy = 1.0f;
     float currentAniso = 1.f;
@@ -139,10 +186,26 @@ bool createRenderPass(VulkanContext& ctx);
 bool createFramebuffers(VulkanContext& ctx);
 bool createCommandPoolAndBuffers(VulkanContext& ctx);
 bool createSyncObjects(VulkanContext& ctx);
+// pocka na vsetky framy v lete (zriedkave prerobenie zdielanych bufferov, nie kazdy frame)
+void waitFramesInFlight(VulkanContext& ctx);
 using DrawSceneFn = std::function<void(VkCommandBuffer)>;
-bool recordCommandBuffers(VulkanContext& ctx, float r, float g, float b, const float* mvp, DrawSceneFn drawScene);
-bool drawFrame(VulkanContext& ctx);
-bool drawFrameWithMVP(VulkanContext& ctx, const float* mvp, DrawSceneFn drawScene);
+// secondary command buffery pre prvy priechod (inh: render pass + framebuffer tohto framu)
+using RecordSecondaryFn = std::function<void(const VkCommandBufferInheritanceInfo& inh, const float* mvp,
+    std::vector<VkCommandBuffer>& out)>;
+// beforeRenderPass: prikazy mimo render passu (compute culling), po fence tohto framu
+// betweenPasses + drawSceneLate: render pass sa rozdeli - drawScene kresli opaque priechod,
+// betweenPasses bezi mimo render passu (Hi-Z, late culling), drawSceneLate dokresli zvysok
+// recordSecondary: po beforeRenderPass, este pred render passom (napr. paralelne vo vlaknach).
+// Ked nieco vrati, prvy priechod je VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS a drawScene
+// dostane FrameResources::cmdSecondary, ktory sa vykona az za nimi.
+bool drawFrameWithMVP(VulkanContext& ctx, const float* mvp, DrawSceneFn drawScene,
+    DrawSceneFn beforeRenderPass = nullptr, DrawSceneFn betweenPasses = nullptr,
+    DrawSceneFn drawSceneLate = nullptr, RecordSecondaryFn recordSecondary = nullptr);
+// voxel pipeline -> descriptor set slotu ctx.currentFrame -> 80 B push konstant (obe stage);
+// stav sa do secondary bufferov nededi, kazdy si ho bindne sam (aj z inych vlakien)
+void cmdBindVoxelState(const VulkanContext& ctx, VkCommandBuffer cb, const float* mvp);
+// opaque farebna pipeline podla ctx.voxelOverdraw; afterPrepass => varianta s depth EQUAL
+VkPipeline voxelColorPipeline(const VulkanContext& ctx, bool afterPrepass);
 void cleanupSwapchain(VulkanContext& ctx);
 bool createInstance(VulkanContext& ctx, const char* appName, bool enableValidation);
 void setupDebug(VulkanContext& ctx);
@@ -155,9 +218,14 @@ std::vector<char> readFile(const std::string& path);
 bool createPipeline(VulkanContext& ctx, const std::string& shaderDir);
 void destroyPipeline(VulkanContext& ctx);
 uint32_t findMemoryType(VkPhysicalDevice phys, uint32_t typeFilter, VkMemoryPropertyFlags props);
+// sharedWithTransfer: buffer plni transfer queue a cita graphics => CONCURRENT, ak su rodiny rozne
 bool createBuffer(VulkanContext& ctx, VkDeviceSize size, VkBufferUsageFlags usage,
-    VkMemoryPropertyFlags props, VkBuffer& buf, VkDeviceMemory& mem);
+    VkMemoryPropertyFlags props, VkBuffer& buf, VkDeviceMemory& mem, bool sharedWithTransfer = false);
+bool createTimelineSemaphore(VkDevice device, uint64_t initialValue, VkSemaphore& out);
 bool copyBuffer(VulkanContext& ctx, VkBuffer src, VkBuffer dst, VkDeviceSize size);
+// several src->dst ranges in one submit (dst may be in use by earlier frames)
+bool copyBufferRegions(VulkanContext& ctx, VkBuffer src, VkBuffer dst,
+    const VkBufferCopy* regions, uint32_t count);
 bool uploadVoxelMesh(VulkanContext& ctx, const std::vector<float>& verts,
     const std::vector<uint32_t>& indices);
 void destroyVoxelMesh(VulkanContext& ctx);
@@ -0,0 +1,33 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "world_config.hpp"
+
+// Vlastnosti bloku pre mesher a render:
+//  OPAQUE      - zakryva susedne steny, kresli sa v prvom priechode
+//  TRANSLUCENT - steny za nim ostavaju, kresli sa v druhom priechode s blendom
+//  LIQUID      - tekutina (voda); zatial len informacne pre mesher/fyziku
+enum BlockFlag : uint8_t {
+    BLOCK_FLAG_OPAQUE = 1 << 0,
+    BLOCK_FLAG_TRANSLUCENT = 1 << 1,
+    BLOCK_FLAG_LIQUID = 1 << 2,
+};
+
+struct BlockProps {
+    uint8_t flags = 0;
+};
+
+// tabulka per BlockID (0 = vzduch => ziadne flagy), ostatne su default opaque
+inline constexpr std::array<BlockProps, MAX_MATERIALS> BLOCK_PROPS = [] {
+    std::array<BlockProps, MAX_MATERIALS> t{};
+    for (int i = 1; i < MAX_MATERIALS; ++i) t[i].flags = BLOCK_FLAG_OPAQUE;
+    t[BLOCK_WATER].flags = BLOCK_FLAG_TRANSLUCENT | BLOCK_FLAG_LIQUID;
+    return t;
+}();
+
+inline uint8_t blockFlags(BlockID id) {
+    return id < MAX_MATERIALS ? BLOCK_PROPS[id].flags : uint8_t(BLOCK_FLAG_OPAQUE);
+}
+inline bool blockOpaque(BlockID id) { return (blockFlags(id) & BLOCK_FLAG_OPAQUE) != 0; }
+inline bool blockTranslucent(BlockID id) { return (blockFlags(id) & BLOCK_FLAG_TRANSLUCENT) != 0; }
+inline bool blockLiquid(BlockID id) { return (blockFlags(id) & BLOCK_FLAG_LIQUID) != 0; }
@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include "world_config.hpp"
@@ -42,10 +43,30 @@ struct Chunk {
     }
 };
 
+// najvyssi neprazdny riadok + 1 (0 = cely chunk je vzduch); nad nim netreba meshovat
+inline int chunkTopY(const Chunk& c) {
+    const size_t layer = size_t(CHUNK_SIZE) * CHUNK_SIZE;
+    for (int y = CHUNK_HEIGHT - 1; y >= 0; --y) {
+        const BlockID* row = &c.blocks[layer * y];
+        for (size_t i = 0; i < layer; ++i) if (row[i] != 0) return y + 1;
+    }
+    return 0;
+}
+
+// smer normaly steny; opaque indexy su v MeshData zoradene v tomto poradi
+enum FaceDir { FACE_PX = 0, FACE_NX, FACE_PY, FACE_NY, FACE_PZ, FACE_NZ, FACE_DIR_COUNT };
+inline int faceDirIndex(int axis, int faceDir) { return axis * 2 + (faceDir > 0 ? 0 : 1); }
+
 struct MeshData {
     // 10 floats/vertex: pos(3) + normal(3) + uv(2) + tile(2)
     std::vector<float> vertices;
     std::vector<uint32_t> indices;
+    // indices[0, opaqueIndexCount) su opaque, zvysok translucent (druhy priechod)
+    uint32_t opaqueIndexCount = 0;
+    // opaque indexy po smeroch (FaceDir), sucet = opaqueIndexCount
+    std::array<uint32_t, FACE_DIR_COUNT> dirIndexCount{};
+    // world-space AABB vertexov (prazdny mesh => min > max)
+    float aabbMin[3] = { 0, 0, 0 }, aabbMax[3] = { -1, -1, -1 };
 };
 
 // zaisti?, e indexy sedia do chunku
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "chunk.hpp"
+#include "mesher.hpp"
+
+// Zvys pri kazdej zmene vystupu meshera (layout vertexov, AO, poradie quadov, ...),
+// inak cache vrati stare meshe. Typicky sa meni spolu s bench/mesher_golden.txt.
+constexpr uint32_t MESHER_VERSION = 1;
+
+// Kluc meshu: hash padded snapshotu (vlastne voxely + okraje susedov) + box, LOD,
+// poloha chunku (vertexy su vo world space) a MESHER_VERSION.
+uint64_t meshCacheKey(const MeshVolume& vol, const MeshBox& box, int lod, int cx, int cy, int cz);
+
+struct MeshCacheStats {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;          // pamat + disk
+    uint64_t diskHits = 0;
+    uint64_t inserts = 0;
+    uint64_t evictions = 0;
+    uint64_t bytes = 0;         // aktualne v pamati
+    uint64_t diskBytes = 0;     // zapisane na disk v tejto relacii
+    uint64_t diskUsed = 0;      // aktualne v adresari (drzi sa pod disk budgetom)
+    uint64_t diskEvictions = 0; // zmazane subory (budget + stara MESHER_VERSION)
+};
+
+// LRU cache hotovych meshov (MeshData) s limitom v bajtoch, volitelne zrkadlena na disk
+// (jeden subor na kluc). Vsetky metody su thread-safe, volaju ich mesh workery.
+class MeshCache {
+public:
+    // 0 = cache vypnuta (lookup vzdy miss, insert nic)
+    void setBudget(uint64_t bytes);
+    // prazdny retazec = len pamat; inak sa zaznamy citaju/zapisuju do dir/<kluc>.vmc.
+    // Adresar sa pri tom zaindexuje (poradie podla casu zapisu), subory inej MESHER_VERSION
+    // sa zmazu a najstarsie idu prec, kym sa nezmesti do disk budgetu. Volat pred prvym mesh jobom.
+    void setDiskDir(const std::string& dir);
+    void setDiskBudget(uint64_t bytes);
+
+    // hit => out = kopia meshu, meshMs = kolko trvalo jeho povodne meshovanie
+    bool lookup(uint64_t key, MeshData& out, float& meshMs);
+    void insert(uint64_t key, const MeshData& mesh, float meshMs);
+
+    void clear();
+    MeshCacheStats stats() const;
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        MeshData mesh;
+        float    meshMs = 0.0f;
+        uint64_t bytes = 0;
+    };
+    void insertLocked(Entry&& e);
+    bool readDisk(const std::string& dir, uint64_t key, Entry& e) const;
+    bool writeDisk(const std::string& dir, const Entry& e) const;
+    // subor na disku (LRU ako v pamati); evictDiskLocked vrati kluce, ktore treba zmazat
+    struct DiskFile {
+        uint64_t key = 0;
+        uint64_t bytes = 0;
+    };
+    void touchDiskLocked(uint64_t key, uint64_t bytes);
+    void evictDiskLocked(std::vector<uint64_t>& victims);
+    void removeDisk(const std::string& dir, const std::vector<uint64_t>& victims) const;
+
+    mutable std::mutex mtx;
+    std::list<Entry> lru;   // front = naposledy pouzity
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    uint64_t budget = 256ull << 20;
+    std::string diskDir;
+    std::list<DiskFile> diskLru;   // front = naposledy zapisany / citany
+    std::unordered_map<uint64_t, std::list<DiskFile>::iterator> diskIndex;
+    uint64_t diskBudget = 512ull << 20;
+    MeshCacheStats st;
+};
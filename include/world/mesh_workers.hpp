@@ -0,0 +1,92 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "chunk.hpp"
+#include "mesher.hpp"
+#include "mesh_cache.hpp"
+#include "section_conn.hpp"
+
+// Jedna meshovacia uloha: jedna cast chunku (box) + nemenny padded snapshot voxelov
+struct MeshJob {
+    int cx = 0, cy = 0, cz = 0;
+    int part = 0;                                // WorldChunk::parts index
+    int lod = 0;                                 // > 0 => meshVolumeLodInto
+    uint64_t version = 0;                        // WorldChunk::partVersion[part] pri odoslani
+    MeshBox box;
+    std::shared_ptr<const MeshVolume> volume;    // worker cita len toto, nie world.map
+    MeshCache* cache = nullptr;                  // hit => bez meshovania (kluc = hash snapshotu)
+    int section = -1;                            // regionIndex => spocitaj aj sectionConnectivity
+};
+
+// Hotovy mesh; main thread ho prijme iba ak version stale sedi
+struct MeshResult {
+    int cx = 0, cy = 0, cz = 0;
+    int part = 0;
+    uint64_t version = 0;
+    MeshData mesh;
+    float ms = 0.0f;                        // cas meshovania na workeri
+    uint32_t quads = 0;
+    uint32_t allocs = 0;                    // MeshEmitStats::allocs
+    bool     cacheHit = false;
+    float    savedMs = 0.0f;                // cache hit: povodny cas meshovania - cas lookupu
+    int      section = -1;                  // z MeshJob; >= 0 => sectionConn plati
+    uint16_t sectionConn = SECTION_CONN_ALL;
+};
+
+struct MeshWorkerStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t replaced = 0;   // uloha v rade prepisana novsou verziou skor nez zacala
+    uint64_t stale = 0;      // hotove vysledky zahodene (chunk zmeneny/odlozeny)
+    float    lastMs = 0.0f;
+    double   totalMs = 0.0;  // sucet casov meshovania (avg = totalMs / completed)
+    uint64_t quads = 0;
+    uint64_t allocs = 0;     // rast vektorov pocas meshovania (vystup + scratch)
+    uint64_t cacheHits = 0;
+    double   cacheMsSaved = 0.0;
+};
+
+// Pool meshovacich vlakien. Mesher najprv spocita quady (per-thread scratch), potom
+// zapise vysledok rovno v presnej velkosti => 2 alokacie na ulohu, ziadna kopia.
+class MeshWorkerPool {
+public:
+    MeshWorkerPool() = default;
+    ~MeshWorkerPool();
+    MeshWorkerPool(const MeshWorkerPool&) = delete;
+    MeshWorkerPool& operator=(const MeshWorkerPool&) = delete;
+
+    // threads <= 0 => hardware_concurrency-1 (min 1); vola sa aj lenivo zo submit()
+    void start(int threads = 0);
+    void stop();
+
+    // ak ta ista cast chunku este caka v rade, len jej vymeni snapshot/verziu
+    void submit(MeshJob job);
+
+    // presunie hotove vysledky do out (main thread), vrati pocet
+    size_t drain(std::vector<MeshResult>& out);
+
+    // blokuje, kym nie je rad prazdny a vsetky workery necinne
+    void waitIdle();
+
+    size_t pending() const;
+    int    threadCount() const { return (int)threads.size(); }
+
+    MeshWorkerStats stats;
+
+private:
+    void workerMain();
+
+    mutable std::mutex mtx;
+    std::condition_variable cvJob;
+    std::condition_variable cvIdle;
+    std::deque<MeshJob> jobs;
+    std::vector<MeshResult> done;
+    std::vector<std::thread> threads;
+    int  busy = 0;
+    bool quit = false;
+};
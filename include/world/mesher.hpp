@@ -1,10 +1,63 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "chunk.hpp"
 
+// Box v lokalnych suradniciach chunku, [x0,x1) x [y0,y1) x [z0,z1)
+struct MeshBox {
+    int x0 = 0, y0 = 0, z0 = 0;
+    int x1 = 0, y1 = 0, z1 = 0;
+    bool empty() const { return x1 <= x0 || y1 <= y0 || z1 <= z0; }
+};
+
+// Nemenny "padded" snapshot voxelov pre meshovanie boxu: box + 1 voxel okolo,
+// vratane vrstiev susednych chunkov (nenacitany sused = vzduch).
+// Suradnice su lokalne k meshovanemu chunku (mozu byt -1 alebo CHUNK_SIZE).
+struct MeshVolume {
+    int ox = 0, oy = 0, oz = 0;   // lokalna suradnica prvku [0]
+    int sx = 0, sy = 0, sz = 0;   // rozmery
+    std::vector<BlockID> cells;   // x + sx*(z + sz*y), rovnako ako Chunk
+
+    inline BlockID get(int x, int y, int z) const {
+        x -= ox; y -= oy; z -= oz;
+        if (x < 0 || y < 0 || z < 0 || x >= sx || y >= sy || z >= sz) return 0;
+        return cells[size_t(x) + size_t(sx) * (size_t(z) + size_t(sz) * size_t(y))];
+    }
+};
+
+// Statistiky jedneho volania meshera (overlay / bench)
+struct MeshEmitStats {
+    uint32_t quads = 0;
+    uint32_t allocs = 0;   // kolkokrat museli rast out vektory alebo scratch (0 = vsetko z kapacity)
+};
+
 // Greedy mesher (rovnak nzov, in implementcia)
 MeshData meshChunk(const Chunk& c);
 
 // New: build mesh with a world-space offset from chunk coords (cx,cy,cz)
 MeshData meshChunkAt(const Chunk& c, int cx, int cy, int cz);
 
+// To iste ako meshChunkAt, ale zapisuje do existujuceho MeshData (arena workera).
+// out ma po volani presnu velkost; ak uz mal kapacitu, nic sa nealokuje.
+void meshChunkInto(const Chunk& c, int cx, int cy, int cz, MeshData& out, MeshEmitStats* stats = nullptr);
+
+// Greedy mesh boxu z padded snapshotu (steny vlastni len solid voxel v boxe).
+// Steny na hranici chunku sa vyradia, ak je susedny voxel plny; AO vidi cez sev.
+void meshVolumeInto(const MeshVolume& vol, const MeshBox& box, int cx, int cy, int cz,
+    MeshData& out, MeshEmitStats* stats = nullptr);
+
+// LOD uroven -> kolko voxelov na bunku (BIG_BLOCK_SIZE^lod: 1, 2, 4, 8)
+constexpr int MESH_LOD_COUNT = 4;
+inline int lodScale(int lod) {
+    int s = 1;
+    for (int i = 0; i < lod; ++i) s *= BIG_BLOCK_SIZE;
+    return s;
+}
+
+// Zjednoduseny mesh boxu pre vzdialene chunky: majority/top-surface downsample na
+// bunky lodScale(lod)^3 a greedy nad nimi. Hranica boxu sa berie ako vzduch (skirt).
+void meshVolumeLodInto(const MeshVolume& vol, const MeshBox& box, int lod, int cx, int cy, int cz,
+    MeshData& out, MeshEmitStats* stats = nullptr);
+
 MeshData meshChunkRegion(const Chunk& c, int x0, int y0, int z0, int x1, int y1, int z1);
\ No newline at end of file
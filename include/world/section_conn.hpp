@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include "chunk.hpp"
+#include "mesher.hpp"
+
+// Sekcia = region 32^3 chunku (ten isty index ako PART_REGION0 + regionIndex). Jej
+// prepojenie je 15 bitov, jeden na dvojicu stien (FaceDir): bit je 1, ked sa z jednej steny
+// da prejst na druhu cez neopaque voxely (vzduch, voda). Cave culling potom chodi po
+// sekciach od kamery len cez steny, ktore su takto prepojene.
+static constexpr uint16_t SECTION_CONN_ALL = 0x7FFF;   // nepocitane / nezname => vsetko otvorene
+
+inline int sectionPairBit(int a, int b) {
+    if (a > b) { const int t = a; a = b; b = t; }
+    return a * 5 - a * (a - 1) / 2 + (b - a - 1);   // a < b, 0..14
+}
+inline bool sectionConnected(uint16_t conn, int a, int b) {
+    return a == b || ((conn >> sectionPairBit(a, b)) & 1u) != 0;
+}
+
+// flood fill neopaque voxelov sekcie [x0, x0 + 32) x [y0, y0 + 32) x [z0, z0 + 32)
+// (lokalne suradnice chunku) zo snapshotu meshera; voxely mimo snapshotu su vzduch
+uint16_t sectionConnectivity(const MeshVolume& vol, int x0, int y0, int z0);
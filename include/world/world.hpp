@@ -2,12 +2,27 @@
 #pragma once
 #include <unordered_map>
 #include <memory>
+#include <array>
+#include <bitset>
+#include <chrono>
 #include <glm/glm.hpp>
 #include "world_stream.hpp"
 #include "chunk.hpp"
 #include "world_gen2.hpp"
 #include "mesher.hpp"
+#include "mesh_workers.hpp"
+#include "section_conn.hpp"
 #include "vk_utils.hpp"
+#include "gpu_upload.hpp"
+#include "gpu_heap.hpp"
+#include "geometry_pool.hpp"
+#include "deletion_queue.hpp"
+#include "frustum.hpp"
+#include "gpu_cull.hpp"
+#include "hiz.hpp"
+#include "draw_indirect.hpp"
+#include "occlusion.hpp"
+#include "parallel_record.hpp"
 #include "render_stats.hpp"
 
 
@@ -27,23 +42,100 @@ struct ChunkKeyHash {
     }
 };
 
+// Casti meshu chunku: 1-voxelovy okraj na kazdej strane + vnutro rozdelene na 32^3 regiony.
+// Od susedov zavisi iba okraj, takze prichod/odchod suseda remeshuje len jeho rim;
+// edit remeshuje len regiony/rimy v 3x3x3 okoli voxela (typicky 1-3 casti).
+//   RIM_NX/PX: x = 0 / 63, cele z (vratane rohov)
+//   RIM_NZ/PZ: z = 0 / 63, x v [1,63)
+//   REGION0 + regionIndex(rx,ry,rz): region orezany na x,z v [1,63)
+//   LOD: cely chunk v zjednodusenej mriezke (iba ked WorldChunk::lod > 0, ostatne su vtedy prazdne)
+enum ChunkMeshPart : int {
+    PART_RIM_NX = 0, PART_RIM_PX, PART_RIM_NZ, PART_RIM_PZ,
+    PART_REGION0,
+    PART_LOD = PART_REGION0 + REGION_COUNT,
+    PART_COUNT
+};
+using PartSet = std::bitset<PART_COUNT>;
+
+// ktora cast vlastni voxel (lokalne suradnice chunku)
+inline int chunkPartAt(int lx, int ly, int lz) {
+    if (lx == 0) return PART_RIM_NX;
+    if (lx == CHUNK_SIZE - 1) return PART_RIM_PX;
+    if (lz == 0) return PART_RIM_NZ;
+    if (lz == CHUNK_SIZE - 1) return PART_RIM_PZ;
+    return PART_REGION0 + regionIndex(lx / REGION_SIZE, ly / REGION_SIZE, lz / REGION_SIZE);
+}
+
+// GPU pod-rozsah jednej casti v rozsahu chunku (s rezervou, aby sa dal prepisat na mieste).
+// firstVertex/firstIndex su absolutne v stranke GeometryPool.
+struct ChunkGPUSlot {
+    uint32_t firstVertex = 0, vertexCap = 0;
+    uint32_t firstIndex = 0, indexCap = 0;
+    uint32_t indexCount = 0;   // indexy su lokalne k firstVertex (vertexOffset pri drawe)
+    uint32_t opaqueCount = 0;  // [0, opaqueCount) opaque, [opaqueCount, indexCount) translucent
+    std::array<uint32_t, FACE_DIR_COUNT> dirCount{};   // opaque rozsah po smeroch (FaceDir)
+    float aabbMin[3] = { 0, 0, 0 }, aabbMax[3] = { -1, -1, -1 };   // MeshData::aabb
+};
+
 struct ChunkGPU {
-    VkBuffer vbo = VK_NULL_HANDLE, ibo = VK_NULL_HANDLE;
-    VkDeviceMemory vmem = VK_NULL_HANDLE, imem = VK_NULL_HANDLE;
+    VkBuffer vbo = VK_NULL_HANDLE, ibo = VK_NULL_HANDLE;   // buffery stranky geo.page (nevlastni ich)
+    GeoAlloc geo;                                          // rozsahy v World::geoPool
     uint32_t vertexCount = 0;
     uint32_t indexCount = 0;
     uint32_t faceCount = 0;
     glm::ivec3 coord{ 0 };
 
+    std::array<ChunkGPUSlot, PART_COUNT> slots{};
+    uint32_t vertexCap = 0, indexCap = 0;   // velkost rozsahov (v prvkoch)
+    uint32_t translucentCount = 0;          // sucet translucent indexov (0 => druhy priechod preskoci)
 };
 
 struct WorldChunk {
     Chunk data;
-    MeshData meshCPU;   // concatenated region mesh (reuse your path)
     ChunkGPU gpu;
-    bool    needsUpload = false;
+    bool    needsUpload = false;   // vsetky casti hotove a niektore su v dirtyParts
+
+    // novy layout (vacsie buffery) sa plni asynchronne; kresli sa stary gpu, kym
+    // uploader nedokonci uploadTicket, potom sa prehodia (worldUploadDirty)
+    ChunkGPU pendingGpu;
+    uint64_t uploadTicket = 0;   // 0 = nic necaka
+    std::unique_ptr<UploadStream> uploadStream;   // layout vacsi nez volny staging, posiela sa po kuskoch
+    bool relocate = false;       // GpuHeap compaction: preloz do novych bufferov, aj ked sa casti zmestia
+    std::chrono::steady_clock::time_point queuedT0{};   // odkedy caka v upload fronte (0 = necaka)
+
+    std::array<MeshData, PART_COUNT> parts;
+    int topY = CHUNK_HEIGHT;   // nad tymto riadkom je vsetko vzduch (chunkTopY)
+    int lod = 0;               // 0 = plne rozlisenie (rimy + regiony), inak PART_LOD s lodScale(lod)
+
+    // verzia kazdej casti: meni sa pri kazdom novom jobe (unikatna v ramci World),
+    // vysledok z workera sa prijme len ked sa jeho verzia zhoduje
+    std::array<uint64_t, PART_COUNT> partVersion{};
+    PartSet pendingParts;      // cakaju na workera
+    PartSet dirtyParts;        // hotove, este neuploadnute
+
+    // edit -> viditelne: cas prveho neodoslaneho editu (0 = ziadny)
+    std::chrono::steady_clock::time_point editT0{};
+
+    // boxy pre SoftOcclusion (chunkOccluders); prepocitaju sa, az ked mesh dobehne
+    std::vector<OccluderBox> occluders;
+    bool occludersDirty = true;
+
+    // prepojenie stien kazdej sekcie (= regionu) pre cave culling; pocita ho mesh worker
+    // s regionom (edit remeshuje region editovaneho voxela), LOD chunk ma editovane sekcie otvorene
+    std::array<uint16_t, REGION_COUNT> sectionConn = [] {
+        std::array<uint16_t, REGION_COUNT> a;
+        a.fill(SECTION_CONN_ALL);
+        return a;
+    }();
 };
 
+// CPU pocet indexov cez vsetky casti
+inline size_t chunkIndexCount(const WorldChunk& wc) {
+    size_t n = 0;
+    for (auto& m : wc.parts) n += m.indices.size();
+    return n;
+}
+
 struct WorldKey {
     int cx, cy, cz;
     bool operator==(const WorldKey& o) const { return cx == o.cx && cy == o.cy && cz == o.cz; }
@@ -63,7 +155,15 @@ struct StreamConfig {
     int prefetchAhead = 2;   // bias loads in camera direction
     int budgetLoad = 4;      // chunks per tick
     int budgetMesh = 4;      // chunks per tick
-    int budgetUpload = 2;    // chunks per tick
+    int budgetUpload = 8;    // chunks per frame (editovane chunky idu mimo rozpoctu)
+    int budgetUploadKB = 4096;      // bajty na GPU za frame (prvy chunk framu ide vzdy)
+    float budgetUploadMs = 2.0f;    // CPU cas uploadov za frame
+    int stagingRingMB = 32;  // GpuUploader staging ring (vacsie uploady idu po kuskoch cez viac framov)
+    int gpuBlockMB = 64;     // GpuHeap blok device-local pamate
+    int geoPageMB = 16;      // GeometryPool: vertex buffer jednej stranky (index buffer ~1/7 z toho)
+
+    // LOD kruhy: chunk vo vzdialenosti (Chebyshev, v chunkoch) >= lodRing[i] ma LOD i+1
+    int lodRing[MESH_LOD_COUNT - 1] = { 4, 8, 14 };
 };
 
 struct World {
@@ -80,8 +180,154 @@ struct World {
     void        destroyChunk(const WorldKey& k);
     // ensure chunks in radius (cx,cz), only cy=0 for now
     void ensure(VulkanContext& ctx, int centerCx, int centerCz, int radius);
-    void draw(VulkanContext& ctx, VkCommandBuffer cb);
+    // opaque priechod; smery stien, ktore z camPos nemozu byt vidiet, sa preskocia
+    void draw(VulkanContext& ctx, VkCommandBuffer cb, const glm::vec3& camPos);
+    // druhy priechod: translucent rozsahy, chunky zoradene odzadu dopredu od kamery
+    void drawTranslucent(VulkanContext& ctx, VkCommandBuffer cb, const glm::vec3& camPos);
+    // frustum culling pre draw/drawTranslucent tohto framu (viewProj = FPSCamera::mvp),
+    // so softOcclusion aj CPU occlusion; bez volania (alebo po zmene chunkov) sa kresli vsetko
+    void cull(const glm::mat4& viewProj, const glm::vec3& camPos);
+    bool initGPU(VulkanContext& ctx);   // uploader, gpuHeap, geoPool (po createCommandPoolAndBuffers)
     void destroyGPU(VulkanContext& ctx);
+
+    // edit -> upload hotovy (potom je to viditelne v dalsom frame)
+    struct EditLatency {
+        float    lastMs = 0.0f, avgMs = 0.0f, maxMs = 0.0f;
+        uint32_t samples = 0;
+        uint32_t lastParts = 0;      // kolko casti islo pri poslednom uploade
+        uint64_t lastBytes = 0;      // kolko bajtov islo na GPU
+    } editLatency;
+
+    // frustum culling: box chunku + boxy jeho casti (regiony, rimy, LOD) v SoA poliach,
+    // v poradi podla stranky GeometryPool (draw binduje raz na stranku)
+    struct CullEntry {
+        WorldKey key{};
+        const ChunkGPU* gpu = nullptr;
+        uint32_t firstPart = 0, partCount = 0;   // rozsah v cullParts
+        PartSet  visible;                        // casti vo frustum (plati, ked cullReady)
+        bool     chunkVisible = false;
+    };
+    std::vector<CullEntry> cullEntries;
+    std::vector<uint8_t>   cullPartSlot;         // index v ChunkGPU::slots pre kazdy box cullParts
+    AabbSoA cullChunks, cullParts;
+    bool cullDirty = true;    // gpu niektoreho chunku sa zmenilo => prestavat polia
+    bool cullReady = false;   // visible plati pre aktualny pohlad
+    void invalidateCull() { cullDirty = true; cullReady = false; }
+    Frustum cullFrustum{};    // z posledneho cull()
+    glm::mat4 cullViewProj{ 1.0f };
+
+    // GPU culling: opaque casti ako zaznamy pre GpuCuller (cull.comp), stranky v poradi cullEntries
+    struct CullPage {
+        VkBuffer vbo = VK_NULL_HANDLE, ibo = VK_NULL_HANDLE;
+        uint32_t outBase = 0, maxDraws = 0;   // oblast stranky v draw bufferi GpuCuller
+    };
+    std::vector<GpuCullRecord> cullRecords;
+    std::vector<CullPage>      cullPages;
+    bool cullRecordsChanged = true;   // prestavane od posledneho GpuCuller::prepare
+    bool gpuCulling = false;          // prepinac v overlayi (bez GpuCuller::ready() sa ignoruje)
+    bool gpuCullRecorded = false;     // dispatch je v command bufferi tohto framu => draw ide indirect
+    GpuCullPhase gpuCullPhase = GpuCullPhase::All;   // faza dispatchu pred render passom
+    bool gpuCullLate = false;         // late dispatch je v command bufferi => drawLate
+    // mimo render passu (drawFrameWithMVP beforeRenderPass), po cull(): dispatch cull.comp
+    void recordGpuCull(VulkanContext& ctx, VkCommandBuffer cb, const glm::vec3& camPos);
+
+    // Hi-Z occlusion (len GPU cesta): draw kresli casti viditelne minuly frame, z jeho hlbky
+    // sa postavi Hi-Z a late faza dokresli (drawLate) tie, ktore sa odkryli => nic nepreskakuje
+    bool hizCulling = true;           // prepinac v overlayi (plati s gpuCulling)
+    uint64_t hizGeneration = 0;       // posledny obrazok hiz, ktory ma gpuCuller v descriptore
+    // main podla toho rozdeli render pass (drawFrameWithMVP betweenPasses / drawSceneLate)
+    bool occlusionActive() const {
+        return gpuCulling && hizCulling && gpuCuller.ready() && hiz.ready() && cullReady;
+    }
+    // medzi priechodmi: Hi-Z z hlbky opaque priechodu + late dispatch
+    void recordOcclusion(VulkanContext& ctx, VkCommandBuffer cb);
+    // v druhom priechode: casti, ktore late faza nasla ako nove viditelne
+    void drawLate(VkCommandBuffer cb);
+
+    // cave culling: BFS po sekciach 32^3 od sekcie kamery cez prepojene steny (sectionConn),
+    // len smerom od kamery a vo frustum; chunky/casti bez dosiahnutej sekcie sa preskocia este
+    // pred frustum testom casti. Ako softOcclusion plati pre CPU draw a translucent priechod.
+    bool caveCulling = true;          // prepinac v overlayi
+
+    // CPU occlusion (SoftOcclusion): boxy terenu z chunkov do occluderRadius okolo kamery
+    // sa vykreslia do 256x128 hlbky, chunky a casti vo frustum sa proti nej otestuju.
+    // Nezavisle od GPU (pri gpuCulling ovplyvni len translucent priechod).
+    bool softOcclusion = false;       // prepinac v overlayi
+    int  occluderRadius = 3;          // v chunkoch (Chebyshev)
+    SoftOcclusion softOcc;
+
+    // paralelne nahravanie (CPU cesta): viditelne chunky sa rozdelia medzi vlakna recorder,
+    // kazde nahra opaque drawy svojho kusu do vlastneho secondary command buffera
+    bool parallelRecording = true;    // prepinac v overlayi
+    bool parallelRecorded = false;    // opaque tohto framu uz je v secondary bufferoch => draw ho preskoci
+    // drawFrameWithMVP recordSecondary (po recordGpuCull, pred render passom); pri GPU culling
+    // alebo malo chunkoch nic nenahra a draw ide normalne na hlavnom vlakne
+    void recordParallel(VulkanContext& ctx, const VkCommandBufferInheritanceInfo& inh, const float* mvp,
+        const glm::vec3& camPos, std::vector<VkCommandBuffer>& out);
+
+    struct CullStats {
+        uint32_t chunksDrawn = 0, chunksCulled = 0;
+        uint32_t partsDrawn = 0, partsCulled = 0;
+        uint32_t chunksOccluded = 0, partsOccluded = 0;   // z culled, CPU occlusion
+        uint32_t chunksCave = 0, partsCave = 0;           // z culled, cave culling
+        uint32_t sectionsVisited = 0;                     // BFS, 0 = cave culling neaktivny
+        float    us = 0.0f;
+        float    caveUs = 0.0f;
+        float    occUs = 0.0f;        // occludery + raster + testy (v us)
+    } cullStats;
+
+    // poradie opaque chunkov (CPU cesta): frontToBack => odpredu dozadu po pasmach vzdialenosti,
+    // v pasme podla stranky (bind na stranku a pasmo); inak podla stranky ako cullEntries.
+    // depthPrepass => najprv len hlbka, potom farba s depth EQUAL (aj na GPU ceste).
+    bool frontToBack = true;          // prepinace v overlayi
+    bool depthPrepass = false;
+    std::vector<uint32_t> drawOrder;  // viditelne indexy cullEntries v poradi kreslenia (draw, recordParallel)
+
+    // posledny draw (opaque + translucent), pre overlay
+    struct DrawStats {
+        uint32_t draws = 0;        // draw prikazy (priame aj v indirect bufferi)
+        uint32_t calls = 0;        // vkCmdDraw* volania v command bufferi
+        uint32_t binds = 0;        // vertex/index bind (raz na stranku GeometryPool a pasmo)
+        uint64_t indices = 0;
+        uint64_t dirSkipped = 0;   // indexy stien odvratenych od kamery (nevykreslene)
+        uint32_t secondaries = 0;  // opaque v secondary bufferoch vlakien (0 = hlavne vlakno)
+        float    recordUs = 0.0f;  // recordParallel, od rozdelenia po posledny secondary
+        uint32_t prepassCalls = 0; // vkCmdDraw* depth prepassu (nie su v calls)
+        float    sortUs = 0.0f;    // drawOrder (radix sort)
+    } drawStats;
+
+    int lodCx = 0, lodCz = 0;      // stred LOD kruhov (chunk kamery), nastavuje worldUpdateLod
+
+    // upload scheduler: kamera pre prioritu (nastavuje worldStreamTick)
+    struct UploadView {
+        glm::vec3 pos{ 0.0f };
+        glm::vec3 fwd{ 0.0f, 0.0f, -1.0f };
+    } uploadView;
+    // rozpocet aktualneho framu a stav fronty, pre overlay
+    struct UploadQueue {
+        uint32_t depth = 0;            // pripravene chunky, ktore cakaju na dalsi frame
+        uint32_t edits = 0;            // z toho editovane
+        uint32_t frameChunks = 0;      // tento frame odoslane
+        uint64_t frameBytes = 0;
+        float    frameMs = 0.0f;
+        uint64_t frame = UINT64_MAX;   // ctx.frameSerial, ku ktoremu patri rozpocet
+        float    waitLastMs = 0.0f, waitAvgMs = 0.0f, waitMaxMs = 0.0f;   // pripraveny -> odoslany
+        uint64_t samples = 0;
+        uint64_t budgetHits = 0;       // volania, v ktorych rozpocet nieco odlozil
+    } uploadQueue;
+
+    uint64_t versionCounter = 0;   // zdroj pre WorldChunk::partVersion
+    GpuUploader uploader;          // staging -> VBO/IBO na transfer queue (init po createDevice)
+    uint32_t pendingSwaps = 0;     // chunky s uploadTicket alebo uploadStream
+    GpuHeap gpuHeap;               // device-local pamat (stranky geoPool)
+    GeometryPool geoPool;          // geometria vsetkych chunkov v par velkych VBO/IBO
+    DeletionQueue deletions;       // rozsahy geoPool, ktore este moze citat GPU (worldUploadDirty ich uvolni)
+    GpuCuller gpuCuller;           // init v main po createVoxelPipeline (volitelne)
+    HiZPyramid hiz;                // init v main s gpuCuller, resize pri novom swapchaine
+    IndirectDrawBuffer drawIndirect;   // CPU multi-draw indirect pre draw/drawTranslucent
+    ParallelRecorder recorder;     // vlakna + command pooly pre recordParallel (init v initGPU)
+    MeshCache meshCache;           // hotove meshe podla hashu obsahu (reload, navrat do oblasti)
+    MeshWorkerPool meshWorkers;    // posledny clen => zastavi sa ako prvy
 };
 
 // Add declarations (after World struct or near it)
@@ -90,5 +336,37 @@ inline bool worldVoxelSolid(const World& w, int vx, int vy, int vz) {
     return worldGetBlock(w, vx, vy, vz) != 0;
 }
 
-// Upload any chunks that have needsUpload=true (call once per frame after edits)
+// Padded voxel snapshot of a chunk-local box, including neighbor chunk layers
+void worldSnapshotVolume(const World& w, const WorldKey& k, const MeshBox& box, MeshVolume& out);
+
+// Bump part versions, snapshot their voxels and queue them for async meshing
+void worldRequestMeshParts(World& w, const WorldKey& k, WorldChunk& wc, const PartSet& parts);
+inline void worldRequestMesh(World& w, const WorldKey& k, WorldChunk& wc) {
+    worldRequestMeshParts(w, k, wc, PartSet().set());
+}
+
+// New chunk data is in place (generated/loaded): compute topY, queue full mesh and
+// remesh the rims of already loaded neighbors that touch it
+void worldChunkArrived(World& w, const WorldKey& k, WorldChunk& wc);
+
+// LOD level for chunk k from its ring distance to (w.lodCx, w.lodCz)
+int worldLodFor(const World& w, const WorldKey& k);
+
+// Move the LOD center to the camera chunk and re-mesh chunks whose ring changed.
+// A chunk keeps drawing its old mesh until the new level has arrived.
+void worldUpdateLod(World& w, int centerCx, int centerCz);
+
+// Remesh the rims of the (up to 8) loaded neighbors facing chunk k (after load/unload)
+void worldNotifyNeighbors(World& w, const WorldKey& k);
+
+// An edited voxel at local (lx,lz) on the chunk border changes what neighbors see
+void worldNotifyBorderVoxel(World& w, const WorldKey& k, int lx, int lz);
+
+// Apply finished meshes (stale versions are dropped). Returns how many were accepted.
+int worldCollectMeshes(World& w);
+
+// Upload any chunks that have needsUpload=true (call once per frame after edits).
+// Dirty parts that fit their GPU slot are rewritten in place (visible next frame), otherwise
+// the chunk is relaid out into new buffers and switches to them once their copy completes.
+// All copies of one call go to the GPU as a single batch (w.uploader).
 void worldUploadDirty(World& w, VulkanContext& ctx);
\ No newline at end of file
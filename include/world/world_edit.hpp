@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include "world.hpp"          // World, WorldKey, WorldChunk, world.map
 #include "mesher.hpp"         // meshChunkAt(...)
@@ -46,14 +47,40 @@ inline WorldChunk* worldSetOne(World& w, int wx, int wy, int wz, BlockID id) {
 
     // IMPORTANT: use Chunk::set(), not operator()
     wc->data.set(lx, ly, lz, id);
+    if (id != BLOCK_AIR && ly + 1 > wc->topY) wc->topY = ly + 1;   // mesh boxy su orezane na topY
     return wc;
 }
 
-// Rebuild CPU mesh with baked world offset (meshChunkAt) and mark for upload
-inline void rebuildAndMarkAt(WorldChunk* wc, int cx, int cy, int cz) {
-    if (!wc) return;
-    wc->meshCPU = meshChunkAt(wc->data, cx, cy, cz);  // correct world position
-    wc->needsUpload = true;
+// Voxel na okraji chunku => susedom treba premeshovat okraj (culling/AO cez hranicu)
+inline void notifyBorderAt(World& w, int wx, int wy, int wz) {
+    const int lx = floormod_i(wx, CHUNK_SIZE);
+    const int lz = floormod_i(wz, CHUNK_SIZE);
+    if (lx != 0 && lx != CHUNK_SIZE - 1 && lz != 0 && lz != CHUNK_SIZE - 1) return;
+    WorldKey k{ floordiv_i(wx, CHUNK_SIZE), floordiv_i(wy, CHUNK_HEIGHT), floordiv_i(wz, CHUNK_SIZE) };
+    if (w.map.find(k) == w.map.end()) return;
+    worldNotifyBorderVoxel(w, k, lx, lz);
+}
+
+// Ktore casti meshu treba prerobit po zmene voxela (lx,ly,lz): vsetky, ktorych box
+// (+1 voxel na culling/AO) ho obsahuje => casti celeho 3x3x3 okolia v ramci chunku.
+// (byvaly markRegionForCell z main.cpp, teraz aj s diagonalami kvoli AO a s rimmi)
+inline void markPartsForCell(PartSet& parts, int lx, int ly, int lz) {
+    for (int dy = -1; dy <= 1; ++dy)
+        for (int dz = -1; dz <= 1; ++dz)
+            for (int dx = -1; dx <= 1; ++dx) {
+                const int x = lx + dx, y = ly + dy, z = lz + dz;
+                if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_HEIGHT || z < 0 || z >= CHUNK_SIZE) continue;
+                parts.set(chunkPartAt(x, y, z));
+            }
+}
+
+// Queue async remesh of the dirty parts only - upload follows worldCollectMeshes
+inline void rebuildAndMarkAt(World& w, WorldChunk* wc, int cx, int cy, int cz, const PartSet& parts) {
+    if (!wc || parts.none()) return;
+    if (wc->editT0 == std::chrono::steady_clock::time_point{})
+        wc->editT0 = std::chrono::steady_clock::now();    // edit -> visible latency
+    wc->occludersDirty = true;   // SoftOcclusion boxes, rebuilt once the remesh is uploaded
+    worldRequestMeshParts(w, WorldKey{ cx, cy, cz }, *wc, parts);  // bumps part versions => older jobs are dropped
 }
 
 // Main edit entry: world coords + mode. Returns true if any change applied.
@@ -67,7 +94,10 @@ inline bool worldEditSet(World& w, int wx, int wy, int wz, BlockID id, EditMode
         const int cz = floordiv_i(wz, CHUNK_SIZE);
 
         if (WorldChunk* wc = worldSetOne(w, wx, wy, wz, id)) {
-            rebuildAndMarkAt(wc, cx, cy, cz);
+            PartSet parts;
+            markPartsForCell(parts, floormod_i(wx, CHUNK_SIZE), floormod_i(wy, CHUNK_HEIGHT), floormod_i(wz, CHUNK_SIZE));
+            rebuildAndMarkAt(w, wc, cx, cy, cz, parts);
+            notifyBorderAt(w, wx, wy, wz);
             changed = true;
         }
         return changed;
@@ -78,7 +108,7 @@ inline bool worldEditSet(World& w, int wx, int wy, int wz, BlockID id, EditMode
     const int by = snapToEven(wy);
     const int bz = snapToEven(wz);
 
-    struct Touched { WorldChunk* wc; int cx, cy, cz; };
+    struct Touched { WorldChunk* wc; int cx, cy, cz; PartSet parts; };
     std::array<Touched, 8> touched{};
     int nTouched = 0;
 
@@ -94,18 +124,30 @@ inline bool worldEditSet(World& w, int wx, int wy, int wz, BlockID id, EditMode
                 const int cz = floordiv_i(vz, CHUNK_SIZE);
 
                 if (WorldChunk* wc = worldSetOne(w, vx, vy, vz, id)) {
-                    // de-duplicate touched chunks
-                    bool seen = false;
-                    for (int i = 0; i < nTouched; ++i) if (touched[i].wc == wc) { seen = true; break; }
-                    if (!seen && nTouched < (int)touched.size()) touched[nTouched++] = { wc, cx, cy, cz };
+                    // de-duplicate touched chunks, accumulate their dirty parts
+                    int slot = -1;
+                    for (int i = 0; i < nTouched; ++i) if (touched[i].wc == wc) { slot = i; break; }
+                    if (slot < 0 && nTouched < (int)touched.size()) {
+                        slot = nTouched++;
+                        touched[slot] = { wc, cx, cy, cz, PartSet() };
+                    }
+                    if (slot >= 0)
+                        markPartsForCell(touched[slot].parts, floormod_i(vx, CHUNK_SIZE),
+                            floormod_i(vy, CHUNK_HEIGHT), floormod_i(vz, CHUNK_SIZE));
                     changed = true;
                 }
             }
 
-    // Remesh each touched chunk with the coords we tracked
+    // Remesh only the dirty parts of each touched chunk
     for (int i = 0; i < nTouched; ++i) {
-        rebuildAndMarkAt(touched[i].wc, touched[i].cx, touched[i].cy, touched[i].cz);
+        rebuildAndMarkAt(w, touched[i].wc, touched[i].cx, touched[i].cy, touched[i].cz, touched[i].parts);
     }
+    // az po vsetkych zapisoch, nech snapshoty susedov vidia cely 2x2x2 blok
+    if (changed)
+        for (int dz = 0; dz < 2; ++dz)
+            for (int dy = 0; dy < 2; ++dy)
+                for (int dx = 0; dx < 2; ++dx)
+                    notifyBorderAt(w, bx + dx, by + dy, bz + dz);
 
     return changed;
 }
\ No newline at end of file
@@ -12,7 +12,17 @@ layout(location=2) in float vAO;
 
 layout(location=0) out vec4 outColor;
 
+// 1.0 = opaque pipeline, translucent pipeline ho prepise (VkSpecializationInfo)
+layout(constant_id = 0) const float kAlpha = 1.0;
+// debug overdraw: kazdy fragment, ktory prejde depth testom, len pripocita (aditivny blend)
+// => ~12 vrstiev je cervena, ~25 zlta, ~50 biela
+layout(constant_id = 1) const bool kOverdraw = false;
+
 void main() {
+    if (kOverdraw) {
+        outColor = vec4(0.08, 0.04, 0.02, 1.0);
+        return;
+    }
     vec3 albedo = texture(uAtlas, vUV).rgb;
     vec3 N  = normalize(vN);
     vec3 Ld = normalize(-L.sunDir.xyz);
@@ -22,5 +32,5 @@ void main() {
     float ao = clamp(vAO, 0.0, 1.0);
     light = mix(light * 0.6, light, ao);
 
-    outColor = vec4(albedo * light, 1.0);
+    outColor = vec4(albedo * light, kAlpha);
 }
\ No newline at end of file
@@ -16,6 +16,10 @@ layout(push_constant) uniform Push {
     vec2 uAtlasTexel;    // (1.0/atlasWidth, 1.0/atlasHeight)
 } pc;
 
+// depth prepass kresli tie iste trojuholniky bez fragment shadera a farebny priechod ich
+// porovnava cez EQUAL => hlbka musi vyjst bit po bite rovnako v oboch pipeline
+invariant gl_Position;
+
 void main() {
     gl_Position = pc.uMVP * vec4(inPos, 1.0);
     vN  = inNormal;
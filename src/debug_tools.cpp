@@ -1,6 +1,7 @@
 #include "debug_tools.hpp"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 
 #include "settings.hpp"
 
@@ -16,23 +17,143 @@ void dbgCollectWorldStats(const World& w, DebugStats& s) {
     s.chunksTotal = (uint32_t)w.map.size();
     s.chunksReady = 0;
     s.tris = 0;
+    for (auto& n : s.chunksPerLod) n = 0;
     for (auto& kv : w.map) {
         const auto& wc = *kv.second;
-        s.tris += wc.meshCPU.indices.size() / 3;
+        if (wc.lod >= 0 && wc.lod < MESH_LOD_COUNT) s.chunksPerLod[wc.lod]++;
+        s.tris += chunkIndexCount(wc) / 3;
         const auto& g = wc.gpu;
         if (g.vbo && g.ibo && g.indexCount > 0) s.chunksReady++;
     }
+    const auto& ms = w.meshWorkers.stats;
+    s.meshThreads = w.meshWorkers.threadCount();
+    s.meshPending = (uint32_t)w.meshWorkers.pending();
+    s.meshDone = ms.completed;
+    s.meshStale = ms.stale;
+    s.meshLastMs = ms.lastMs;
+    s.meshAvgMs = ms.completed ? float(ms.totalMs / double(ms.completed)) : 0.0f;
+    s.meshAllocsPerJob = ms.completed ? float(double(ms.allocs) / double(ms.completed)) : 0.0f;
+    const MeshCacheStats cs = w.meshCache.stats();
+    s.cacheHitRate = cs.lookups ? float(double(cs.hits) / double(cs.lookups)) : 0.0f;
+    s.cacheHits = cs.hits;
+    s.cacheDiskHits = cs.diskHits;
+    s.cacheBytes = cs.bytes;
+    s.cacheDiskBytes = cs.diskBytes;
+    s.cacheDiskUsed = cs.diskUsed;
+    s.cacheMsSaved = ms.cacheMsSaved;
+    const UploadStats& us = w.uploader.stats();
+    s.uploadAsync = us.async;
+    s.uploadDedicated = us.dedicatedQueue;
+    s.uploadBatches = us.batches;
+    s.uploadBytes = us.bytes;
+    s.uploadInFlight = us.inFlight;
+    s.uploadPendingChunks = w.pendingSwaps;
+    s.stagingUsed = us.ringUsed;
+    s.stagingCapacity = us.ringCapacity;
+    s.stagingAllocsPerSec = us.allocsPerSec;
+    s.stagingMBPerSec = us.mbPerSec;
+    s.stagingFull = us.ringFull;
+    s.stagingStreamed = us.streamed;
+    const GpuHeapStats hs = w.gpuHeap.stats();
+    s.gpuBlocks = hs.blocks;
+    s.gpuDedicated = hs.dedicated;
+    s.gpuMaxAllocations = hs.maxAllocations;
+    s.gpuAllocs = hs.allocations;
+    s.gpuUsed = hs.used;
+    s.gpuReserved = hs.reserved;
+    s.gpuFragmentation = hs.fragmentation;
+    s.gpuDraining = hs.draining;
+    const GeometryPoolStats gs = w.geoPool.stats();
+    s.geoPages = gs.pages;
+    s.geoVertexUsed = gs.vertexUsed;
+    s.geoVertexCap = gs.vertexCap;
+    s.geoIndexUsed = gs.indexUsed;
+    s.geoIndexCap = gs.indexCap;
+    s.geoFragmentation = gs.fragmentation;
+    s.geoDraining = gs.draining;
+    s.geoRelocated = gs.relocated;
+    const World::UploadQueue& uq = w.uploadQueue;
+    s.uploadQueueDepth = uq.depth;
+    s.uploadQueueEdits = uq.edits;
+    s.uploadFrameChunks = uq.frameChunks;
+    s.uploadFrameBytes = uq.frameBytes;
+    s.uploadFrameMs = uq.frameMs;
+    s.uploadWaitAvgMs = uq.waitAvgMs;
+    s.uploadWaitMaxMs = uq.waitMaxMs;
+    const DeletionStats& ds = w.deletions.stats();
+    s.deletePending = ds.pending;
+    s.deletePendingBytes = ds.pendingBytes;
+    s.deleteRetired = ds.retired;
+    s.gpuLive = gs.vertexUsed + gs.indexUsed - std::min(gs.vertexUsed + gs.indexUsed, ds.pendingBytes);
+    s.drawBinds = w.drawStats.binds;
+    s.drawApiCalls = w.drawStats.calls;
+    s.drawIndirect = w.drawIndirect.ready();
+    s.drawIndirectOverflow = w.drawIndirect.stats().overflow;
+    s.recordAvailable = w.recorder.ready();
+    s.recordSecondaries = w.drawStats.secondaries;
+    s.recordThreads = w.recorder.threadCount();
+    s.recordUs = w.drawStats.recordUs;
+    s.drawSortUs = w.drawStats.sortUs;
+    s.drawPrepassCalls = w.drawStats.prepassCalls;
+    s.cullChunksDrawn = w.cullStats.chunksDrawn;
+    s.cullChunksCulled = w.cullStats.chunksCulled;
+    s.cullPartsDrawn = w.cullStats.partsDrawn;
+    s.cullPartsCulled = w.cullStats.partsCulled;
+    s.cullUs = w.cullStats.us;
+    s.cullIsa = frustumCullIsa();
+    s.occlOn = w.softOcclusion;
+    s.occlChunks = w.cullStats.chunksOccluded;
+    s.occlParts = w.cullStats.partsOccluded;
+    s.occlBoxes = w.softOcc.stats().occluders;
+    s.occlTris = w.softOcc.stats().triangles;
+    s.occlUs = w.cullStats.occUs;
+    s.occlRasterUs = w.softOcc.stats().rasterUs;
+    s.occlThreads = w.softOcc.stats().threads;
+    s.caveOn = w.caveCulling;
+    s.caveChunks = w.cullStats.chunksCave;
+    s.caveParts = w.cullStats.partsCave;
+    s.caveSections = w.cullStats.sectionsVisited;
+    s.caveUs = w.cullStats.caveUs;
+    const GpuCullStats& gc = w.gpuCuller.stats();
+    s.gpuCullAvailable = w.gpuCuller.ready();
+    s.gpuCullOn = w.gpuCulling && s.gpuCullAvailable;
+    s.gpuCullRecords = gc.records;
+    s.gpuCullDraws = gc.draws;
+    s.gpuCullPages = gc.pages;
+    s.hizAvailable = w.hiz.ready();
+    s.hizOn = w.occlusionActive();
+    s.hizTested = gc.tested;
+    s.hizOccluded = gc.occluded;
+    s.hizLateDraws = gc.lateDraws;
+    s.editLastMs = w.editLatency.lastMs;
+    s.editAvgMs = w.editLatency.avgMs;
+    s.editMaxMs = w.editLatency.maxMs;
+    s.editParts = w.editLatency.lastParts;
+    s.editBytes = w.editLatency.lastBytes;
+    s.drawCalls = w.drawStats.draws;
+    s.drawTris = w.drawStats.indices / 3;
+    s.dirSkippedTris = w.drawStats.dirSkipped / 3;
 }
 void dbgSetCamera(DebugStats& s, const glm::vec3& pos, float yaw, float pitch) {
     s.camPos = pos; s.camYaw = yaw; s.camPitch = pitch;
 }
 void dbgSetFrame(DebugStats& s, float dt) {
     s.dt = dt; if (dt > 0.f) s.fps = 1.0f / dt;
+    if (!s.ctxRef || dt <= 0.f) return;
+    const VulkanContext& ctx = *s.ctxRef;
+    const float ms = dt * 1000.0f;
+    const float a = std::min(1.0f, dt);   // ~1 s okno
+    auto ema = [a](float& v, float x) { v = v > 0.f ? v + (x - v) * a : x; };
+    s.framesInFlight = ctx.framesInFlight;
+    ema(s.cpuFrameMs, std::max(0.0f, ms - ctx.frameWaitMs));
+    ema(s.frameWaitMs, ctx.frameWaitMs);
+    ema(s.frameRecordMs, ctx.frameRecordMs);
+    ema(s.fpsAvg, 1.0f / dt);
 }
 
 void dbgLogOnceBoot(const World& w) {
     size_t tris = 0;
-    for (auto& kv : w.map) tris += kv.second->meshCPU.indices.size() / 3;
+    for (auto& kv : w.map) tris += chunkIndexCount(*kv.second) / 3;
     std::cerr << "[BOOT] chunks=" << w.map.size() << " tris=" << tris << "\n";
 }
 
@@ -149,7 +270,8 @@ bool dbgImGuiInit(VulkanContext& ctx, GLFWwindow* win) {
     ii.Queue = ctx.graphicsQueue;
     ii.DescriptorPool = g_imguiPool;    // <<< use our local pool
     ii.MinImageCount = (uint32_t)ctx.swapchainImages.size();
-    ii.ImageCount = (uint32_t)ctx.swapchainImages.size();
+    // ImGui strieda vertex buffery po ImageCount framoch: aspon tolko, kolko framov moze byt v lete
+    ii.ImageCount = std::max((uint32_t)ctx.swapchainImages.size(), MAX_FRAMES_IN_FLIGHT);
     ii.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
     ii.Subpass = 0;
 
@@ -185,18 +307,102 @@ void dbgImGuiDraw(VulkanContext& ctx, VkCommandBuffer cb, const DebugStats& s) {
         ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
 
     ImGui::Text("FPS: %.1f  (dt=%.3f)", s.fps, s.dt);
+    ImGui::Text("Frames: %u in flight  CPU %.2f ms (record %.2f)  wait %.2f ms  %.1f fps avg",
+        s.framesInFlight, s.cpuFrameMs, s.frameRecordMs, s.frameWaitMs, s.fpsAvg);
+    int fif = (int)ctx.framesInFlight;
+    if (ImGui::SliderInt("Frames in flight", &fif, 1, (int)MAX_FRAMES_IN_FLIGHT))
+        ctx.framesInFlight = (uint32_t)fif;
     ImGui::Separator();
     ImGui::Text("Cam:  x=%.2f  y=%.2f  z=%.2f", s.camPos.x, s.camPos.y, s.camPos.z);
     ImGui::Text("Yaw: %.1f  Pitch: %.1f", s.camYaw, s.camPitch);
     ImGui::Separator();
     ImGui::Text("Chunks: %u total  %u ready", s.chunksTotal, s.chunksReady);
     ImGui::Text("Tris:   %llu", (unsigned long long)s.tris);
+    ImGui::Text("Draw:   %u draws  %u binds  %llu tris  (%llu back-facing skipped)",
+        s.drawCalls, s.drawBinds, (unsigned long long)s.drawTris, (unsigned long long)s.dirSkippedTris);
+    ImGui::Text("        %u API calls (%s)%s", s.drawApiCalls, s.drawIndirect ? "multi-draw indirect" : "direct",
+        s.drawIndirectOverflow ? "  indirect buffer full, growing" : "");
+    if (s.recordSecondaries)
+        ImGui::Text("        Record: %u secondary buffers on %d threads  %.0f us",
+            s.recordSecondaries, s.recordThreads, s.recordUs);
+    if (s.drawSortUs > 0.0f || s.drawPrepassCalls)
+        ImGui::Text("        Order: front-to-back sort %.0f us  depth prepass %u API calls",
+            s.drawSortUs, s.drawPrepassCalls);
+    ImGui::Text("Cull:   chunks %u drawn %u culled  parts %u drawn %u culled  %.0f us (%s)",
+        s.cullChunksDrawn, s.cullChunksCulled, s.cullPartsDrawn, s.cullPartsCulled, s.cullUs, s.cullIsa);
+    if (s.occlOn)
+        ImGui::Text("        Occl: chunks %u parts %u occluded  %u boxes %u tris  raster %.0f us (%d thr)  total %.0f us",
+            s.occlChunks, s.occlParts, s.occlBoxes, s.occlTris, s.occlRasterUs, s.occlThreads, s.occlUs);
+    if (s.caveOn)
+        ImGui::Text("        Caves: chunks %u parts %u hidden  %u sections reached  %.0f us",
+            s.caveChunks, s.caveParts, s.caveSections, s.caveUs);
+    if (s.gpuCullOn)
+        ImGui::Text("        GPU: %u parts -> %u indirect draws  %u pages", s.gpuCullRecords, s.gpuCullDraws, s.gpuCullPages);
+    if (s.hizOn)
+        ImGui::Text("        Hi-Z: %u tested  %u occluded (%.1f%%)  %u late draws", s.hizTested, s.hizOccluded,
+            s.hizTested ? 100.0f * s.hizOccluded / s.hizTested : 0.0f, s.hizLateDraws);
+    ImGui::Text("LOD:    %u / %u / %u / %u  (1x/2x/4x/8x)",
+        s.chunksPerLod[0], s.chunksPerLod[1], s.chunksPerLod[2], s.chunksPerLod[3]);
+    ImGui::Text("Mesh:   %d thr  %u pending  %llu done  %llu stale  last %.2f ms",
+        s.meshThreads, s.meshPending, (unsigned long long)s.meshDone,
+        (unsigned long long)s.meshStale, s.meshLastMs);
+    ImGui::Text("        avg %.2f ms/job  %.2f allocs/job", s.meshAvgMs, s.meshAllocsPerJob);
+    ImGui::Text("Cache:  %.1f%% hit (%llu, %llu disk)  %.1f MB  disk %.1f MB (+%.1f)  saved %.0f ms",
+        s.cacheHitRate * 100.0f, (unsigned long long)s.cacheHits, (unsigned long long)s.cacheDiskHits,
+        s.cacheBytes / (1024.0 * 1024.0), s.cacheDiskUsed / (1024.0 * 1024.0),
+        s.cacheDiskBytes / (1024.0 * 1024.0), s.cacheMsSaved);
+    ImGui::Text("Upload: %s%s  %llu batches  %.1f MB  %u in flight  %u chunks waiting",
+        s.uploadAsync ? "async" : "sync", s.uploadDedicated ? " (transfer queue)" : "",
+        (unsigned long long)s.uploadBatches, s.uploadBytes / (1024.0 * 1024.0),
+        s.uploadInFlight, s.uploadPendingChunks);
+    ImGui::Text("        staging %.1f / %.0f MB  %.0f allocs/s  %.1f MB/s  %llu full  %llu streamed",
+        s.stagingUsed / (1024.0 * 1024.0), s.stagingCapacity / (1024.0 * 1024.0),
+        s.stagingAllocsPerSec, s.stagingMBPerSec,
+        (unsigned long long)s.stagingFull, (unsigned long long)s.stagingStreamed);
+    ImGui::Text("        queue %u (%u edits)  frame %u chunks %.1f KB %.2f ms  wait avg %.0f ms max %.0f",
+        s.uploadQueueDepth, s.uploadQueueEdits, s.uploadFrameChunks, s.uploadFrameBytes / 1024.0,
+        s.uploadFrameMs, s.uploadWaitAvgMs, s.uploadWaitMaxMs);
+    ImGui::Text("GPU:    %.1f / %.1f MB  %u blocks (%u dedicated, limit %u)  %u allocs  frag %.0f%%",
+        s.gpuUsed / (1024.0 * 1024.0), s.gpuReserved / (1024.0 * 1024.0),
+        s.gpuBlocks, s.gpuDedicated, s.gpuMaxAllocations, s.gpuAllocs, s.gpuFragmentation * 100.0f);
+    ImGui::Text("        live %.1f MB  pending free %u (%.1f MB)  %llu freed",
+        s.gpuLive / (1024.0 * 1024.0), s.deletePending, s.deletePendingBytes / (1024.0 * 1024.0),
+        (unsigned long long)s.deleteRetired);
+    ImGui::Text("Geo:    %u pages  V %.1f / %.1f MB  I %.1f / %.1f MB  frag %.0f%%",
+        s.geoPages, s.geoVertexUsed / (1024.0 * 1024.0), s.geoVertexCap / (1024.0 * 1024.0),
+        s.geoIndexUsed / (1024.0 * 1024.0), s.geoIndexCap / (1024.0 * 1024.0), s.geoFragmentation * 100.0f);
+    if (s.gpuDraining || s.geoDraining || s.geoRelocated)
+        ImGui::Text("        compacting: block %s, %u pages  %llu chunks moved",
+            s.gpuDraining ? "yes" : "no", s.geoDraining, (unsigned long long)s.geoRelocated);
+    ImGui::Text("Edit:   last %.1f ms  avg %.1f  max %.1f  (%u parts, %.1f KB)",
+        s.editLastMs, s.editAvgMs, s.editMaxMs, s.editParts, s.editBytes / 1024.0);
 
     ImGui::Separator();
     ImGui::Text("Streaming");
     ImGui::SliderInt("View Distance (chunks)", &gViewDist, 1, 8);
     ImGui::SliderInt("Unload Slack", &gUnloadSlack, 0, 2);
     // Changing the slider will automatically trigger the block above next frame
+    if (s.worldRef)
+    {
+        ImGui::Checkbox("CPU occlusion (software raster 256x128)", &s.worldRef->softOcclusion);
+        ImGui::Checkbox("Cave culling (section connectivity)", &s.worldRef->caveCulling);
+        if (s.recordAvailable)
+            ImGui::Checkbox("Parallel recording (secondary command buffers)", &s.worldRef->parallelRecording);
+        ImGui::Checkbox("Front-to-back draw order", &s.worldRef->frontToBack);
+        ImGui::Checkbox("Depth prepass", &s.worldRef->depthPrepass);
+    }
+    if (s.ctxRef)
+        ImGui::Checkbox("Overdraw heatmap (additive, ~12x red, ~25x yellow)", &s.ctxRef->voxelOverdraw);
+    if (s.gpuCullAvailable && s.worldRef)
+    {
+        ImGui::Checkbox("GPU culling (compute + indirect count)", &s.worldRef->gpuCulling);
+        if (s.hizAvailable)
+            ImGui::Checkbox("Hi-Z occlusion (two-phase)", &s.worldRef->hizCulling);
+        else
+            ImGui::TextDisabled("Hi-Z occlusion: not available");
+    }
+    else
+        ImGui::TextDisabled("GPU culling: not available");
 
     static char pathBuf[256] = "saves/world.vwld";
     static std::string lastMsg;
@@ -245,7 +451,8 @@ void dbgImGuiDraw(VulkanContext& ctx, VkCommandBuffer cb, const DebugStats& s) {
     u.sunColor = glm::vec4(sunCol, 0.0f);
     u.ambient = glm::vec4(ambient, 0.0f);
 
-    updateBufferMapped(ctx.device, ctx.lightingUBOMemory, &u, sizeof(u));  // ? correct
+    // UBO slotu tohto framu (ostatne este moze citat GPU)
+    updateBufferMapped(ctx.device, ctx.frames[ctx.currentFrame].lightingUBOMemory, &u, sizeof(u));
 
     // === Window / Display ===
     static int modeIndex = 0; // 0=Windowed, 1=Borderless, 2=Exclusive
@@ -0,0 +1,55 @@
+#include "deletion_queue.hpp"
+#include <algorithm>
+
+void DeletionQueue::push(uint64_t bytes, Fn fn)
+{
+    Entry e;
+    e.bytes = bytes;
+    e.fn = std::move(fn);
+    entries.push_back(std::move(e));
+    ++st.pending;
+    st.pendingBytes += bytes;
+}
+
+void DeletionQueue::retire(VulkanContext& ctx, Entry& e)
+{
+    e.fn(ctx);
+    --st.pending;
+    st.pendingBytes -= e.bytes;
+    ++st.retired;
+    st.retiredBytes += e.bytes;
+}
+
+void DeletionQueue::collect(VulkanContext& ctx, const GpuUploader& up)
+{
+    if (entries.empty()) return;
+
+    uint64_t doneFrame = ctx.frameCompleted;
+    if (ctx.frameTimeline) {
+        uint64_t v = 0;
+        if (vkGetSemaphoreCounterValue(ctx.device, ctx.frameTimeline, &v) == VK_SUCCESS)
+            doneFrame = std::max(doneFrame, v);
+    }
+
+    // nove polozky (su na konci): vsetko, co GPU doteraz dostalo, ich mohlo pouzit
+    for (auto it = entries.rbegin(); it != entries.rend() && !it->stamped; ++it) {
+        Entry& e = *it;
+        e.frame = ctx.frameSerial;
+        e.ticket = up.lastTicket();
+        e.stamped = true;
+    }
+
+    // frame/ticket pozdlz fronty neklesaju => staci brat zo zaciatku
+    while (!entries.empty()) {
+        Entry& e = entries.front();
+        if (e.frame > doneFrame || !up.done(e.ticket)) break;
+        retire(ctx, e);
+        entries.pop_front();
+    }
+}
+
+void DeletionQueue::flush(VulkanContext& ctx)
+{
+    for (Entry& e : entries) retire(ctx, e);
+    entries.clear();
+}
@@ -0,0 +1,125 @@
+#include "draw_indirect.hpp"
+#include <algorithm>
+#include <cstdio>
+
+bool IndirectDrawBuffer::init(VulkanContext& ctx, uint32_t capacity)
+{
+    if (!ctx.multiDrawIndirect) {
+        printf("[Indirect] multiDrawIndirect not supported, drawing directly\n");
+        return false;
+    }
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &props);
+    maxDrawCount = std::max(1u, props.limits.maxDrawIndirectCount);
+    for (Slot& s : slots)
+        if (!create(ctx, s, capacity)) {
+            shutdown(ctx);
+            return false;
+        }
+    cur = &slots[0];
+    st.capacity = cur->cap;
+    printf("[Indirect] %u commands (%.1f KB) x %u frames in flight, max %u per call\n", capacity,
+        capacity * sizeof(VkDrawIndexedIndirectCommand) / 1024.0, MAX_FRAMES_IN_FLIGHT, maxDrawCount);
+    return true;
+}
+
+bool IndirectDrawBuffer::create(VulkanContext& ctx, Slot& s, uint32_t capacity)
+{
+    const VkDeviceSize bytes = VkDeviceSize(capacity) * sizeof(VkDrawIndexedIndirectCommand);
+    if (!createBuffer(ctx, bytes, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, s.buf, s.mem)) {
+        fprintf(stderr, "[Indirect] buffer for %u commands failed\n", capacity);
+        destroy(ctx, s);
+        return false;
+    }
+    void* p = nullptr;
+    if (vkMapMemory(ctx.device, s.mem, 0, VK_WHOLE_SIZE, 0, &p) != VK_SUCCESS) {
+        destroy(ctx, s);
+        return false;
+    }
+    s.cmds = static_cast<VkDrawIndexedIndirectCommand*>(p);
+    s.cap = capacity;
+    return true;
+}
+
+void IndirectDrawBuffer::destroy(VulkanContext& ctx, Slot& s)
+{
+    if (s.mem && s.cmds) vkUnmapMemory(ctx.device, s.mem);
+    if (s.buf) vkDestroyBuffer(ctx.device, s.buf, nullptr);
+    if (s.mem) vkFreeMemory(ctx.device, s.mem, nullptr);
+    s = Slot{};
+}
+
+void IndirectDrawBuffer::shutdown(VulkanContext& ctx)
+{
+    for (Slot& s : slots) destroy(ctx, s);
+    cur = &slots[0];
+    rest = {};
+    reserved = reservedDemand = 0;
+    st.capacity = 0;
+}
+
+void IndirectDrawBuffer::begin(VulkanContext& ctx)
+{
+    const uint32_t demand = reservedDemand + rest.demand;
+    st.commands = reserved + rest.count;
+    st.overflow = demand > st.commands ? demand - st.commands : 0;
+    cur = &slots[ctx.currentFrame % MAX_FRAMES_IN_FLIGHT];
+    // minuly frame sa nezmestil: buffer slotu uz GPU necita (po jeho fence) => vymen za vacsi
+    if (cur->cmds && demand > cur->cap) {
+        uint32_t n = cur->cap;
+        while (n < demand) n *= 2;
+        destroy(ctx, *cur);
+        if (create(ctx, *cur, n)) ++st.grows;
+    }
+    st.capacity = cur->cap;
+    rest = {};
+    rest.buf = cur->buf;
+    rest.cmds = cur->cmds;
+    rest.cap = cur->cmds ? cur->cap : 0;
+    rest.maxDrawCount = maxDrawCount;
+    reserved = reservedDemand = 0;
+}
+
+IndirectDrawRange IndirectDrawBuffer::reserve(uint32_t n)
+{
+    IndirectDrawRange r;
+    r.maxDrawCount = maxDrawCount;
+    reservedDemand += n;
+    if (rest.count || n > rest.cap) return r;
+    r.buf = rest.buf;
+    r.cmds = rest.cmds;
+    r.base = rest.base;
+    r.cap = n;
+    rest.cmds += n;
+    rest.base += n;
+    rest.cap -= n;
+    reserved += n;
+    return r;
+}
+
+bool IndirectDrawRange::push(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset)
+{
+    ++demand;
+    if (count == cap) return false;
+    VkDrawIndexedIndirectCommand& c = cmds[count++];
+    c.indexCount = indexCount;
+    c.instanceCount = 1;
+    c.firstIndex = firstIndex;
+    c.vertexOffset = vertexOffset;
+    c.firstInstance = 0;
+    return true;
+}
+
+uint32_t IndirectDrawRange::flush(VkCommandBuffer cb)
+{
+    uint32_t calls = 0;
+    while (flushed < count) {
+        const uint32_t n = std::min(count - flushed, maxDrawCount);
+        vkCmdDrawIndexedIndirect(cb, buf, VkDeviceSize(base + flushed) * sizeof(VkDrawIndexedIndirectCommand),
+            n, sizeof(VkDrawIndexedIndirectCommand));
+        flushed += n;
+        ++calls;
+    }
+    return calls;
+}
@@ -0,0 +1,127 @@
+#include "frustum.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_SSE 1
+#endif
+
+Frustum frustumFromMatrix(const glm::mat4& m)
+{
+    // glm je column-major: riadok i = (m[0][i], m[1][i], m[2][i], m[3][i])
+    const glm::vec4 r0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 r1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 r2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 r3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f;
+    f.planes[0] = r3 + r0;   // left
+    f.planes[1] = r3 - r0;   // right
+    f.planes[2] = r3 + r1;   // bottom (pri Y flipe top, dvojica je symetricka)
+    f.planes[3] = r3 - r1;
+    f.planes[4] = r3 + r2;   // near
+    f.planes[5] = r3 - r2;   // far
+    for (glm::vec4& p : f.planes) {
+        const float len = glm::length(glm::vec3(p));
+        if (len > 0.0f) p /= len;
+    }
+    return f;
+}
+
+// prazdny box: p-vrchol je vzdy hlboko za kazdou rovinou (konecne cisla => ziadne NaN z 0 * inf)
+static constexpr float EMPTY_MIN = 1e30f, EMPTY_MAX = -1e30f;
+
+void AabbSoA::clear()
+{
+    count = 0;
+    for (auto* v : { &minX, &minY, &minZ }) v->assign(AABB_LANES, EMPTY_MIN);
+    for (auto* v : { &maxX, &maxY, &maxZ }) v->assign(AABB_LANES, EMPTY_MAX);
+}
+
+uint32_t AabbSoA::push(const float mn[3], const float mx[3])
+{
+    if (minX.size() < AABB_LANES) clear();
+    const uint32_t i = count++;
+    minX[i] = mn[0]; minY[i] = mn[1]; minZ[i] = mn[2];
+    maxX[i] = mx[0]; maxY[i] = mx[1]; maxZ[i] = mx[2];
+    for (auto* v : { &minX, &minY, &minZ }) v->push_back(EMPTY_MIN);
+    for (auto* v : { &maxX, &maxY, &maxZ }) v->push_back(EMPTY_MAX);
+    return i;
+}
+
+uint32_t frustumCullAabbs(const Frustum& f, const AabbSoA& b, uint32_t first, uint32_t count, uint8_t* vis)
+{
+    if (count == 0) return 0;
+
+    // pre kazdu rovinu vopred vyber pole p-vrcholu (podla znamienka normaly) => bez blendov
+    const float* px[6]; const float* py[6]; const float* pz[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& pl = f.planes[p];
+        px[p] = (pl.x >= 0.0f ? b.maxX.data() : b.minX.data()) + first;
+        py[p] = (pl.y >= 0.0f ? b.maxY.data() : b.minY.data()) + first;
+        pz[p] = (pl.z >= 0.0f ? b.maxZ.data() : b.minZ.data()) + first;
+    }
+
+    uint32_t visible = 0;
+#if defined(FRUSTUM_AVX)
+    for (uint32_t i = 0; i < count; i += 8) {
+        __m256 out = _mm256_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const glm::vec4& pl = f.planes[p];
+            __m256 d = _mm256_set1_ps(pl.w);
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(pl.x), _mm256_loadu_ps(px[p] + i)));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(pl.y), _mm256_loadu_ps(py[p] + i)));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(pl.z), _mm256_loadu_ps(pz[p] + i)));
+            out = _mm256_or_ps(out, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+        const int culled = _mm256_movemask_ps(out);
+        const uint32_t n = count - i < 8 ? count - i : 8;
+        for (uint32_t k = 0; k < n; ++k) {
+            vis[i + k] = uint8_t(((culled >> k) & 1) ^ 1);
+            visible += vis[i + k];
+        }
+    }
+#elif defined(FRUSTUM_SSE)
+    for (uint32_t i = 0; i < count; i += 4) {
+        __m128 out = _mm_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const glm::vec4& pl = f.planes[p];
+            __m128 d = _mm_set1_ps(pl.w);
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(pl.x), _mm_loadu_ps(px[p] + i)));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(pl.y), _mm_loadu_ps(py[p] + i)));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(pl.z), _mm_loadu_ps(pz[p] + i)));
+            out = _mm_or_ps(out, _mm_cmplt_ps(d, _mm_setzero_ps()));
+        }
+        const int culled = _mm_movemask_ps(out);
+        const uint32_t n = count - i < 4 ? count - i : 4;
+        for (uint32_t k = 0; k < n; ++k) {
+            vis[i + k] = uint8_t(((culled >> k) & 1) ^ 1);
+            visible += vis[i + k];
+        }
+    }
+#else
+    for (uint32_t i = 0; i < count; ++i) {
+        bool in = true;
+        for (int p = 0; p < 6 && in; ++p) {
+            const glm::vec4& pl = f.planes[p];
+            in = pl.x * px[p][i] + pl.y * py[p][i] + pl.z * pz[p][i] + pl.w >= 0.0f;
+        }
+        vis[i] = in ? 1 : 0;
+        visible += vis[i];
+    }
+#endif
+    return visible;
+}
+
+const char* frustumCullIsa()
+{
+#if defined(FRUSTUM_AVX)
+    return "AVX";
+#elif defined(FRUSTUM_SSE)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
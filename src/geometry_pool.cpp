@@ -0,0 +1,171 @@
+#include "geometry_pool.hpp"
+#include <algorithm>
+#include <cstdio>
+
+void GeometryPool::init(GpuHeap& h, VkDeviceSize pageBytes, uint32_t vertexStride)
+{
+    heap = &h;
+    stride = vertexStride;
+    pageVertices = (uint32_t)std::min<VkDeviceSize>(pageBytes / vertexStride, UINT32_MAX / 2);
+    pageVertices &= ~3u;                       // cele quady
+    pageIndices = pageVertices / 4 * 6;
+    printf("[Geo] pages of %u vertices (%.1f MB) + %u indices (%.1f MB)\n",
+        pageVertices, VkDeviceSize(pageVertices) * stride / (1024.0 * 1024.0),
+        pageIndices, VkDeviceSize(pageIndices) * sizeof(uint32_t) / (1024.0 * 1024.0));
+}
+
+void GeometryPool::shutdown(VulkanContext& ctx)
+{
+    for (uint32_t p = 0; p < pages.size(); ++p)
+        if (pages[p].vbo) releasePage(ctx, p);
+    pages.clear();
+}
+
+bool GeometryPool::newPage(VulkanContext& ctx, uint32_t vertexCap, uint32_t indexCap, uint32_t& out)
+{
+    Page pg;
+    if (!heap->createBuffer(ctx, VkDeviceSize(vertexCap) * stride,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, pg.vbo, pg.vmem, true) ||
+        !heap->createBuffer(ctx, VkDeviceSize(indexCap) * sizeof(uint32_t),
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, pg.ibo, pg.imem, true)) {
+        heap->destroyBuffer(ctx, pg.vbo, pg.vmem);
+        heap->destroyBuffer(ctx, pg.ibo, pg.imem);
+        fprintf(stderr, "[Geo] cannot create page (%u vertices, %u indices)\n", vertexCap, indexCap);
+        return false;
+    }
+    pg.vertices.init(vertexCap);
+    pg.indices.init(indexCap);
+
+    out = (uint32_t)pages.size();
+    for (uint32_t p = 0; p < pages.size(); ++p)
+        if (!pages[p].vbo) { out = p; break; }
+    if (out == pages.size()) pages.emplace_back();
+    pages[out] = std::move(pg);
+    return true;
+}
+
+void GeometryPool::releasePage(VulkanContext& ctx, uint32_t p)
+{
+    heap->destroyBuffer(ctx, pages[p].vbo, pages[p].vmem);
+    heap->destroyBuffer(ctx, pages[p].ibo, pages[p].imem);
+    pages[p] = Page{};
+}
+
+bool GeometryPool::allocIn(uint32_t p, uint32_t vertices, uint32_t indices, GeoAlloc& out)
+{
+    Page& pg = pages[p];
+    uint64_t vOff = 0, iOff = 0;
+    const uint32_t vn = pg.vertices.alloc(std::max(vertices, 1u), 1, vOff);
+    if (vn == TlsfAllocator::NONE) return false;
+    const uint32_t in = pg.indices.alloc(std::max(indices, 1u), 1, iOff);
+    if (in == TlsfAllocator::NONE) { pg.vertices.free(vn); return false; }
+    out.page = p;
+    out.vertexNode = vn; out.firstVertex = (uint32_t)vOff; out.vertexCount = vertices;
+    out.indexNode = in;  out.firstIndex = (uint32_t)iOff;  out.indexCount = indices;
+    return true;
+}
+
+bool GeometryPool::alloc(VulkanContext& ctx, uint32_t vertices, uint32_t indices, GeoAlloc& out)
+{
+    // najplnsie stranky najprv => riedke sa vyprazdnia
+    static thread_local std::vector<uint32_t> order;
+    order.clear();
+    for (uint32_t p = 0; p < pages.size(); ++p)
+        if (pages[p].vbo && !pages[p].draining) order.push_back(p);
+    std::sort(order.begin(), order.end(),
+        [&](uint32_t a, uint32_t b) { return pages[a].vertices.used() > pages[b].vertices.used(); });
+    for (uint32_t p : order)
+        if (allocIn(p, vertices, indices, out)) return true;
+
+    // nova stranka; do vyprazdnovanej len ked ani ta nejde (inak by sa chunky presuvali dookola)
+    uint32_t p = 0;
+    if (newPage(ctx, std::max(vertices, pageVertices), std::max(indices, pageIndices), p))
+        return allocIn(p, vertices, indices, out);
+    for (p = 0; p < pages.size(); ++p) {
+        if (!pages[p].vbo || !pages[p].draining) continue;
+        if (allocIn(p, vertices, indices, out)) {
+            compactBlocked = true;   // compaction teraz nema kam, dalsi pokus az po nejakom free
+            for (Page& pg : pages) pg.draining = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+void GeometryPool::free(VulkanContext& ctx, GeoAlloc& a)
+{
+    if (!a) return;
+    Page& pg = pages[a.page];
+    pg.vertices.free(a.vertexNode);
+    pg.indices.free(a.indexNode);
+    compactBlocked = false;
+    if (pg.vertices.empty()) {
+        // jednu prazdnu stranku nechaj ako rezervu
+        bool spare = false;
+        for (uint32_t p = 0; p < pages.size() && !spare; ++p)
+            spare = p != a.page && pages[p].vbo && pages[p].vertices.empty();
+        if (pg.draining || spare) releasePage(ctx, a.page);
+    }
+    a = GeoAlloc{};
+}
+
+void GeometryPool::updateCompaction()
+{
+    // stranky v bloku, ktory chce GpuHeap uvolnit
+    if (compactBlocked) return;
+    heap->updateCompaction();
+    bool any = false;
+    for (Page& pg : pages) {
+        if (!pg.vbo) continue;
+        if (heap->shouldRelocate(pg.vmem) || heap->shouldRelocate(pg.imem)) pg.draining = true;
+        any |= pg.draining;
+    }
+    if (any) return;
+
+    uint32_t best = TlsfAllocator::NONE;
+    for (uint32_t p = 0; p < pages.size(); ++p) {
+        const Page& pg = pages[p];
+        if (!pg.vbo || pg.vertices.empty()) continue;
+        if (best == TlsfAllocator::NONE || pg.vertices.used() < pages[best].vertices.used()) best = p;
+    }
+    if (best == TlsfAllocator::NONE) return;
+    const Page& src = pages[best];
+    if (src.vertices.used() * 4 > src.vertices.capacity()) return;   // aspon na 3/4 prazdna
+
+    // obsah sa musi zmestit do najvacsich dier ostatnych stranok (drobne chunk nepojmu)
+    // a aj potom ma ostat aspon stranka volneho miesta, inak by dalsi load hned pridal novu
+    uint64_t vHoles = 0, iHoles = 0, vFree = 0;
+    for (uint32_t p = 0; p < pages.size(); ++p) {
+        if (p == best || !pages[p].vbo) continue;
+        vHoles += pages[p].vertices.largestFree();
+        iHoles += pages[p].indices.largestFree();
+        vFree += pages[p].vertices.capacity() - pages[p].vertices.used();
+    }
+    const uint64_t vNeed = src.vertices.used(), iNeed = src.indices.used();
+    if (vHoles < vNeed + vNeed / 2 || iHoles < iNeed + iNeed / 2 || vFree < vNeed + pageVertices) return;
+
+    pages[best].draining = true;
+    printf("[Geo] compacting page %u (%u chunks, %.1f MB)\n", best, src.vertices.allocations(),
+        VkDeviceSize(vNeed) * stride / (1024.0 * 1024.0));
+}
+
+GeometryPoolStats GeometryPool::stats() const
+{
+    GeometryPoolStats s;
+    uint64_t largest = 0;
+    for (const Page& pg : pages) {
+        if (!pg.vbo) continue;
+        ++s.pages;
+        s.ranges += pg.vertices.allocations();
+        s.vertexUsed += pg.vertices.used() * stride;
+        s.vertexCap += pg.vertices.capacity() * stride;
+        s.indexUsed += pg.indices.used() * sizeof(uint32_t);
+        s.indexCap += pg.indices.capacity() * sizeof(uint32_t);
+        largest = std::max(largest, pg.vertices.largestFree() * stride);
+        if (pg.draining) ++s.draining;
+    }
+    const uint64_t freeBytes = s.vertexCap - s.vertexUsed;
+    s.fragmentation = freeBytes ? 1.0f - float(largest) / float(freeBytes) : 0.0f;
+    s.relocated = relocatedCount;
+    return s;
+}
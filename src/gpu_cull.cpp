@@ -0,0 +1,413 @@
+#include "gpu_cull.hpp"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+// UBO View v cull.comp (std140)
+struct CullView {
+    glm::vec4 planes[6];
+    glm::vec4 camPos;
+    glm::mat4 viewProj;
+    int32_t   hizInfo[4];    // x = pocet urovni Hi-Z
+    float     viewport[4];   // xy = rozlisenie hlbky
+};
+static_assert(sizeof(CullView) == 208, "std140 layout View v cull.comp");
+
+// push konstanty cull.comp
+struct CullPush {
+    uint32_t recordCount;
+    uint32_t phase;
+    uint32_t drawBase;     // prvy prikaz sady (late = druha polovica drawBuf)
+    uint32_t countBase;    // prvy pocet sady
+    uint32_t statsBase;    // tested, occluded
+};
+
+static constexpr uint32_t CULL_GROUP = 64;   // local_size_x v cull.comp
+static constexpr uint32_t CULL_BINDINGS = 6;
+
+bool GpuCuller::init(VulkanContext& ctx, const std::string& shaderDir)
+{
+    if (!ctx.drawIndirectCount || !ctx.multiDrawIndirect) {
+        printf("[GpuCull] off: drawIndirectCount %s, multiDrawIndirect %s\n",
+            ctx.drawIndirectCount ? "yes" : "no", ctx.multiDrawIndirect ? "yes" : "no");
+        return false;
+    }
+    // dispatch ide do toho isteho command buffera ako render pass
+    uint32_t famCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &famCount, nullptr);
+    std::vector<VkQueueFamilyProperties> fams(famCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &famCount, fams.data());
+    if (ctx.graphicsQueueFamily >= famCount || !(fams[ctx.graphicsQueueFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        printf("[GpuCull] off: graphics queue has no compute\n");
+        return false;
+    }
+
+    std::vector<char> code;
+    try { code = readFile(shaderDir + "/cull.comp.spv"); }
+    catch (const std::exception& e) {
+        printf("[GpuCull] off: %s\n", e.what());
+        return false;
+    }
+
+    // 0 zaznamy, 1 prikazy, 2 pocty, 3 vis, 4 Hi-Z, 5 pohlad
+    VkDescriptorSetLayoutBinding b[CULL_BINDINGS]{};
+    for (uint32_t i = 0; i < CULL_BINDINGS; ++i) {
+        b[i].binding = i;
+        b[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        b[i].descriptorCount = 1;
+        b[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    b[4].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    b[5].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    VkDescriptorSetLayoutCreateInfo lci{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    lci.bindingCount = CULL_BINDINGS;
+    lci.pBindings = b;
+    VK_CHECK_RET(vkCreateDescriptorSetLayout(ctx.device, &lci, nullptr, &setLayout));
+
+    // jeden set na slot framu v lete
+    VkDescriptorPoolSize ps[3] = {
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * MAX_FRAMES_IN_FLIGHT },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_FRAMES_IN_FLIGHT },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT } };
+    VkDescriptorPoolCreateInfo dp{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    dp.maxSets = MAX_FRAMES_IN_FLIGHT;
+    dp.poolSizeCount = 3;
+    dp.pPoolSizes = ps;
+    VK_CHECK_RET(vkCreateDescriptorPool(ctx.device, &dp, nullptr, &descPool));
+
+    for (Frame& f : frames) {
+        VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        ai.descriptorPool = descPool;
+        ai.descriptorSetCount = 1;
+        ai.pSetLayouts = &setLayout;
+        VK_CHECK_RET(vkAllocateDescriptorSets(ctx.device, &ai, &f.descSet));
+    }
+
+    VkPushConstantRange pcr{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPush) };
+    VkPipelineLayoutCreateInfo plci{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    plci.setLayoutCount = 1;
+    plci.pSetLayouts = &setLayout;
+    plci.pushConstantRangeCount = 1;
+    plci.pPushConstantRanges = &pcr;
+    VK_CHECK_RET(vkCreatePipelineLayout(ctx.device, &plci, nullptr, &layout));
+
+    // pohlad (UBO) zije s cullerom (jeden na slot), buffery zaznamov rastu v grow()
+    for (Frame& f : frames) {
+        if (!createBuffer(ctx, sizeof(CullView), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, f.viewBuf, f.viewMem) ||
+            vkMapMemory(ctx.device, f.viewMem, 0, VK_WHOLE_SIZE, 0, &f.viewPtr) != VK_SUCCESS) {
+            fprintf(stderr, "[GpuCull] view UBO failed\n");
+            return false;
+        }
+        std::memset(f.viewPtr, 0, sizeof(CullView));
+        VkDescriptorBufferInfo vi{ f.viewBuf, 0, sizeof(CullView) };
+        VkWriteDescriptorSet vw{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        vw.dstSet = f.descSet;
+        vw.dstBinding = 5;
+        vw.descriptorCount = 1;
+        vw.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        vw.pBufferInfo = &vi;
+        vkUpdateDescriptorSets(ctx.device, 1, &vw, 0, nullptr);
+    }
+    if (!createPlaceholder(ctx)) return false;
+
+    VkShaderModule mod = createShaderModule(ctx.device, code);
+    VkComputePipelineCreateInfo ci{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    ci.stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    ci.stage.module = mod;
+    ci.stage.pName = "main";
+    ci.layout = layout;
+    const VkResult r = vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &ci, nullptr, &pipeline);
+    vkDestroyShaderModule(ctx.device, mod, nullptr);
+    if (r != VK_SUCCESS) {
+        fprintf(stderr, "[GpuCull] vkCreateComputePipelines failed (%d)\n", (int)r);
+        pipeline = VK_NULL_HANDLE;
+        return false;
+    }
+    if (!grow(ctx, 1024, 16)) {
+        vkDestroyPipeline(ctx.device, pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
+        return false;
+    }
+    printf("[GpuCull] compute frustum + Hi-Z culling ready (vkCmdDrawIndexedIndirectCount)\n");
+    return true;
+}
+
+// binding 4 musi byt platny aj bez Hi-Z (shader ho staticky pouziva)
+bool GpuCuller::createPlaceholder(VulkanContext& ctx)
+{
+    VkSamplerCreateInfo si{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    si.magFilter = VK_FILTER_NEAREST;
+    si.minFilter = VK_FILTER_NEAREST;
+    si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    si.addressModeU = si.addressModeV = si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    si.maxLod = VK_LOD_CLAMP_NONE;
+    VK_CHECK_RET(vkCreateSampler(ctx.device, &si, nullptr, &sampler));
+
+    if (!createImage(ctx, 1, 1, VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, placeholder, placeholderMem)) {
+        fprintf(stderr, "[GpuCull] placeholder image failed\n");
+        return false;
+    }
+    VkImageViewCreateInfo iv{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    iv.image = placeholder;
+    iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    iv.format = VK_FORMAT_R32_SFLOAT;
+    iv.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    VK_CHECK_RET(vkCreateImageView(ctx.device, &iv, nullptr, &placeholderView));
+    transitionImageLayoutRange(ctx, placeholder, VK_FORMAT_R32_SFLOAT,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, 1);
+    for (Frame& f : frames) writeHiZDescriptor(ctx, f);
+    return true;
+}
+
+void GpuCuller::writeHiZDescriptor(VulkanContext& ctx, Frame& f)
+{
+    VkDescriptorImageInfo ii{};
+    ii.sampler = sampler;
+    ii.imageView = hizView ? hizView : placeholderView;
+    ii.imageLayout = hizView ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    f.hizBound = hizSerial;
+    VkWriteDescriptorSet w{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    w.dstSet = f.descSet;
+    w.dstBinding = 4;
+    w.descriptorCount = 1;
+    w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    w.pImageInfo = &ii;
+    vkUpdateDescriptorSets(ctx.device, 1, &w, 0, nullptr);
+}
+
+void GpuCuller::setHiZ(VkImageView view, uint32_t levels, uint32_t depthWidth, uint32_t depthHeight)
+{
+    hizLevels = view ? levels : 0;
+    depthW = depthWidth;
+    depthH = depthHeight;
+    hizView = view;   // sloty si descriptor prepisu v prepare
+    ++hizSerial;
+}
+
+void GpuCuller::destroyBuffers(VulkanContext& ctx)
+{
+    for (Frame& f : frames) {
+        if (f.recMem && f.recPtr) vkUnmapMemory(ctx.device, f.recMem);
+        if (f.countMem && f.countPtr) vkUnmapMemory(ctx.device, f.countMem);
+        f.recPtr = nullptr;
+        f.countPtr = nullptr;
+        for (VkBuffer* b : { &f.recBuf, &f.drawBuf, &f.countBuf })
+            if (*b) { vkDestroyBuffer(ctx.device, *b, nullptr); *b = VK_NULL_HANDLE; }
+        for (VkDeviceMemory* m : { &f.recMem, &f.drawMem, &f.countMem })
+            if (*m) { vkFreeMemory(ctx.device, *m, nullptr); *m = VK_NULL_HANDLE; }
+        f.recVersion = 0;
+        f.countsValid = false;
+    }
+    if (visBuf) { vkDestroyBuffer(ctx.device, visBuf, nullptr); visBuf = VK_NULL_HANDLE; }
+    if (visMem) { vkFreeMemory(ctx.device, visMem, nullptr); visMem = VK_NULL_HANDLE; }
+    recCap = pageCap = 0;
+}
+
+void GpuCuller::shutdown(VulkanContext& ctx)
+{
+    destroyBuffers(ctx);
+    for (Frame& f : frames) {
+        if (f.viewMem && f.viewPtr) vkUnmapMemory(ctx.device, f.viewMem);
+        if (f.viewBuf) vkDestroyBuffer(ctx.device, f.viewBuf, nullptr);
+        if (f.viewMem) vkFreeMemory(ctx.device, f.viewMem, nullptr);
+        f = Frame{};   // descSet uvolni pool nizsie
+    }
+    cur = &frames[0];
+    if (placeholderView) vkDestroyImageView(ctx.device, placeholderView, nullptr);
+    if (placeholder) vkDestroyImage(ctx.device, placeholder, nullptr);
+    if (placeholderMem) vkFreeMemory(ctx.device, placeholderMem, nullptr);
+    if (sampler) vkDestroySampler(ctx.device, sampler, nullptr);
+    if (pipeline) vkDestroyPipeline(ctx.device, pipeline, nullptr);
+    if (layout) vkDestroyPipelineLayout(ctx.device, layout, nullptr);
+    if (descPool) vkDestroyDescriptorPool(ctx.device, descPool, nullptr);   // uvolni aj sety slotov
+    if (setLayout) vkDestroyDescriptorSetLayout(ctx.device, setLayout, nullptr);
+    placeholderView = VK_NULL_HANDLE;
+    placeholder = VK_NULL_HANDLE;
+    placeholderMem = VK_NULL_HANDLE;
+    sampler = VK_NULL_HANDLE;
+    hizView = VK_NULL_HANDLE;
+    hizLevels = 0;
+    pipeline = VK_NULL_HANDLE;
+    layout = VK_NULL_HANDLE;
+    descPool = VK_NULL_HANDLE;
+    setLayout = VK_NULL_HANDLE;
+    st = {};
+}
+
+// rast je zriedkavy (zdvojnasobenie): pocka sa na vsetky framy v lete, potom sa buffery
+// vsetkych slotov (aj spolocny vis) nahradia hned
+bool GpuCuller::grow(VulkanContext& ctx, uint32_t newRecCap, uint32_t newPageCap)
+{
+    waitFramesInFlight(ctx);
+    destroyBuffers(ctx);
+    const VkMemoryPropertyFlags host = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    const VkDeviceSize recBytes = VkDeviceSize(newRecCap) * sizeof(GpuCullRecord);
+    // dve sady prikazov aj poctov: early/all a late
+    const VkDeviceSize drawBytes = 2 * VkDeviceSize(newRecCap) * GPU_CULL_DRAWS_PER_RECORD * sizeof(VkDrawIndexedIndirectCommand);
+    const VkDeviceSize countBytes = (2 * VkDeviceSize(newPageCap) + 2) * sizeof(uint32_t);
+    const VkDeviceSize visBytes = VkDeviceSize(newRecCap) * sizeof(uint32_t);
+    if (!createBuffer(ctx, visBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, visBuf, visMem)) {
+        fprintf(stderr, "[GpuCull] buffers for %u records failed\n", newRecCap);
+        destroyBuffers(ctx);
+        return false;
+    }
+    for (Frame& f : frames) {
+        void* p = nullptr;
+        if (!createBuffer(ctx, recBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, host, f.recBuf, f.recMem) ||
+            !createBuffer(ctx, drawBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, f.drawBuf, f.drawMem) ||
+            !createBuffer(ctx, countBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT, host, f.countBuf, f.countMem) ||
+            vkMapMemory(ctx.device, f.recMem, 0, VK_WHOLE_SIZE, 0, &p) != VK_SUCCESS) {
+            fprintf(stderr, "[GpuCull] buffers for %u records failed\n", newRecCap);
+            destroyBuffers(ctx);
+            return false;
+        }
+        f.recPtr = static_cast<GpuCullRecord*>(p);
+        if (vkMapMemory(ctx.device, f.countMem, 0, VK_WHOLE_SIZE, 0, &p) != VK_SUCCESS) { destroyBuffers(ctx); return false; }
+        f.countPtr = static_cast<uint32_t*>(p);
+
+        VkDescriptorBufferInfo infos[4] = {
+            { f.recBuf, 0, VK_WHOLE_SIZE }, { f.drawBuf, 0, VK_WHOLE_SIZE }, { f.countBuf, 0, VK_WHOLE_SIZE },
+            { visBuf, 0, VK_WHOLE_SIZE } };
+        VkWriteDescriptorSet w[4]{};
+        for (uint32_t i = 0; i < 4; ++i) {
+            w[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[i].dstSet = f.descSet;
+            w[i].dstBinding = i;
+            w[i].descriptorCount = 1;
+            w[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[i].pBufferInfo = &infos[i];
+        }
+        vkUpdateDescriptorSets(ctx.device, 4, w, 0, nullptr);
+    }
+    recCap = newRecCap;
+    pageCap = newPageCap;
+    visReset = true;
+    return true;
+}
+
+bool GpuCuller::prepare(VulkanContext& ctx, const GpuCullRecord* recs, uint32_t n, uint32_t pages, bool changed)
+{
+    if (!pipeline) return false;
+    cur = &frames[ctx.currentFrame % MAX_FRAMES_IN_FLIGHT];
+
+    // pocty z minuleho dispatchu slotu (jeho fence uz presla)
+    if (cur->countsValid) {
+        const uint32_t* c = cur->countPtr;
+        st.draws = st.lateDraws = st.tested = st.occluded = 0;
+        for (uint32_t i = 0; i < cur->countPages; ++i) st.draws += c[i];
+        if (cur->late) {
+            for (uint32_t i = 0; i < cur->countPages; ++i) st.lateDraws += c[pageCap + i];
+            st.draws += st.lateDraws;
+            st.tested = c[2 * pageCap];
+            st.occluded = c[2 * pageCap + 1];
+        }
+    }
+
+    if (n > recCap || pages > pageCap) {
+        uint32_t rc = std::max(recCap, 1024u), pc = std::max(pageCap, 16u);
+        while (rc < n) rc *= 2;
+        while (pc < pages) pc *= 2;
+        if (!grow(ctx, rc, pc)) return false;
+    }
+    // indexy zaznamov sa posunuli => vis neplati; jeden frame ide vsetko vo frustum early
+    if (changed) {
+        ++recVersion;
+        visReset = true;
+    }
+    // ostatne sloty si nove zaznamy skopiruju, az na ne pride rad
+    if (cur->recVersion != recVersion) {
+        if (n) std::memcpy(cur->recPtr, recs, size_t(n) * sizeof(GpuCullRecord));
+        cur->recVersion = recVersion;
+        ++st.uploads;
+    }
+    if (cur->hizBound != hizSerial) writeHiZDescriptor(ctx, *cur);
+    recCount = n;
+    pageCount = pages;
+    st.records = n;
+    st.pages = pages;
+    return true;
+}
+
+void GpuCuller::setView(const Frustum& f, const glm::mat4& viewProj, const glm::vec3& camPos)
+{
+    if (!cur->viewPtr) return;
+    CullView v{};
+    for (int i = 0; i < 6; ++i) v.planes[i] = f.planes[i];
+    v.camPos = glm::vec4(camPos, 0.0f);
+    v.viewProj = viewProj;
+    v.hizInfo[0] = (int32_t)hizLevels;
+    v.viewport[0] = (float)depthW;
+    v.viewport[1] = (float)depthH;
+    std::memcpy(cur->viewPtr, &v, sizeof(v));
+}
+
+void GpuCuller::record(VkCommandBuffer cb, GpuCullPhase phase)
+{
+    if (pageCount == 0) return;
+    const bool late = phase == GpuCullPhase::Late;
+    VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    if (!late) {
+        // vis zapisal dispatch predosleho framu (iny submit, moze este bezat)
+        mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &mb, 0, nullptr, 0, nullptr);
+        vkCmdFillBuffer(cb, cur->countBuf, 0, VK_WHOLE_SIZE, 0);   // obe sady + statistiky
+        if (visReset) {
+            vkCmdFillBuffer(cb, visBuf, 0, VK_WHOLE_SIZE, 1);
+            visReset = false;
+        }
+        mb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &mb, 0, nullptr, 0, nullptr);
+    }
+    else {
+        // vis z early dispatchu (Hi-Z ma vlastnu barieru v HiZPyramid::build)
+        mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 1, &mb, 0, nullptr, 0, nullptr);
+    }
+
+    if (recCount) {
+        CullPush pc{};
+        pc.recordCount = recCount;
+        pc.phase = (uint32_t)phase;
+        pc.drawBase = late ? recCap * GPU_CULL_DRAWS_PER_RECORD : 0;
+        pc.countBase = late ? pageCap : 0;
+        pc.statsBase = 2 * pageCap;
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &cur->descSet, 0, nullptr);
+        vkCmdPushConstants(cb, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+        vkCmdDispatch(cb, (recCount + CULL_GROUP - 1) / CULL_GROUP, 1, 1);
+    }
+
+    // prikazy a pocty cita vertex input; pocty po fence aj CPU (stats)
+    mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    mb.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &mb, 0, nullptr, 0, nullptr);
+    cur->countsValid = true;
+    cur->countPages = pageCount;
+    cur->late = late;
+}
+
+void GpuCuller::drawPage(VkCommandBuffer cb, GpuCullPhase phase, uint32_t page, uint32_t outBase, uint32_t maxDraws) const
+{
+    if (page >= pageCount || maxDraws == 0) return;
+    const bool late = phase == GpuCullPhase::Late;
+    const uint32_t drawBase = late ? recCap * GPU_CULL_DRAWS_PER_RECORD : 0;
+    const uint32_t countBase = late ? pageCap : 0;
+    vkCmdDrawIndexedIndirectCount(cb,
+        cur->drawBuf, VkDeviceSize(drawBase + outBase) * sizeof(VkDrawIndexedIndirectCommand),
+        cur->countBuf, VkDeviceSize(countBase + page) * sizeof(uint32_t),
+        maxDraws, sizeof(VkDrawIndexedIndirectCommand));
+}
@@ -0,0 +1,380 @@
+#include "gpu_heap.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+static uint64_t alignUp64(uint64_t v, uint64_t a) { return (v + a - 1) & ~(a - 1); }
+
+// ---------------- TlsfAllocator ----------------
+
+void TlsfAllocator::mapping(uint64_t size, int& fl, int& sl)
+{
+    if (size < (uint64_t)SL_COUNT) { fl = 0; sl = (int)size; return; }
+    const int m = 63 - std::countl_zero(size);
+    fl = m - SL_BITS + 1;
+    sl = (int)((size >> (m - SL_BITS)) - SL_COUNT);
+}
+
+void TlsfAllocator::init(uint64_t capacity)
+{
+    nodes.clear();
+    unusedNodes.clear();
+    for (auto& row : heads) for (auto& h : row) h = NONE;
+    flBits = 0;
+    for (auto& b : slBits) b = 0;
+    cap = capacity;
+    usedBytes = 0;
+    liveAllocs = 0;
+    freeCount = 0;
+    if (capacity == 0) return;
+    const uint32_t n = newNode();
+    nodes[n].size = capacity;
+    nodes[n].free = true;
+    insertFree(n);
+}
+
+uint32_t TlsfAllocator::newNode()
+{
+    if (!unusedNodes.empty()) {
+        const uint32_t n = unusedNodes.back();
+        unusedNodes.pop_back();
+        nodes[n] = Node{};
+        return n;
+    }
+    nodes.emplace_back();
+    return (uint32_t)nodes.size() - 1;
+}
+
+void TlsfAllocator::insertFree(uint32_t n)
+{
+    int fl, sl;
+    mapping(nodes[n].size, fl, sl);
+    nodes[n].prevFree = NONE;
+    nodes[n].nextFree = heads[fl][sl];
+    if (heads[fl][sl] != NONE) nodes[heads[fl][sl]].prevFree = n;
+    heads[fl][sl] = n;
+    flBits |= 1ull << fl;
+    slBits[fl] |= 1u << sl;
+    ++freeCount;
+}
+
+void TlsfAllocator::removeFree(uint32_t n)
+{
+    int fl, sl;
+    mapping(nodes[n].size, fl, sl);
+    const uint32_t p = nodes[n].prevFree, x = nodes[n].nextFree;
+    if (p != NONE) nodes[p].nextFree = x;
+    if (x != NONE) nodes[x].prevFree = p;
+    if (heads[fl][sl] == n) {
+        heads[fl][sl] = x;
+        if (x == NONE) {
+            slBits[fl] &= ~(1u << sl);
+            if (!slBits[fl]) flBits &= ~(1ull << fl);
+        }
+    }
+    nodes[n].prevFree = nodes[n].nextFree = NONE;
+    --freeCount;
+}
+
+// prvy kus z triedy, kde je kazdy kus >= size (good fit, ziadne prechadzanie zoznamu)
+uint32_t TlsfAllocator::findFree(uint64_t size) const
+{
+    if (size >= (uint64_t)SL_COUNT) {
+        const int m = 63 - std::countl_zero(size);
+        size += (1ull << (m - SL_BITS)) - 1;
+        if (size < (1ull << m)) return NONE;   // pretecenie
+    }
+    int fl, sl;
+    mapping(size, fl, sl);
+    if (fl >= FL_COUNT) return NONE;
+    uint32_t slMap = slBits[fl] & (~0u << sl);
+    if (!slMap) {
+        const uint64_t flMap = (fl + 1 < 64) ? (flBits & (~0ull << (fl + 1))) : 0;
+        if (!flMap) return NONE;
+        fl = std::countr_zero(flMap);
+        slMap = slBits[fl];
+    }
+    sl = std::countr_zero(slMap);
+    return heads[fl][sl];
+}
+
+uint32_t TlsfAllocator::alloc(uint64_t size, uint64_t align, uint64_t& offset)
+{
+    if (size == 0) size = 1;
+    if (align == 0) align = 1;
+    // najhorsi pripad zarovnania; zvysok sa hned vrati ako volny kus
+    const uint32_t n = findFree(size + align - 1);
+    if (n == NONE) return NONE;
+    removeFree(n);
+
+    const uint64_t aligned = alignUp64(nodes[n].offset, align);
+    if (const uint64_t pad = aligned - nodes[n].offset) {
+        // predosly fyzicky sused nie je volny (inak by bol spojeny), netreba spajat
+        const uint32_t p = newNode();
+        nodes[p].offset = nodes[n].offset;
+        nodes[p].size = pad;
+        nodes[p].free = true;
+        nodes[p].prevPhys = nodes[n].prevPhys;
+        nodes[p].nextPhys = n;
+        if (nodes[p].prevPhys != NONE) nodes[nodes[p].prevPhys].nextPhys = p;
+        nodes[n].prevPhys = p;
+        nodes[n].offset = aligned;
+        nodes[n].size -= pad;
+        insertFree(p);
+    }
+    if (nodes[n].size > size) {
+        const uint32_t r = newNode();
+        nodes[r].offset = aligned + size;
+        nodes[r].size = nodes[n].size - size;
+        nodes[r].free = true;
+        nodes[r].prevPhys = n;
+        nodes[r].nextPhys = nodes[n].nextPhys;
+        if (nodes[r].nextPhys != NONE) nodes[nodes[r].nextPhys].prevPhys = r;
+        nodes[n].nextPhys = r;
+        nodes[n].size = size;
+        insertFree(r);
+    }
+    nodes[n].free = false;
+    usedBytes += size;
+    ++liveAllocs;
+    offset = aligned;
+    return n;
+}
+
+void TlsfAllocator::free(uint32_t n)
+{
+    if (n == NONE || n >= nodes.size() || nodes[n].free) return;
+    usedBytes -= nodes[n].size;
+    --liveAllocs;
+    nodes[n].free = true;
+
+    const uint32_t p = nodes[n].prevPhys;
+    if (p != NONE && nodes[p].free) {
+        removeFree(p);
+        nodes[p].size += nodes[n].size;
+        nodes[p].nextPhys = nodes[n].nextPhys;
+        if (nodes[p].nextPhys != NONE) nodes[nodes[p].nextPhys].prevPhys = p;
+        unusedNodes.push_back(n);
+        n = p;
+    }
+    const uint32_t x = nodes[n].nextPhys;
+    if (x != NONE && nodes[x].free) {
+        removeFree(x);
+        nodes[n].size += nodes[x].size;
+        nodes[n].nextPhys = nodes[x].nextPhys;
+        if (nodes[n].nextPhys != NONE) nodes[nodes[n].nextPhys].prevPhys = n;
+        unusedNodes.push_back(x);
+    }
+    insertFree(n);
+}
+
+uint64_t TlsfAllocator::largestFree() const
+{
+    if (!flBits) return 0;
+    const int fl = 63 - std::countl_zero(flBits);
+    const int sl = 31 - std::countl_zero(slBits[fl]);
+    uint64_t best = 0;
+    for (uint32_t n = heads[fl][sl]; n != NONE; n = nodes[n].nextFree)
+        best = std::max(best, nodes[n].size);
+    return best;
+}
+
+// ---------------- GpuHeap ----------------
+
+void GpuHeap::init(VulkanContext& ctx, VkDeviceSize blockBytes)
+{
+    blockSize = blockBytes;
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &props);
+    maxAllocs = props.limits.maxMemoryAllocationCount;
+    printf("[GpuHeap] %.0f MB blocks (device allows %u allocations)\n", blockSize / (1024.0 * 1024.0), maxAllocs);
+}
+
+void GpuHeap::shutdown(VulkanContext& ctx)
+{
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+        if (blocks[b].memory) releaseBlock(ctx, b);
+    blocks.clear();
+    drainBlock = TlsfAllocator::NONE;
+}
+
+bool GpuHeap::newBlock(VulkanContext& ctx, uint32_t memoryType, VkDeviceSize size, bool dedicated, uint32_t& out)
+{
+    if (maxAllocs && liveBlocks >= maxAllocs) {
+        fprintf(stderr, "[GpuHeap] maxMemoryAllocationCount (%u) reached\n", maxAllocs);
+        return false;
+    }
+    VkMemoryAllocateInfo ai{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    ai.allocationSize = size;
+    ai.memoryTypeIndex = memoryType;
+    VkDeviceMemory mem = VK_NULL_HANDLE;
+    if (vkAllocateMemory(ctx.device, &ai, nullptr, &mem) != VK_SUCCESS) {
+        fprintf(stderr, "[GpuHeap] vkAllocateMemory(%.1f MB) failed\n", size / (1024.0 * 1024.0));
+        return false;
+    }
+    out = (uint32_t)blocks.size();
+    for (uint32_t b = 0; b < blocks.size(); ++b)
+        if (!blocks[b].memory) { out = b; break; }
+    if (out == blocks.size()) blocks.emplace_back();
+    Block& bl = blocks[out];
+    bl.memory = mem;
+    bl.memoryType = memoryType;
+    bl.dedicated = dedicated;
+    bl.tlsf.init(size);
+    ++liveBlocks;
+    return true;
+}
+
+void GpuHeap::releaseBlock(VulkanContext& ctx, uint32_t b)
+{
+    vkFreeMemory(ctx.device, blocks[b].memory, nullptr);
+    blocks[b] = Block{};
+    --liveBlocks;
+    if (drainBlock == b) drainBlock = TlsfAllocator::NONE;
+}
+
+bool GpuHeap::alloc(VulkanContext& ctx, const VkMemoryRequirements& req, VkMemoryPropertyFlags props, GpuAlloc& out)
+{
+    const uint32_t type = findMemoryType(ctx.physicalDevice, req.memoryTypeBits, props);
+    uint32_t b = TlsfAllocator::NONE;
+    uint64_t off = 0;
+    uint32_t node = TlsfAllocator::NONE;
+
+    if (req.size > blockSize / 2) {
+        // velky kus by blok len rozbil: vlastna alokacia, uvolni sa s nim
+        if (!newBlock(ctx, type, req.size, true, b)) return false;
+        node = blocks[b].tlsf.alloc(req.size, req.alignment, off);
+    }
+    else {
+        // najplnsie bloky najprv => prazdnejsie sa mozu uvolnit
+        static thread_local std::vector<uint32_t> order;
+        order.clear();
+        for (uint32_t i = 0; i < blocks.size(); ++i) {
+            const Block& bl = blocks[i];
+            if (bl.memory && !bl.dedicated && bl.memoryType == type && i != drainBlock) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t c) { return blocks[a].tlsf.used() > blocks[c].tlsf.used(); });
+        for (uint32_t i : order) {
+            node = blocks[i].tlsf.alloc(req.size, req.alignment, off);
+            if (node != TlsfAllocator::NONE) { b = i; break; }
+        }
+        if (node == TlsfAllocator::NONE && newBlock(ctx, type, blockSize, false, b))
+            node = blocks[b].tlsf.alloc(req.size, req.alignment, off);
+        // do vyprazdnovaneho bloku len ked novy nejde (inak by sa obsah presuval dookola)
+        if (node == TlsfAllocator::NONE && drainBlock != TlsfAllocator::NONE && blocks[drainBlock].memoryType == type) {
+            node = blocks[drainBlock].tlsf.alloc(req.size, req.alignment, off);
+            if (node != TlsfAllocator::NONE) {
+                b = drainBlock;
+                drainBlock = TlsfAllocator::NONE;
+                compactBlocked = true;   // compaction teraz nema kam, dalsi pokus az po nejakom free
+            }
+        }
+    }
+    if (node == TlsfAllocator::NONE) return false;
+
+    out.memory = blocks[b].memory;
+    out.offset = off;
+    out.size = req.size;
+    out.block = b;
+    out.node = node;
+    return true;
+}
+
+void GpuHeap::free(VulkanContext& ctx, GpuAlloc& a)
+{
+    if (!a) return;
+    Block& bl = blocks[a.block];
+    bl.tlsf.free(a.node);
+    compactBlocked = false;
+    if (bl.tlsf.empty()) {
+        // jeden prazdny blok nechaj ako rezervu (chunk na hranici by inak alokoval/uvolnoval dookola)
+        bool spare = false;
+        for (uint32_t i = 0; i < blocks.size() && !spare; ++i)
+            spare = i != a.block && blocks[i].memory && !blocks[i].dedicated &&
+                    blocks[i].memoryType == bl.memoryType && blocks[i].tlsf.empty();
+        if (bl.dedicated || a.block == drainBlock || spare) releaseBlock(ctx, a.block);
+    }
+    a = GpuAlloc{};
+}
+
+bool GpuHeap::createBuffer(VulkanContext& ctx, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkBuffer& buf, GpuAlloc& a, bool sharedWithTransfer)
+{
+    VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bi.size = size;
+    bi.usage = usage;
+    bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    const uint32_t families[2] = { ctx.graphicsQueueFamily, ctx.transferQueueFamily };
+    if (sharedWithTransfer && families[0] != families[1]) {
+        bi.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bi.queueFamilyIndexCount = 2;
+        bi.pQueueFamilyIndices = families;
+    }
+    if (vkCreateBuffer(ctx.device, &bi, nullptr, &buf) != VK_SUCCESS) return false;
+
+    VkMemoryRequirements req{};
+    vkGetBufferMemoryRequirements(ctx.device, buf, &req);
+    if (!alloc(ctx, req, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, a)) {
+        vkDestroyBuffer(ctx.device, buf, nullptr);
+        buf = VK_NULL_HANDLE;
+        return false;
+    }
+    vkBindBufferMemory(ctx.device, buf, a.memory, a.offset);
+    return true;
+}
+
+void GpuHeap::destroyBuffer(VulkanContext& ctx, VkBuffer& buf, GpuAlloc& a)
+{
+    if (buf) { vkDestroyBuffer(ctx.device, buf, nullptr); buf = VK_NULL_HANDLE; }
+    free(ctx, a);
+}
+
+void GpuHeap::updateCompaction()
+{
+    if (drainBlock != TlsfAllocator::NONE || compactBlocked) return;   // drzi sa, kym sa nevyprazdni
+    uint32_t best = TlsfAllocator::NONE;
+    for (uint32_t i = 0; i < blocks.size(); ++i) {
+        const Block& bl = blocks[i];
+        if (!bl.memory || bl.dedicated || bl.tlsf.empty()) continue;
+        if (best == TlsfAllocator::NONE || bl.tlsf.used() < blocks[best].tlsf.used()) best = i;
+    }
+    if (best == TlsfAllocator::NONE) return;
+    const Block& src = blocks[best];
+    if (src.tlsf.used() * 2 > src.tlsf.capacity()) return;   // aspon do polovice prazdny
+
+    // obsah sa musi zmestit do najvacsich dier ostatnych blokov a potom ma ostat
+    // aspon blok volneho miesta (inak by dalsia alokacia hned pridala novy)
+    uint64_t holes = 0, freeElsewhere = 0;
+    for (uint32_t i = 0; i < blocks.size(); ++i) {
+        const Block& bl = blocks[i];
+        if (i == best || !bl.memory || bl.dedicated || bl.memoryType != src.memoryType) continue;
+        holes += bl.tlsf.largestFree();
+        freeElsewhere += bl.tlsf.capacity() - bl.tlsf.used();
+    }
+    const uint64_t need = src.tlsf.used();
+    if (holes < need + need / 2 || freeElsewhere < need + blockSize) return;
+
+    drainBlock = best;
+    printf("[GpuHeap] compacting block %u (%.1f MB used in %u allocations)\n",
+        best, src.tlsf.used() / (1024.0 * 1024.0), src.tlsf.allocations());
+}
+
+GpuHeapStats GpuHeap::stats() const
+{
+    GpuHeapStats s;
+    for (const Block& bl : blocks) {
+        if (!bl.memory) continue;
+        ++s.blocks;
+        if (bl.dedicated) ++s.dedicated;
+        s.allocations += bl.tlsf.allocations();
+        s.reserved += bl.tlsf.capacity();
+        s.used += bl.tlsf.used();
+        s.largestFree = std::max(s.largestFree, bl.tlsf.largestFree());
+    }
+    const uint64_t freeBytes = s.reserved - s.used;
+    s.fragmentation = freeBytes ? 1.0f - float(s.largestFree) / float(freeBytes) : 0.0f;
+    s.draining = drainBlock == TlsfAllocator::NONE ? 0 : drainBlock + 1;
+    s.maxAllocations = maxAllocs;
+    return s;
+}
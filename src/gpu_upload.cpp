@@ -0,0 +1,280 @@
+#include "gpu_upload.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static constexpr VkDeviceSize RING_ALIGN = 16;          // vertexy su float4-friendly
+static constexpr VkDeviceSize STREAM_MIN_PIECE = 64 * 1024;   // mensi kus nema zmysel posielat
+
+static VkDeviceSize alignUp(VkDeviceSize v, VkDeviceSize a) { return (v + a - 1) & ~(a - 1); }
+
+bool GpuUploader::init(VulkanContext& ctx, VkDeviceSize ringBytes)
+{
+    async = ctx.timelineSemaphores && ctx.frameTimeline;
+    queue = async ? ctx.transferQueue : ctx.graphicsQueue;
+
+    VkCommandPoolCreateInfo pi{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    pi.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pi.queueFamilyIndex = async ? ctx.transferQueueFamily : ctx.graphicsQueueFamily;
+    VK_CHECK_RET(vkCreateCommandPool(ctx.device, &pi, nullptr, &pool));
+    if (async && !createTimelineSemaphore(ctx.device, 0, ctx.uploadTimeline)) {
+        fprintf(stderr, "[Upload] timeline semaphore failed, falling back to synchronous uploads\n");
+        async = false;
+        queue = ctx.graphicsQueue;
+        vkDestroyCommandPool(ctx.device, pool, nullptr);
+        pi.queueFamilyIndex = ctx.graphicsQueueFamily;
+        VK_CHECK_RET(vkCreateCommandPool(ctx.device, &pi, nullptr, &pool));
+    }
+
+    // staging ring: jedna alokacia, namapovana po celu dobu behu
+    ringSize = alignUp(std::max<VkDeviceSize>(ringBytes, STREAM_MIN_PIECE), RING_ALIGN);
+    if (!createBuffer(ctx, ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, ring, ringMem))
+        return false;
+    VK_CHECK_RET(vkMapMemory(ctx.device, ringMem, 0, ringSize, 0, (void**)&ringPtr));
+    ringHead = ringTail = ringUsed = 0;
+
+    st.async = async;
+    st.dedicatedQueue = async && ctx.transferQueueFamily != ctx.graphicsQueueFamily;
+    st.ringCapacity = ringSize;
+    rateT0 = std::chrono::steady_clock::now();
+    printf("[Upload] %s, %s queue (family %u), staging ring %.1f MB\n", async ? "async" : "synchronous",
+        st.dedicatedQueue ? "dedicated transfer" : "graphics",
+        async ? ctx.transferQueueFamily : ctx.graphicsQueueFamily, ringSize / (1024.0 * 1024.0));
+    return true;
+}
+
+void GpuUploader::shutdown(VulkanContext& ctx)
+{
+    if (!pool) return;
+    flush(ctx);
+    if (async && !inFlight.empty()) {
+        const uint64_t last = inFlight.back().ticket;
+        VkSemaphoreWaitInfo wi{ VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+        wi.semaphoreCount = 1;
+        wi.pSemaphores = &ctx.uploadTimeline;
+        wi.pValues = &last;
+        vkWaitSemaphores(ctx.device, &wi, UINT64_MAX);
+    }
+    for (auto& b : inFlight) release(b);
+    inFlight.clear();
+    if (!freeCmds.empty())
+        vkFreeCommandBuffers(ctx.device, pool, (uint32_t)freeCmds.size(), freeCmds.data());
+    freeCmds.clear();
+    vkDestroyCommandPool(ctx.device, pool, nullptr);
+    pool = VK_NULL_HANDLE;
+    if (ctx.uploadTimeline) { vkDestroySemaphore(ctx.device, ctx.uploadTimeline, nullptr); ctx.uploadTimeline = VK_NULL_HANDLE; }
+    ctx.uploadWaitValue = 0;
+
+    if (ring) vkDestroyBuffer(ctx.device, ring, nullptr);
+    if (ringMem) vkFreeMemory(ctx.device, ringMem, nullptr);   // implicitne unmap
+    ring = VK_NULL_HANDLE; ringMem = VK_NULL_HANDLE; ringPtr = nullptr;
+    ringSize = ringHead = ringTail = ringUsed = 0;
+    st.inFlight = 0;
+}
+
+GpuUploader::Batch& GpuUploader::recording(VulkanContext& ctx)
+{
+    if (cur.cmd) return cur;
+    if (!freeCmds.empty()) {
+        cur.cmd = freeCmds.back();
+        freeCmds.pop_back();
+    }
+    else {
+        VkCommandBufferAllocateInfo ai{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+        ai.commandPool = pool;
+        ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        ai.commandBufferCount = 1;
+        VK_CHECK(vkAllocateCommandBuffers(ctx.device, &ai, &cur.cmd));
+    }
+    VkCommandBufferBeginInfo bi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(cur.cmd, &bi));   // pool ma RESET bit => implicitny reset
+    cur.ticket = nextTicket;
+    cur.ringEnd = ringHead;
+    return cur;
+}
+
+// batch dobehol: jeho cast ringu je volna (batche koncia v poradi => tail ide len dopredu)
+void GpuUploader::release(Batch& b)
+{
+    if (b.ringBytes) {
+        ringTail = b.ringEnd;
+        ringUsed -= b.ringBytes;
+        if (ringUsed == 0) ringHead = ringTail = 0;
+    }
+    b.ringBytes = 0;
+    if (b.cmd) freeCmds.push_back(b.cmd);
+    b.cmd = VK_NULL_HANDLE;
+}
+
+// Volne miesto: [head, size) + [0, tail) ak head >= tail, inak [head, tail).
+// head == tail je prazdny ring len pri ringUsed == 0.
+bool GpuUploader::ringAlloc(VkDeviceSize bytes, VkDeviceSize& offset)
+{
+    if (bytes == 0 || bytes > ringSize) return false;
+    const bool full = ringUsed > 0 && ringHead == ringTail;
+    const VkDeviceSize start = alignUp(ringHead, RING_ALIGN);
+    VkDeviceSize consumed = 0;
+    if (!full && ringHead >= ringTail) {
+        if (start + bytes <= ringSize) { offset = start; consumed = start - ringHead + bytes; }
+        else if (bytes <= ringTail) { offset = 0; consumed = ringSize - ringHead + bytes; }   // zabal, koniec je odpad
+        else return false;
+    }
+    else if (!full && start + bytes <= ringTail) { offset = start; consumed = start - ringHead + bytes; }
+    else return false;
+
+    ringHead = offset + bytes;
+    ringUsed += consumed;
+    cur.ringEnd = ringHead;
+    cur.ringBytes += consumed;
+    st.ringUsed = ringUsed;
+    ++st.stagingAllocs;
+    return true;
+}
+
+VkDeviceSize GpuUploader::ringLargestFree() const
+{
+    if (ringUsed > 0 && ringHead == ringTail) return 0;
+    const VkDeviceSize start = alignUp(ringHead, RING_ALIGN);
+    if (ringHead >= ringTail)
+        return std::max(start < ringSize ? ringSize - start : 0, ringTail);
+    return start < ringTail ? ringTail - start : 0;
+}
+
+char* GpuUploader::allocStaging(VulkanContext& ctx, VkDeviceSize bytes, VkBuffer& buf, VkDeviceSize& offset)
+{
+    if (!ringAlloc(bytes, offset)) { ++st.ringFull; return nullptr; }
+    recording(ctx);   // miesto patri aktualnemu batchu (kopia z neho ide hned za tym)
+    buf = ring;
+    return ringPtr + offset;
+}
+
+bool GpuUploader::pump(VulkanContext& ctx, UploadStream& s)
+{
+    while (!s.finished()) {
+        const UploadStream::Range& r = s.ranges[s.range];
+        const VkDeviceSize left = r.size - s.offset;
+        const VkDeviceSize n = std::min(left, ringLargestFree() & ~(RING_ALIGN - 1));
+        if (n == 0 || (n < left && n < STREAM_MIN_PIECE)) return false;   // zvysok v dalsom frame
+
+        VkBuffer src = VK_NULL_HANDLE;
+        VkDeviceSize off = 0;
+        char* p = allocStaging(ctx, n, src, off);
+        if (!p) return false;
+        std::memcpy(p, s.data.data() + r.src + s.offset, (size_t)n);
+        const VkBufferCopy c{ off, r.dstOffset + s.offset, n };
+        copy(ctx, src, r.dst, &c, 1);
+        if (s.range == 0 && s.offset == 0) ++st.streamed;
+
+        s.offset += n;
+        if (s.offset == r.size) { ++s.range; s.offset = 0; }
+    }
+    return true;
+}
+
+void GpuUploader::copy(VulkanContext& ctx, VkBuffer src, VkBuffer dst, const VkBufferCopy* regions, uint32_t count)
+{
+    if (count == 0) return;
+    Batch& b = recording(ctx);
+    vkCmdCopyBuffer(b.cmd, src, dst, count, regions);
+    st.copies += count;
+    for (uint32_t i = 0; i < count; ++i) st.bytes += regions[i].size;
+}
+
+void GpuUploader::copyInPlace(VulkanContext& ctx, VkBuffer src, VkBuffer dst, const VkBufferCopy* regions, uint32_t count)
+{
+    if (count == 0) return;
+    Batch& b = recording(ctx);
+    b.inPlace = true;
+    if (!async) {
+        // graphics queue: dst sa prepisuje na mieste => pockaj, kym ho skor odoslane drawy docitaju
+        VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        mb.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        mb.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(b.cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 1, &mb, 0, nullptr, 0, nullptr);
+    }
+    copy(ctx, src, dst, regions, count);
+}
+
+uint64_t GpuUploader::flush(VulkanContext& ctx)
+{
+    if (!cur.cmd) return 0;
+    VK_CHECK(vkEndCommandBuffer(cur.cmd));
+
+    VkSubmitInfo si{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    si.commandBufferCount = 1;
+    si.pCommandBuffers = &cur.cmd;
+
+    // async: in-place batch caka na vsetky doteraz odoslane framy, signalizuje svoj ticket
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    const uint64_t waitValue = ctx.frameSerial;
+    const uint64_t signalValue = cur.ticket;
+    VkTimelineSemaphoreSubmitInfo tsi{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    if (async) {
+        if (cur.inPlace && waitValue > 0) {
+            si.waitSemaphoreCount = 1;
+            si.pWaitSemaphores = &ctx.frameTimeline;
+            si.pWaitDstStageMask = &waitStage;
+            tsi.waitSemaphoreValueCount = 1;
+            tsi.pWaitSemaphoreValues = &waitValue;
+        }
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores = &ctx.uploadTimeline;
+        tsi.signalSemaphoreValueCount = 1;
+        tsi.pSignalSemaphoreValues = &signalValue;
+        si.pNext = &tsi;
+    }
+
+    const uint64_t t = cur.ticket;
+    const VkResult r = vkQueueSubmit(queue, 1, &si, VK_NULL_HANDLE);
+    if (r != VK_SUCCESS) fprintf(stderr, "[Upload] batch %llu submit failed (%d)\n", (unsigned long long)t, (int)r);
+    ++st.batches;
+
+    if (!async || r != VK_SUCCESS) {
+        vkQueueWaitIdle(queue);
+        release(cur);
+        completed = t;
+    }
+    else {
+        if (cur.inPlace) ctx.uploadWaitValue = t;   // dalsi frame kresli prepisane data
+        inFlight.push_back(std::move(cur));
+    }
+    cur = Batch{};
+    ++nextTicket;
+    st.inFlight = (uint32_t)inFlight.size();
+    st.ringUsed = ringUsed;
+    return t;
+}
+
+void GpuUploader::updateRates()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const float sec = std::chrono::duration<float>(now - rateT0).count();
+    if (sec < 1.0f) return;
+    st.allocsPerSec = float(st.stagingAllocs - rateAllocs0) / sec;
+    st.mbPerSec = float(double(st.bytes - rateBytes0) / (1024.0 * 1024.0)) / sec;
+    rateT0 = now;
+    rateAllocs0 = st.stagingAllocs;
+    rateBytes0 = st.bytes;
+}
+
+uint64_t GpuUploader::poll(VulkanContext& ctx)
+{
+    if (async && !inFlight.empty()) {
+        uint64_t v = 0;
+        if (vkGetSemaphoreCounterValue(ctx.device, ctx.uploadTimeline, &v) == VK_SUCCESS)
+            completed = std::max(completed, v);
+        while (!inFlight.empty() && inFlight.front().ticket <= completed) {
+            release(inFlight.front());
+            inFlight.pop_front();
+        }
+        // chunky prepnute na dokoncene buffery: formalna zavislost pre dalsi frame (uz je splnena)
+        ctx.uploadWaitValue = std::max(ctx.uploadWaitValue, completed);
+    }
+    st.inFlight = (uint32_t)inFlight.size();
+    st.ringUsed = ringUsed;
+    updateRates();
+    return completed;
+}
@@ -0,0 +1,242 @@
+#include "hiz.hpp"
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
+
+struct HiZPush {
+    int32_t srcSize[2];
+    int32_t dstSize[2];
+};
+
+static constexpr uint32_t HIZ_GROUP = 8;        // local_size v hiz.comp
+static constexpr uint32_t HIZ_MAX_LEVELS = 16;  // 64k pixelov
+
+bool HiZPyramid::init(VulkanContext& ctx, const std::string& shaderDir)
+{
+    if (!ctx.depthSampled) {
+        printf("[HiZ] off: depth format can't be sampled\n");
+        return false;
+    }
+    std::vector<char> code;
+    try { code = readFile(shaderDir + "/hiz.comp.spv"); }
+    catch (const std::exception& e) {
+        printf("[HiZ] off: %s\n", e.what());
+        return false;
+    }
+
+    VkDescriptorSetLayoutBinding b[2]{};
+    b[0].binding = 0;
+    b[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    b[0].descriptorCount = 1;
+    b[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    b[1].binding = 1;
+    b[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    b[1].descriptorCount = 1;
+    b[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    VkDescriptorSetLayoutCreateInfo lci{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    lci.bindingCount = 2;
+    lci.pBindings = b;
+    VK_CHECK_RET(vkCreateDescriptorSetLayout(ctx.device, &lci, nullptr, &setLayout));
+
+    VkDescriptorPoolSize ps[2] = {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, HIZ_MAX_LEVELS },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, HIZ_MAX_LEVELS } };
+    VkDescriptorPoolCreateInfo dp{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    dp.maxSets = HIZ_MAX_LEVELS;
+    dp.poolSizeCount = 2;
+    dp.pPoolSizes = ps;
+    VK_CHECK_RET(vkCreateDescriptorPool(ctx.device, &dp, nullptr, &descPool));
+
+    VkPushConstantRange pcr{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZPush) };
+    VkPipelineLayoutCreateInfo plci{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    plci.setLayoutCount = 1;
+    plci.pSetLayouts = &setLayout;
+    plci.pushConstantRangeCount = 1;
+    plci.pPushConstantRanges = &pcr;
+    VK_CHECK_RET(vkCreatePipelineLayout(ctx.device, &plci, nullptr, &layout));
+
+    // nearest + clamp: shader cita texelFetch, sampler je len kvoli combined descriptoru
+    VkSamplerCreateInfo si{ VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+    si.magFilter = VK_FILTER_NEAREST;
+    si.minFilter = VK_FILTER_NEAREST;
+    si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    si.addressModeU = si.addressModeV = si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    si.maxLod = VK_LOD_CLAMP_NONE;
+    VK_CHECK_RET(vkCreateSampler(ctx.device, &si, nullptr, &sampler));
+
+    VkShaderModule mod = createShaderModule(ctx.device, code);
+    VkComputePipelineCreateInfo ci{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    ci.stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    ci.stage.module = mod;
+    ci.stage.pName = "main";
+    ci.layout = layout;
+    const VkResult r = vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &ci, nullptr, &pipeline);
+    vkDestroyShaderModule(ctx.device, mod, nullptr);
+    if (r != VK_SUCCESS) {
+        fprintf(stderr, "[HiZ] vkCreateComputePipelines failed (%d)\n", (int)r);
+        pipeline = VK_NULL_HANDLE;
+        return false;
+    }
+    return resize(ctx);
+}
+
+void HiZPyramid::destroyImage(VulkanContext& ctx)
+{
+    for (VkImageView v : levelViews) vkDestroyImageView(ctx.device, v, nullptr);
+    levelViews.clear();
+    levelSize.clear();
+    levelSets.clear();
+    if (descPool) vkResetDescriptorPool(ctx.device, descPool, 0);
+    if (fullView) vkDestroyImageView(ctx.device, fullView, nullptr);
+    if (image) vkDestroyImage(ctx.device, image, nullptr);
+    if (mem) vkFreeMemory(ctx.device, mem, nullptr);
+    fullView = VK_NULL_HANDLE;
+    image = VK_NULL_HANDLE;
+    mem = VK_NULL_HANDLE;
+    srcW = srcH = 0;
+}
+
+void HiZPyramid::shutdown(VulkanContext& ctx)
+{
+    destroyImage(ctx);
+    if (pipeline) vkDestroyPipeline(ctx.device, pipeline, nullptr);
+    if (layout) vkDestroyPipelineLayout(ctx.device, layout, nullptr);
+    if (descPool) vkDestroyDescriptorPool(ctx.device, descPool, nullptr);
+    if (setLayout) vkDestroyDescriptorSetLayout(ctx.device, setLayout, nullptr);
+    if (sampler) vkDestroySampler(ctx.device, sampler, nullptr);
+    pipeline = VK_NULL_HANDLE;
+    layout = VK_NULL_HANDLE;
+    descPool = VK_NULL_HANDLE;
+    setLayout = VK_NULL_HANDLE;
+    sampler = VK_NULL_HANDLE;
+}
+
+// volane po vkDeviceWaitIdle (recreate swapchainu) alebo pri init => stary obrazok nikto necita
+bool HiZPyramid::resize(VulkanContext& ctx)
+{
+    if (!pipeline) return false;
+    destroyImage(ctx);
+    ++gen;
+    if (!ctx.depthSampleView || ctx.swapchainExtent.width == 0 || ctx.swapchainExtent.height == 0) return false;
+
+    srcW = ctx.swapchainExtent.width;
+    srcH = ctx.swapchainExtent.height;
+    uint32_t w = (srcW + 1) / 2, h = (srcH + 1) / 2;
+    levelSize.push_back({ w, h });
+    while ((w > 1 || h > 1) && levelSize.size() < HIZ_MAX_LEVELS) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        levelSize.push_back({ w, h });
+    }
+    const uint32_t n = (uint32_t)levelSize.size();
+
+    if (!createImage(ctx, levelSize[0].width, levelSize[0].height, VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            n, image, mem)) {
+        fprintf(stderr, "[HiZ] image %ux%u failed\n", levelSize[0].width, levelSize[0].height);
+        destroyImage(ctx);
+        return false;
+    }
+    VkImageViewCreateInfo iv{ VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    iv.image = image;
+    iv.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    iv.format = VK_FORMAT_R32_SFLOAT;
+    iv.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, n, 0, 1 };
+    VK_CHECK_RET(vkCreateImageView(ctx.device, &iv, nullptr, &fullView));
+    levelViews.resize(n, VK_NULL_HANDLE);
+    for (uint32_t i = 0; i < n; ++i) {
+        iv.subresourceRange.baseMipLevel = i;
+        iv.subresourceRange.levelCount = 1;
+        VK_CHECK_RET(vkCreateImageView(ctx.device, &iv, nullptr, &levelViews[i]));
+    }
+
+    levelSets.resize(n, VK_NULL_HANDLE);
+    std::vector<VkDescriptorSetLayout> layouts(n, setLayout);
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = descPool;
+    ai.descriptorSetCount = n;
+    ai.pSetLayouts = layouts.data();
+    VK_CHECK_RET(vkAllocateDescriptorSets(ctx.device, &ai, levelSets.data()));
+    for (uint32_t i = 0; i < n; ++i) {
+        VkDescriptorImageInfo src{ sampler, i ? levelViews[i - 1] : ctx.depthSampleView,
+            i ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+        VkDescriptorImageInfo dst{ VK_NULL_HANDLE, levelViews[i], VK_IMAGE_LAYOUT_GENERAL };
+        VkWriteDescriptorSet w[2]{};
+        for (int j = 0; j < 2; ++j) {
+            w[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[j].dstSet = levelSets[i];
+            w[j].dstBinding = j;
+            w[j].descriptorCount = 1;
+        }
+        w[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        w[0].pImageInfo = &src;
+        w[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        w[1].pImageInfo = &dst;
+        vkUpdateDescriptorSets(ctx.device, 2, w, 0, nullptr);
+    }
+    printf("[HiZ] %ux%u, %u levels\n", levelSize[0].width, levelSize[0].height, n);
+    return true;
+}
+
+void HiZPyramid::build(VkCommandBuffer cb, const VulkanContext& ctx)
+{
+    if (!ready()) return;
+    const uint32_t n = (uint32_t)levelViews.size();
+    const VkImageAspectFlags depthAspect = hasStencilComponent(ctx.depthFormat)
+        ? (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) : VK_IMAGE_ASPECT_DEPTH_BIT;
+
+    // depth z opaque passu -> citanie v compute; pyramida: stary obsah zahodit
+    VkImageMemoryBarrier ib[2]{};
+    for (auto& b : ib) {
+        b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+    ib[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    ib[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    ib[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    ib[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    ib[0].image = ctx.depthImage;
+    ib[0].subresourceRange = { depthAspect, 0, 1, 0, 1 };
+    ib[1].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;   // late cull minuleho framu (iny submit, len poradie)
+    ib[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    ib[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ib[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ib[1].image = image;
+    ib[1].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, n, 0, 1 };
+    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 2, ib);
+
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    uint32_t sw = srcW, sh = srcH;
+    for (uint32_t i = 0; i < n; ++i) {
+        const VkExtent2D d = levelSize[i];
+        HiZPush pc{ { (int32_t)sw, (int32_t)sh }, { (int32_t)d.width, (int32_t)d.height } };
+        vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &levelSets[i], 0, nullptr);
+        vkCmdPushConstants(cb, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+        vkCmdDispatch(cb, (d.width + HIZ_GROUP - 1) / HIZ_GROUP, (d.height + HIZ_GROUP - 1) / HIZ_GROUP, 1);
+
+        // uroven i cita dalsia uroven aj cull.comp
+        VkImageMemoryBarrier lb = ib[1];
+        lb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        lb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        lb.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        lb.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1 };
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &lb);
+        sw = d.width;
+        sh = d.height;
+    }
+
+    // depth spat pre druhy priechod (LOAD)
+    VkImageMemoryBarrier db = ib[0];
+    db.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    db.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    db.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    db.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &db);
+}
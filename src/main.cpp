@@ -83,31 +83,6 @@ static void streamTick(World& world, VulkanContext& ctx, const FPSCamera& cam) {
     lastCx = cx; lastCz = cz; lastView = gViewDist;
 }
 
-std::vector<bool> regionDirty(REGION_COUNT, false);
-// CPU mesh cache per region
-std::vector<MeshData> regionCpu(REGION_COUNT);
-
-static void markRegionForCell(std::vector<bool>& flags, int x, int y, int z)
-{
-    // which region contains this cell?
-    int rx = clampi(x / REGION_SIZE, 0, REGIONS_X - 1);
-    int ry = clampi(y / REGION_SIZE, 0, REGIONS_Y - 1);
-    int rz = clampi(z / REGION_SIZE, 0, REGIONS_Z - 1);
-
-    flags[regionIndex(rx, ry, rz)] = true;
-
-    // also mark neighbor regions when we touch the border,
-    // so faces across region edges get updated
-    if (x % REGION_SIZE == 0 && rx > 0)               flags[regionIndex(rx - 1, ry, rz)] = true;
-    if (x % REGION_SIZE == REGION_SIZE - 1 && rx < REGIONS_X - 1)  flags[regionIndex(rx + 1, ry, rz)] = true;
-
-    if (y % REGION_SIZE == 0 && ry > 0)               flags[regionIndex(rx, ry - 1, rz)] = true;
-    if (y % REGION_SIZE == REGION_SIZE - 1 && ry < REGIONS_Y - 1)  flags[regionIndex(rx, ry + 1, rz)] = true;
-     
-    if (z % REGION_SIZE == 0 && rz > 0)               flags[regionIndex(rx, ry, rz - 1)] = true;
-    if (z % REGION_SIZE == REGION_SIZE - 1 && rz < REGIONS_Z - 1)  flags[regionIndex(rx, ry, rz + 1)] = true;
-}
-
 static void glfwErrorCallback(int code, const char* desc) 
 {
     std::cerr << "[GLFW] (" << code << ") " << desc << std::endl;
@@ -360,7 +335,9 @@ void updateGame(GLFWwindow* window, float deltaTime) {
                 }
 
                 if (changed) {
-                    // this walks chunks with wc->needsUpload==true and pushes new VBO/IBO
+                    // remesh bezi na workeri; hotove meshe sa zberu a uploadnu vo worldStreamTick,
+                    // tu len dotlacime to, co uz je hotove
+                    worldCollectMeshes(world);
                     worldUploadDirty(world, ctx);
                 }
             }
@@ -452,6 +429,7 @@ int main()
         if (!createFramebuffers(ctx)) throw std::runtime_error("framebuffers failed");
         if (!createCommandPoolAndBuffers(ctx))
             throw std::runtime_error("cmd pool/buffers failed");
+        if (!world.initGPU(ctx)) throw std::runtime_error("world GPU init failed");
         setupDebug(ctx);
         cam.setViewportSize(ctx.swapchainExtent.width, ctx.swapchainExtent.height);
         cam.setCursorCaptured(window, !g_uiMode); // keep cursor mode consistent
@@ -471,30 +449,18 @@ int main()
             throw std::runtime_error("descriptors failed");
         if (!createSkyPipeline(ctx, "shaders")) throw std::runtime_error("sky pipeline failed");
         if (!createVoxelPipeline(ctx, "shaders")) throw std::runtime_error("voxel pipeline failed");
-        // after swapchain/framebuffers/cmd pool and BEFORE recordCommandBuffers:
-        glm::mat4 proj = glm::perspective(glm::radians(60.0f),
-            (float)ctx.swapchainExtent.width / (float)ctx.swapchainExtent.height,
-            0.1f, 1000.0f);
-        // flip Y for Vulkan NDC
-        proj[1][1] *= -1.0f;
-
-        glm::vec3 eye = { 8.0f, 8.0f, 30.0f };   // camera position
-        glm::vec3 target = { 8.0f, 2.0f, 8.0f }; // look at chunk center
-        glm::vec3 up = { 0.0f, 1.0f, 0.0f };
-
-        glm::mat4 view = glm::lookAt(eye, target, up);
-        glm::mat4 model = glm::mat4(1.0f);
-        glm::mat4 mvp = proj * view * model;
-
+        world.gpuCuller.init(ctx, "shaders");   // volitelne: bez neho kresli CPU culling
+        if (world.gpuCuller.ready()) world.hiz.init(ctx, "shaders");   // Hi-Z occlusion nad GPU cullingom
         gAudio.init();
         gAudio.loadEvent("block_destroy", "assets/sfx/destroy.wav");
-        if (!recordCommandBuffers(ctx, 0.05f, 0.1f, 0.15f, &mvp[0][0], [&](VkCommandBuffer cb) {
-            world.draw(ctx, cb);
-            // draw the overlay into the same render pass
-            dbgImGuiNewFrame();
-            dbgImGuiDraw(ctx, cb, debugStats);
-            })) throw std::runtime_error("record cmd buffers failed");
+        // command buffery sa nahravaju kazdy frame v drawFrameWithMVP (slot framu v lete)
         if (!createSyncObjects(ctx)) throw std::runtime_error("sync objects failed");
+        // meshe prezivu restart (kluc = obsah + MESHER_VERSION); volitelne, s LRU budgetom na disku.
+        // Pred prvym streamEnsureAround, nech z cache tahaju uz aj chunky startovej oblasti
+        if (gMeshDiskCache) {
+            world.meshCache.setDiskBudget(uint64_t(gMeshDiskCacheMB) << 20);
+            world.meshCache.setDiskDir("saves/meshcache");
+        }
 
         // For now, we won't create swapchain; just a running loop + device ready.
         std::cout << "Vulkan initialized. Running loop..." << std::endl;
@@ -520,12 +486,14 @@ int main()
             lastView = gViewDist;
         }
         //world.ensure(ctx, cx, cz, /*radius*/ 2); // 5x5 chunks
+        world.meshWorkers.waitIdle();   // prvy frame nech uz ma teren
+        worldCollectMeshes(world);
         worldUploadDirty(world, ctx);
 
         // debug: how many chunks and total tris?
         size_t chunks = world.map.size();
         size_t tris = 0;
-        for (auto& kv : world.map) tris += kv.second->meshCPU.indices.size() / 3;
+        for (auto& kv : world.map) tris += chunkIndexCount(*kv.second) / 3;
         std::cerr << "[World] created chunks=" << chunks << " tris=" << tris << "\n";
 
         initGame();
@@ -575,7 +543,7 @@ int main()
 
                 // Tear down GPU stuff tied to swapchain
                 destroyVoxelPipeline(ctx);
-                cleanupSwapchain(ctx);                  // destroys fbos, rp, views, swapchain, depth, cmd pool, semaphores & fence
+                cleanupSwapchain(ctx);                  // destroys fbos, rp, views, swapchain, depth, cmd pool, semaphores & fences
 
                 // Recreate swapchain-sized resources
                 if (!createSwapchain(ctx, (uint32_t)w, (uint32_t)h)) throw std::runtime_error("swapchain failed");
@@ -590,6 +558,7 @@ int main()
                 if (!createSkyPipeline(ctx, "shaders")) throw std::runtime_error("sky pipeline failed");
                 // Recreate pipeline (depends on render pass & extent)
                 if (!createVoxelPipeline(ctx, "shaders")) throw std::runtime_error("voxel pipeline failed");
+                world.hiz.resize(ctx);                  // novy depth buffer => nova pyramida
 
                 // Recreate sync objects (cleanupSwapchain destroyed them)
                 if (!createSyncObjects(ctx)) throw std::runtime_error("sync objects failed");
@@ -610,11 +579,32 @@ int main()
                 recreateSwapchainAll();
             }
 
-            if (!drawFrameWithMVP(ctx, &mvp[0][0], [&](VkCommandBuffer cb) {
-                world.draw(ctx, cb);                 // binds per-chunk VBO/IBO and draws
+            world.cull(mvp, cam.position);   // chunky a casti mimo frustum (a zakryte) sa nekreslia
+            auto drawRest = [&](VkCommandBuffer cb) {
+                world.drawTranslucent(ctx, cb, cam.position); // voda po opaque, odzadu dopredu
                 dbgImGuiNewFrame();                  // if you want overlay
                 dbgImGuiDraw(ctx, cb, debugStats);
-                })) {
+                };
+            // Hi-Z occlusion: opaque priechod, Hi-Z + late culling, potom zvysok v druhom priechode
+            const bool occlusion = world.occlusionActive();
+            DrawSceneFn between, late;
+            if (occlusion) {
+                between = [&](VkCommandBuffer cb) { world.recordOcclusion(ctx, cb); };
+                late = [&](VkCommandBuffer cb) {
+                    world.drawLate(cb);              // nove viditelne casti (late faza)
+                    drawRest(cb);
+                    };
+            }
+            // CPU cesta: opaque chunky nahraju vlakna do secondary bufferov (drawScene ich potom preskoci)
+            auto parallel = [&](const VkCommandBufferInheritanceInfo& inh, const float* m, std::vector<VkCommandBuffer>& out) {
+                world.recordParallel(ctx, inh, m, cam.position, out);
+                };
+            if (!drawFrameWithMVP(ctx, &mvp[0][0], [&](VkCommandBuffer cb) {
+                world.draw(ctx, cb, cam.position);   // binds per-chunk VBO/IBO and draws
+                if (!occlusion) drawRest(cb);
+                }, [&](VkCommandBuffer cb) {
+                world.recordGpuCull(ctx, cb, cam.position);   // compute culling pred render passom
+                }, between, late, parallel)) {
                 recreateSwapchainAll();
                 continue; // next frame
             }
@@ -623,6 +613,8 @@ int main()
         vkDeviceWaitIdle(ctx.device);
 
         // Cleanup
+        world.destroyGPU(ctx);   // + uploader (command pool, upload timeline)
+        if (ctx.frameTimeline) vkDestroySemaphore(ctx.device, ctx.frameTimeline, nullptr);
         if (ctx.device) vkDestroyDevice(ctx.device, nullptr);
         if (ctx.surface) vkDestroySurfaceKHR(ctx.instance, ctx.surface, nullptr);
         destroyDebug(ctx);
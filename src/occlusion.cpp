@@ -0,0 +1,301 @@
+#include "occlusion.hpp"
+#include "world/block_props.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static constexpr int OCC_BAND = 8;                          // riadkov na pas (= vyska bloku)
+static constexpr int OCC_BANDS = SOFT_OCC_H / OCC_BAND;
+static constexpr int OCC_BLOCKS_X = SOFT_OCC_W / OCC_BAND;
+static constexpr float OCC_NEAR_W = 0.05f;                  // orezanie occluderov (clip w)
+static constexpr int OCCLUDER_MAX_DEPTH = 128;              // voxelov pod povrchom (boky boxu)
+
+void chunkOccluders(const Chunk& c, int topY, int cx, int cy, int cz, std::vector<OccluderBox>& out)
+{
+    const int top = std::min(topY, CHUNK_HEIGHT);
+    if (top <= 0) return;
+    constexpr int T = OCCLUDER_TILE;
+    for (int tz = 0; tz < CHUNK_SIZE; tz += T) {
+        for (int tx = 0; tx < CHUNK_SIZE; tx += T) {
+            // povrch: najnizsi z najvyssich opaque voxelov stlpcov
+            int hi = top;
+            for (int z = tz; z < tz + T && hi > 0; ++z)
+                for (int x = tx; x < tx + T && hi > 0; ++x) {
+                    int y = std::min(hi, top) - 1;
+                    while (y >= 0 && !blockOpaque(c.get(x, y, z))) --y;
+                    hi = std::min(hi, y + 1);
+                }
+            if (hi <= 0) continue;
+
+            // dolu po riadkoch, kym su vsetky stlpce plne (jaskyna => koniec)
+            int lo = hi;
+            const int floorY = std::max(0, hi - OCCLUDER_MAX_DEPTH);
+            while (lo > floorY) {
+                bool full = true;
+                for (int z = tz; z < tz + T && full; ++z) {
+                    const BlockID* row = &c.blocks[Chunk::index(tx, lo - 1, z)];
+                    for (int x = 0; x < T; ++x) if (!blockOpaque(row[x])) { full = false; break; }
+                }
+                if (!full) break;
+                --lo;
+            }
+            if (lo >= hi) continue;
+
+            // voxel v pokryva [(v - 0.5), (v + 0.5)] * VOXEL_SCALE (ako boxy casti)
+            const float bx = float(cx * CHUNK_SIZE + tx), by = float(cy * CHUNK_HEIGHT), bz = float(cz * CHUNK_SIZE + tz);
+            OccluderBox b;
+            b.mn[0] = (bx - 0.5f) * VOXEL_SCALE;     b.mx[0] = (bx + T - 0.5f) * VOXEL_SCALE;
+            b.mn[1] = (by + lo - 0.5f) * VOXEL_SCALE; b.mx[1] = (by + hi - 0.5f) * VOXEL_SCALE;
+            b.mn[2] = (bz - 0.5f) * VOXEL_SCALE;     b.mx[2] = (bz + T - 0.5f) * VOXEL_SCALE;
+            out.push_back(b);
+        }
+    }
+}
+
+SoftOcclusion::~SoftOcclusion() {
+    stop();
+}
+
+void SoftOcclusion::start(int n) {
+    if (started) return;
+    if (n <= 0) {
+        const int hw = (int)std::thread::hardware_concurrency();
+        n = std::clamp(hw - 1, 1, 4);
+    }
+    quit = false;
+    started = true;
+    st.threads = n;
+    for (int i = 1; i < n; ++i)   // volajuce vlakno robi tiez
+        threads.emplace_back([this] { workerMain(); });
+    printf("[Occl] software raster %dx%d, %d thread(s)\n", SOFT_OCC_W, SOFT_OCC_H, n);
+}
+
+void SoftOcclusion::stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        quit = true;
+    }
+    cvWork.notify_all();
+    for (auto& t : threads) if (t.joinable()) t.join();
+    threads.clear();
+    started = false;
+}
+
+void SoftOcclusion::begin(const glm::mat4& vp, const glm::vec3& camPos) {
+    viewProj = vp;
+    cam = camPos;
+    tris.clear();
+    const int threadCount = st.threads;
+    st = {};
+    st.threads = threadCount;
+}
+
+void SoftOcclusion::addOccluder(const OccluderBox& b) {
+    ++st.occluders;
+    const glm::vec3 mn(b.mn[0], b.mn[1], b.mn[2]), mx(b.mx[0], b.mx[1], b.mx[2]);
+    // len steny otocene ku kamere (kamera v boxe => nic, box nic nezakryva)
+    if (cam.x > mn.x && cam.x < mx.x && cam.y > mn.y && cam.y < mx.y && cam.z > mn.z && cam.z < mx.z) return;
+
+    auto corner = [&](int i) {
+        return viewProj * glm::vec4((i & 1) ? mx.x : mn.x, (i & 2) ? mx.y : mn.y, (i & 4) ? mx.z : mn.z, 1.0f);
+    };
+    glm::vec4 c[8];
+    for (int i = 0; i < 8; ++i) c[i] = corner(i);
+
+    // steny ako 4 rohy (poradie po obvode); bit osi urcuje stranu
+    static constexpr int FACES[6][4] = {
+        { 0, 2, 6, 4 }, { 1, 3, 7, 5 },   // -x, +x
+        { 0, 1, 5, 4 }, { 2, 3, 7, 6 },   // -y, +y
+        { 0, 1, 3, 2 }, { 4, 5, 7, 6 },   // -z, +z
+    };
+    for (int axis = 0; axis < 3; ++axis) {
+        int side = -1;
+        if (cam[axis] < mn[axis]) side = 0;
+        else if (cam[axis] > mx[axis]) side = 1;
+        if (side < 0) continue;
+        const int* f = FACES[axis * 2 + side];
+        const glm::vec4 q[4] = { c[f[0]], c[f[1]], c[f[2]], c[f[3]] };
+        addPolygon(q, 4);
+    }
+}
+
+void SoftOcclusion::addPolygon(const glm::vec4* in, int n) {
+    // orez na w >= near (Sutherland-Hodgman, jedna rovina => najviac n + 1 vrcholov)
+    glm::vec4 poly[8];
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        const glm::vec4& a = in[i];
+        const glm::vec4& b = in[(i + 1) % n];
+        const bool ain = a.w >= OCC_NEAR_W, bin = b.w >= OCC_NEAR_W;
+        if (ain) poly[m++] = a;
+        if (ain != bin) poly[m++] = a + (b - a) * ((OCC_NEAR_W - a.w) / (b.w - a.w));
+    }
+    if (m < 3) return;
+
+    // do pixelov (stred pixelu i je i + 0.5), y orientacia je jedno - test pouziva rovnaku
+    float sx[8], sy[8], iw[8];
+    for (int i = 0; i < m; ++i) {
+        iw[i] = 1.0f / poly[i].w;
+        sx[i] = (poly[i].x * iw[i] * 0.5f + 0.5f) * SOFT_OCC_W;
+        sy[i] = (poly[i].y * iw[i] * 0.5f + 0.5f) * SOFT_OCC_H;
+    }
+
+    // vejar trojuholnikov; spolocne hrany sa pokryvaju z oboch stran (>= 0) => bez dier
+    for (int k = 1; k + 1 < m; ++k) {
+        const int v[3] = { 0, k, k + 1 };
+        const float area = (sx[v[1]] - sx[v[0]]) * (sy[v[2]] - sy[v[0]]) - (sx[v[2]] - sx[v[0]]) * (sy[v[1]] - sy[v[0]]);
+        if (std::fabs(area) < 1e-6f) continue;
+        const float sgn = area > 0.0f ? 1.0f : -1.0f;
+
+        Tri t;
+        float fx0 = FLT_MAX, fy0 = FLT_MAX, fx1 = -FLT_MAX, fy1 = -FLT_MAX;
+        for (int e = 0; e < 3; ++e) {
+            const int a = v[e], b = v[(e + 1) % 3];
+            // vnutri: (b - a) x (p - a) ma znamienko plochy
+            t.e[e][0] = -(sy[b] - sy[a]) * sgn;
+            t.e[e][1] = (sx[b] - sx[a]) * sgn;
+            t.e[e][2] = -(t.e[e][0] * sx[a] + t.e[e][1] * sy[a]);
+            fx0 = std::min(fx0, sx[a]); fx1 = std::max(fx1, sx[a]);
+            fy0 = std::min(fy0, sy[a]); fy1 = std::max(fy1, sy[a]);
+        }
+        // pixely, ktorych stred moze byt vnutri (orez pred int, vrcholy pri near su daleko mimo)
+        fx0 = std::max(fx0, -1.0f); fy0 = std::max(fy0, -1.0f);
+        fx1 = std::min(fx1, float(SOFT_OCC_W + 1)); fy1 = std::min(fy1, float(SOFT_OCC_H + 1));
+        t.x0 = std::max(0, (int)std::ceil(fx0 - 0.5f));
+        t.y0 = std::max(0, (int)std::ceil(fy0 - 0.5f));
+        t.x1 = std::min(SOFT_OCC_W - 1, (int)std::floor(fx1 - 0.5f));
+        t.y1 = std::min(SOFT_OCC_H - 1, (int)std::floor(fy1 - 0.5f));
+        if (t.x0 > t.x1 || t.y0 > t.y1) continue;
+
+        // 1/w je v obrazovke linearne: iw = A x + B y + C
+        const float dx1 = sx[v[1]] - sx[v[0]], dy1 = sy[v[1]] - sy[v[0]];
+        const float dx2 = sx[v[2]] - sx[v[0]], dy2 = sy[v[2]] - sy[v[0]];
+        const float dw1 = iw[v[1]] - iw[v[0]], dw2 = iw[v[2]] - iw[v[0]];
+        t.iw[0] = (dw1 * dy2 - dw2 * dy1) / area;
+        t.iw[1] = (dw2 * dx1 - dw1 * dx2) / area;
+        t.iw[2] = iw[v[0]] - t.iw[0] * sx[v[0]] - t.iw[1] * sy[v[0]];
+        tris.push_back(t);
+    }
+}
+
+void SoftOcclusion::rasterBand(int band) {
+    const int ry0 = band * OCC_BAND, ry1 = ry0 + OCC_BAND - 1;
+    float* d = depthBuf.data();
+    std::fill(d + ry0 * SOFT_OCC_W, d + (ry1 + 1) * SOFT_OCC_W, 0.0f);
+
+    for (const Tri& t : tris) {
+        if (t.y1 < ry0 || t.y0 > ry1) continue;
+        const int y0 = std::max(t.y0, ry0), y1 = std::min(t.y1, ry1);
+        // najvzdialenejsia hlbka roviny v celom pixeli (konzervativne pre ciastocne pokrytie)
+        const float iwSlack = 0.5f * (std::fabs(t.iw[0]) + std::fabs(t.iw[1]));
+        for (int y = y0; y <= y1; ++y) {
+            const float py = y + 0.5f;
+            // rozsah x v riadku: a * (x + 0.5) + k >= 0 pre kazdu hranu
+            float xl = float(t.x0), xr = float(t.x1);
+            for (int e = 0; e < 3; ++e) {
+                const float a = t.e[e][0];
+                const float k = a * 0.5f + t.e[e][1] * py + t.e[e][2];
+                if (a > 0.0f) xl = std::max(xl, std::ceil(-k / a));
+                else if (a < 0.0f) xr = std::min(xr, std::floor(-k / a));
+                else if (k < 0.0f) { xr = -1.0f; break; }
+            }
+            if (xl > xr) continue;
+            const int xa = (int)xl, xb = (int)xr;
+            float* row = d + y * SOFT_OCC_W;
+            const float iwRow = t.iw[1] * py + t.iw[2] - iwSlack + t.iw[0] * 0.5f;
+            for (int x = xa; x <= xb; ++x)
+                row[x] = std::max(row[x], iwRow + t.iw[0] * x);
+        }
+    }
+
+    // najvzdialenejsi pixel po blokoch 8x8 pre rychly test
+    for (int bx = 0; bx < OCC_BLOCKS_X; ++bx) {
+        float m = FLT_MAX;
+        for (int y = ry0; y <= ry1; ++y)
+            for (int x = bx * OCC_BAND; x < (bx + 1) * OCC_BAND; ++x) m = std::min(m, d[y * SOFT_OCC_W + x]);
+        blockMin[band * OCC_BLOCKS_X + bx] = m;
+    }
+}
+
+void SoftOcclusion::runBands() {
+    for (int b; (b = nextBand.fetch_add(1)) < OCC_BANDS; ) {
+        rasterBand(b);
+        std::lock_guard<std::mutex> lk(mtx);
+        if (++bandsDone == OCC_BANDS) cvDone.notify_all();
+    }
+}
+
+void SoftOcclusion::workerMain() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cvWork.wait(lk, [&] { return quit || jobGen != seen; });
+            if (quit) return;
+            seen = jobGen;
+        }
+        runBands();
+    }
+}
+
+void SoftOcclusion::rasterize() {
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!started) start();
+    depthBuf.resize(size_t(SOFT_OCC_W) * SOFT_OCC_H);
+    blockMin.resize(size_t(OCC_BLOCKS_X) * OCC_BANDS);
+    st.triangles = (uint32_t)tris.size();
+
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        bandsDone = 0;
+        nextBand = 0;
+        ++jobGen;
+    }
+    if (!threads.empty()) cvWork.notify_all();
+    runBands();
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        cvDone.wait(lk, [this] { return bandsDone == OCC_BANDS; });
+    }
+    st.rasterUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+}
+
+bool SoftOcclusion::occluded(const float mn[3], const float mx[3]) {
+    if (depthBuf.empty()) return false;
+    ++st.tested;
+
+    // obdlznik boxu v pixeloch a najblizsia hlbka; roh pred near => moze byt hocikde, viditelny
+    float fx0 = FLT_MAX, fy0 = FLT_MAX, fx1 = -FLT_MAX, fy1 = -FLT_MAX, maxIw = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec4 p = viewProj * glm::vec4((i & 1) ? mx[0] : mn[0], (i & 2) ? mx[1] : mn[1], (i & 4) ? mx[2] : mn[2], 1.0f);
+        if (p.w < OCC_NEAR_W) return false;
+        const float sx = (p.x / p.w * 0.5f + 0.5f) * SOFT_OCC_W;
+        const float sy = (p.y / p.w * 0.5f + 0.5f) * SOFT_OCC_H;
+        fx0 = std::min(fx0, sx); fx1 = std::max(fx1, sx);
+        fy0 = std::min(fy0, sy); fy1 = std::max(fy1, sy);
+        maxIw = std::max(maxIw, 1.0f / p.w);
+    }
+    fx0 = std::max(fx0, -2.0f); fy0 = std::max(fy0, -2.0f);
+    fx1 = std::min(fx1, float(SOFT_OCC_W + 2)); fy1 = std::min(fy1, float(SOFT_OCC_H + 2));
+    // vsetky pixely, ktorych sa box dotyka, + 1 pixel okolo (occluder pixel plati len v strede)
+    const int x0 = std::max(0, (int)std::floor(fx0) - 1), x1 = std::min(SOFT_OCC_W - 1, (int)std::floor(fx1) + 1);
+    const int y0 = std::max(0, (int)std::floor(fy0) - 1), y1 = std::min(SOFT_OCC_H - 1, (int)std::floor(fy1) + 1);
+    if (x0 > x1 || y0 > y1) return false;
+
+    for (int by = y0 / OCC_BAND; by <= y1 / OCC_BAND; ++by) {
+        for (int bx = x0 / OCC_BAND; bx <= x1 / OCC_BAND; ++bx) {
+            if (blockMin[by * OCC_BLOCKS_X + bx] > maxIw) continue;
+            const int ya = std::max(y0, by * OCC_BAND), yb = std::min(y1, by * OCC_BAND + OCC_BAND - 1);
+            const int xa = std::max(x0, bx * OCC_BAND), xb = std::min(x1, bx * OCC_BAND + OCC_BAND - 1);
+            for (int y = ya; y <= yb; ++y) {
+                const float* row = depthBuf.data() + y * SOFT_OCC_W;
+                for (int x = xa; x <= xb; ++x)
+                    if (row[x] <= maxIw) return false;
+            }
+        }
+    }
+    ++st.occluded;
+    return true;
+}
@@ -0,0 +1,147 @@
+#include "parallel_record.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+ParallelRecorder::~ParallelRecorder() {
+    // pooly nici shutdown (potrebuje device), tu len vlakna
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        quit = true;
+    }
+    cvWork.notify_all();
+    for (auto& t : threads) if (t.joinable()) t.join();
+}
+
+bool ParallelRecorder::init(VkDevice dev, uint32_t queueFamily, uint32_t slots, int n) {
+    if (ready()) return true;
+    if (n <= 0) {
+        const int hw = (int)std::thread::hardware_concurrency();
+        n = std::clamp(hw - 1, 1, 8);
+    }
+    slotCount = std::max(1u, slots);
+    pools.resize(size_t(n) * slotCount);
+    VkCommandPoolCreateInfo pci{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    pci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;   // cely pool sa resetuje kazdy frame slotu
+    pci.queueFamilyIndex = queueFamily;
+    for (Pool& p : pools)
+        if (vkCreateCommandPool(dev, &pci, nullptr, &p.pool) != VK_SUCCESS) {
+            fprintf(stderr, "[Record] command pool failed\n");
+            shutdown(dev);
+            return false;
+        }
+
+    quit = false;
+    st.threads = n;
+    for (int i = 1; i < n; ++i)   // volajuce vlakno ma pooly s indexom 0
+        threads.emplace_back([this, i] { workerMain(i); });
+    printf("[Record] parallel secondary recording, %d thread(s) x %u frame slots\n", n, slotCount);
+    return true;
+}
+
+void ParallelRecorder::shutdown(VkDevice dev) {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        quit = true;
+    }
+    cvWork.notify_all();
+    for (auto& t : threads) if (t.joinable()) t.join();
+    threads.clear();
+    for (Pool& p : pools)
+        if (p.pool) vkDestroyCommandPool(dev, p.pool, nullptr);   // uvolni aj jeho buffery
+    pools.clear();
+    slotCount = 0;
+    st = {};
+}
+
+void ParallelRecorder::runJobs(int thread) {
+    for (uint32_t j; (j = nextJob.fetch_add(1)) < jobCount; ) {
+        Pool& p = poolOf(thread, slot);
+        VkCommandBuffer cb = VK_NULL_HANDLE;
+        if (p.used < p.cbs.size()) cb = p.cbs[p.used++];
+        else {
+            VkCommandBufferAllocateInfo ai{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            ai.commandPool = p.pool;
+            ai.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            ai.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(device, &ai, &cb) == VK_SUCCESS) {
+                p.cbs.push_back(cb);
+                ++p.used;
+            }
+            else cb = VK_NULL_HANDLE;
+        }
+
+        VkCommandBufferBeginInfo bi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        bi.pInheritanceInfo = inherit;
+        if (cb && vkBeginCommandBuffer(cb, &bi) == VK_SUCCESS) {
+            (*job)(cb, j);
+            if (vkEndCommandBuffer(cb) != VK_SUCCESS) failed = true;
+        }
+        else failed = true;
+        (*results)[j] = cb;
+    }
+}
+
+void ParallelRecorder::workerMain(int thread) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cvWork.wait(lk, [&] { return quit || jobGen != seen; });
+            if (quit) return;
+            seen = jobGen;
+        }
+        runJobs(thread);
+        std::lock_guard<std::mutex> lk(mtx);
+        if (--workersLeft == 0) cvDone.notify_all();
+    }
+}
+
+bool ParallelRecorder::record(VkDevice dev, uint32_t s, const VkCommandBufferInheritanceInfo& inh,
+    uint32_t jobs, const JobFn& fn, std::vector<VkCommandBuffer>& out)
+{
+    out.clear();
+    st.jobs = 0;
+    if (!ready() || jobs == 0 || s >= slotCount) return false;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // GPU uz slot nepouziva => buffery vsetkych vlakien naraz (vlakna teraz stoja)
+    for (int t = 0; t < st.threads; ++t) {
+        Pool& p = poolOf(t, s);
+        vkResetCommandPool(dev, p.pool, 0);
+        p.used = 0;
+    }
+    out.assign(jobs, VK_NULL_HANDLE);
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        device = dev;
+        slot = s;
+        jobCount = jobs;
+        job = &fn;
+        inherit = &inh;
+        results = &out;
+        failed = false;
+        workersLeft = (uint32_t)threads.size();
+        nextJob = 0;
+        ++jobGen;
+    }
+    if (!threads.empty()) cvWork.notify_all();
+    runJobs(0);
+    {
+        // kazde vlakno dobehne tuto generaciu => ziadne neskoro zobudene nesiahne na dalsi record
+        std::unique_lock<std::mutex> lk(mtx);
+        cvDone.wait(lk, [this] { return workersLeft == 0; });
+        job = nullptr;
+        inherit = nullptr;
+        results = nullptr;
+    }
+    st.jobs = jobs;
+    st.us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (failed) {
+        fprintf(stderr, "[Record] secondary command buffer failed\n");
+        out.clear();
+        return false;
+    }
+    return true;
+}
@@ -1,3 +1,5 @@
 #include "settings.hpp"
 int gViewDist = 2;  // 5x5
-int gUnloadSlack = 1; // optional slack
\ No newline at end of file
+int gUnloadSlack = 1; // optional slack
+bool gMeshDiskCache = false;
+int  gMeshDiskCacheMB = 512;
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <algorithm>
 #include <array>
+#include <chrono>
 
 // Choose swapchain format
 static VkSurfaceFormatKHR chooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats) {
@@ -141,7 +142,35 @@ bool createRenderPass(VulkanContext& ctx) {
     rpci.subpassCount = 1;
     rpci.pSubpasses = &subpass;
 
-    return vkCreateRenderPass(ctx.device, &rpci, nullptr, &ctx.renderPass) == VK_SUCCESS;
+    // framy v lete zdielaju jeden depth: dalsi frame ho smie vycistit az po zapisoch predosleho;
+    // color caka na acquire (imageAvailable) v COLOR_ATTACHMENT_OUTPUT
+    VkSubpassDependency dep{};
+    dep.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dep.dstSubpass = 0;
+    dep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dep.dstStageMask = dep.srcStageMask;
+    dep.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dep.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    rpci.dependencyCount = 1;
+    rpci.pDependencies = &dep;
+
+    if (vkCreateRenderPass(ctx.device, &rpci, nullptr, &ctx.renderPass) != VK_SUCCESS) return false;
+
+    // opaque priechod: color ostava na dalsi priechod, depth sa uklada pre Hi-Z
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    if (vkCreateRenderPass(ctx.device, &rpci, nullptr, &ctx.renderPassOpaque) != VK_SUCCESS) return false;
+
+    // druhy priechod: pokracuje na tom, co nechal opaque
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    return vkCreateRenderPass(ctx.device, &rpci, nullptr, &ctx.renderPassResume) == VK_SUCCESS;
 }
 
 bool createFramebuffers(VulkanContext& ctx) {
@@ -184,68 +213,18 @@ bool createCommandPoolAndBuffers(VulkanContext& ctx) {
     pci.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     if (vkCreateCommandPool(ctx.device, &pci, nullptr, &ctx.commandPool) != VK_SUCCESS) return false;
 
-    ctx.commandBuffers.resize(ctx.framebuffers.size());
+    // jeden primary na slot (nie na obrazok swapchainu): po fence slotu sa nahra znova
+    VkCommandBuffer cmds[MAX_FRAMES_IN_FLIGHT]{};
     VkCommandBufferAllocateInfo ai{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
     ai.commandPool = ctx.commandPool;
     ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    ai.commandBufferCount = (uint32_t)ctx.commandBuffers.size();
-    return vkAllocateCommandBuffers(ctx.device, &ai, ctx.commandBuffers.data()) == VK_SUCCESS;
-}
-
-// Records all CBs once with the given MVP (useful for static scenes)
-// If youre drawing every frame with a changing camera, prefer drawFrameWithMVP below.
-bool recordCommandBuffers(VulkanContext& ctx, float r, float g, float b, const float* mvp, DrawSceneFn drawScene) {
-    for (size_t i = 0; i < ctx.commandBuffers.size(); ++i) {
-        VkCommandBuffer cb = ctx.commandBuffers[i];
-
-        // (re)start this command buffer cleanly
-        vkResetCommandBuffer(cb, 0);
-
-        VkCommandBufferBeginInfo bi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-        if (vkBeginCommandBuffer(cb, &bi) != VK_SUCCESS) return false;
-
-        VkClearValue clears[2]{};
-        clears[0].color = {{r, g, b, 1.0f}};
-        clears[1].depthStencil = { 1.0f, 0 };            // depth=1.0 (far), stencil unused
-
-        VkRenderPassBeginInfo rp{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
-        rp.renderPass = ctx.renderPass;
-        rp.framebuffer = ctx.framebuffers[i];
-        rp.renderArea.offset = { 0, 0 };
-        rp.renderArea.extent = ctx.swapchainExtent;
-        rp.clearValueCount = 2;
-        rp.pClearValues = clears;
-
-        vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
-
-        // 1) bind pipeline
-        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.voxelPipeline);
-
-        // 2) bind descriptor set 0 with the SAME pipeline layout
-        vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
-            ctx.voxelPipelineLayout, 0, 1, &ctx.descSet, 0, nullptr);
-
-        // 3) push constants: mat4 (64B) + atlasScale(2) + atlasOffset(2) = 80B
-        float pcData[20];
-        memcpy(pcData, mvp, sizeof(float) * 16);
-        pcData[16] = 1.0f / ATLAS_N;                // atlasScale.x
-        pcData[17] = 1.0f / ATLAS_N;                // atlasScale.y
-        pcData[18] = 1.0f / ctx.atlasWidth;      // atlasTexel.x  (add these two!)
-        pcData[19] = 1.0f / ctx.atlasHeight;     // atlasTexel.y
-
-        vkCmdPushConstants(cb, ctx.voxelPipelineLayout,
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-            0, sizeof(float) * 20, pcData);
-
-        // 4) bind buffers + draw
-        if (drawScene) {
-            drawScene(cb); // e.g. world.draw(ctx, cb)
-        }
-
-        vkCmdEndRenderPass(cb);
+    ai.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+    if (vkAllocateCommandBuffers(ctx.device, &ai, cmds) != VK_SUCCESS) return false;
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) ctx.frames[i].cmd = cmds[i];
 
-        if (vkEndCommandBuffer(cb) != VK_SUCCESS) return false;
-    }
+    ai.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    if (vkAllocateCommandBuffers(ctx.device, &ai, cmds) != VK_SUCCESS) return false;
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) ctx.frames[i].cmdSecondary = cmds[i];
     return true;
 }
 
@@ -253,125 +232,196 @@ bool createSyncObjects(VulkanContext& ctx) {
     VkSemaphoreCreateInfo si{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
     VkFenceCreateInfo fi{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
     fi.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    if (vkCreateSemaphore(ctx.device, &si, nullptr, &ctx.imageAvailableSemaphore) != VK_SUCCESS) return false;
-    if (vkCreateSemaphore(ctx.device, &si, nullptr, &ctx.renderFinishedSemaphore) != VK_SUCCESS) return false;
-    if (vkCreateFence(ctx.device, &fi, nullptr, &ctx.inFlightFence) != VK_SUCCESS) return false;
+    for (FrameResources& fr : ctx.frames) {
+        if (vkCreateSemaphore(ctx.device, &si, nullptr, &fr.imageAvailable) != VK_SUCCESS) return false;
+        if (vkCreateFence(ctx.device, &fi, nullptr, &fr.inFlight) != VK_SUCCESS) return false;
+        fr.serial = ctx.frameSerial;   // po vkDeviceWaitIdle (recreate) je vsetko hotove
+    }
+    ctx.renderFinishedSemaphores.assign(ctx.swapchainImages.size(), VK_NULL_HANDLE);
+    for (VkSemaphore& s : ctx.renderFinishedSemaphores)
+        if (vkCreateSemaphore(ctx.device, &si, nullptr, &s) != VK_SUCCESS) return false;
+    ctx.currentFrame = 0;
     return true;
 }
 
-bool drawFrame(VulkanContext& ctx) {
-    vkWaitForFences(ctx.device, 1, &ctx.inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(ctx.device, 1, &ctx.inFlightFence);
-
-    uint32_t imageIndex = 0;
-    VkResult acq = vkAcquireNextImageKHR(ctx.device, ctx.swapchain, UINT64_MAX,
-        ctx.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
-    if (acq != VK_SUCCESS) return false;
+void waitFramesInFlight(VulkanContext& ctx) {
+    // fence sa resetuje az tesne pred submitom => aj slot, ktory sa prave nahrava, je signalizovany
+    VkFence fences[MAX_FRAMES_IN_FLIGHT];
+    uint32_t n = 0;
+    for (const FrameResources& fr : ctx.frames)
+        if (fr.inFlight) fences[n++] = fr.inFlight;
+    if (n) vkWaitForFences(ctx.device, n, fences, VK_TRUE, UINT64_MAX);
+    ctx.frameCompleted = ctx.frameSerial;
+}
 
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submit.waitSemaphoreCount = 1;
-    submit.pWaitSemaphores = &ctx.imageAvailableSemaphore;
-    submit.pWaitDstStageMask = waitStages;
-    submit.commandBufferCount = 1;
-    submit.pCommandBuffers = &ctx.commandBuffers[imageIndex];
-    submit.signalSemaphoreCount = 1;
-    submit.pSignalSemaphores = &ctx.renderFinishedSemaphore;
+void cmdBindVoxelState(const VulkanContext& ctx, VkCommandBuffer cb, const float* mvp) {
+    // 80 B push constants
+    float pcData[20];
+    memcpy(pcData, mvp, sizeof(float) * 16);
+    pcData[16] = 1.0f / 4.0f;                // atlasScale.x
+    pcData[17] = 1.0f / 4.0f;                // atlasScale.y
+    pcData[18] = 1.0f / ctx.atlasWidth;      // atlasTexel.x  (add these two!)
+    pcData[19] = 1.0f / ctx.atlasHeight;     // atlasTexel.y
 
-    if (vkQueueSubmit(ctx.graphicsQueue, 1, &submit, ctx.inFlightFence) != VK_SUCCESS) return false;
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, voxelColorPipeline(ctx, false));
+    vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+        ctx.voxelPipelineLayout, 0, 1, &ctx.frames[ctx.currentFrame].descSet, 0, nullptr);
+    vkCmdPushConstants(cb, ctx.voxelPipelineLayout,
+        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(float) * 20, pcData);
+}
 
-    VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-    present.waitSemaphoreCount = 1;
-    present.pWaitSemaphores = &ctx.renderFinishedSemaphore;
-    present.swapchainCount = 1;
-    present.pSwapchains = &ctx.swapchain;
-    present.pImageIndices = &imageIndex;
-    return vkQueuePresentKHR(ctx.graphicsQueue, &present) == VK_SUCCESS;
+VkPipeline voxelColorPipeline(const VulkanContext& ctx, bool afterPrepass) {
+    const int i = afterPrepass ? 1 : 0;
+    if (ctx.voxelOverdraw && ctx.voxelOverdrawPipeline[i]) return ctx.voxelOverdrawPipeline[i];
+    return afterPrepass ? ctx.voxelEqualPipeline : ctx.voxelPipeline;
 }
 
 // Records AND submits per-frame with current MVP (use this in your main loop).
 // Returns false when the swapchain is out of date (trigger your recreate path).
-bool drawFrameWithMVP(VulkanContext& ctx, const float* mvp, DrawSceneFn drawScene) {
-    // wait & reset fence for this frame
-    if (vkWaitForFences(ctx.device, 1, &ctx.inFlightFence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) return false;
-    if (vkResetFences(ctx.device, 1, &ctx.inFlightFence) != VK_SUCCESS) return false;
-
-    // acquire image
+bool drawFrameWithMVP(VulkanContext& ctx, const float* mvp, DrawSceneFn drawScene,
+    DrawSceneFn beforeRenderPass, DrawSceneFn betweenPasses, DrawSceneFn drawSceneLate,
+    RecordSecondaryFn recordSecondary) {
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    ctx.framesInFlight = std::clamp(ctx.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    FrameResources& fr = ctx.frames[ctx.currentFrame];
+
+    // slot je volny, ked GPU dokoncila jeho minuly submit (ostatne framy mozu bezat dalej)
+    if (vkWaitForFences(ctx.device, 1, &fr.inFlight, VK_TRUE, UINT64_MAX) != VK_SUCCESS) return false;
+    ctx.frameCompleted = std::max(ctx.frameCompleted, fr.serial);   // submity jednej queue koncia v poradi
+
+    // acquire image (fence ostava signalizovana, ak sa frame nepodari)
     uint32_t imageIndex = 0;
     VkResult acq = vkAcquireNextImageKHR(ctx.device, ctx.swapchain, UINT64_MAX,
-        ctx.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+        fr.imageAvailable, VK_NULL_HANDLE, &imageIndex);
     if (acq == VK_ERROR_OUT_OF_DATE_KHR) return false;
     if (acq != VK_SUCCESS && acq != VK_SUBOPTIMAL_KHR) return false;
+    const auto t1 = clock::now();
 
-    // record command buffer for this image
-    VkCommandBuffer cb = ctx.commandBuffers[imageIndex];
+    // record command buffer for this frame slot
+    VkCommandBuffer cb = fr.cmd;
     vkResetCommandBuffer(cb, 0);
 
     VkCommandBufferBeginInfo bi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     if (vkBeginCommandBuffer(cb, &bi) != VK_SUCCESS) return false;
 
+    if (beforeRenderPass) beforeRenderPass(cb);
+
     VkClearValue clears[2]{};
     clears[0].color = {{0.05f, 0.10f, 0.15f, 1.0f}};
+    if (ctx.voxelOverdraw) clears[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};   // heatmapa od nuly
     clears[1].depthStencil = { 1.0f, 0 };
 
+    const bool split = betweenPasses && ctx.renderPassOpaque && ctx.renderPassResume;
+
     VkRenderPassBeginInfo rp{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
-    rp.renderPass = ctx.renderPass;
+    rp.renderPass = split ? ctx.renderPassOpaque : ctx.renderPass;
     rp.framebuffer = ctx.framebuffers[imageIndex];
     rp.renderArea.offset = { 0, 0 };
     rp.renderArea.extent = ctx.swapchainExtent;
     rp.clearValueCount = 2;
     rp.pClearValues = clears;
 
-    vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
-
-    // pipeline -> descriptor set -> push constants (full 80B to BOTH stages)
-    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.voxelPipeline);
-
-    vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS,
-        ctx.voxelPipelineLayout, 0, 1, &ctx.descSet, 0, nullptr);
+    // secondary buffery prveho priechodu (vlakna) sa nahravaju mimo primary, este pred render passom
+    static thread_local std::vector<VkCommandBuffer> secondaries;
+    secondaries.clear();
+    VkCommandBufferInheritanceInfo inh{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inh.renderPass = rp.renderPass;
+    inh.subpass = 0;
+    inh.framebuffer = rp.framebuffer;
+    if (recordSecondary) recordSecondary(inh, mvp, secondaries);
+    const bool secondary = !secondaries.empty();
+
+    vkCmdBeginRenderPass(cb, &rp, secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+    // v SECONDARY priechode nesmu byt inline prikazy => zvysok ide do cmdSecondary slotu
+    VkCommandBuffer scb = cb;
+    if (secondary) {
+        scb = fr.cmdSecondary;
+        vkResetCommandBuffer(scb, 0);
+        VkCommandBufferBeginInfo sbi{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        sbi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        sbi.pInheritanceInfo = &inh;
+        if (vkBeginCommandBuffer(scb, &sbi) != VK_SUCCESS) return false;
+    }
 
-    // 80 B push constants
-    float pcData[20];
-    memcpy(pcData, mvp, sizeof(float) * 16);
-    pcData[16] = 1.0f / 4.0f;                // atlasScale.x
-    pcData[17] = 1.0f / 4.0f;                // atlasScale.y
-    pcData[18] = 1.0f / ctx.atlasWidth;      // atlasTexel.x  (add these two!)
-    pcData[19] = 1.0f / ctx.atlasHeight;     // atlasTexel.y
-
-    vkCmdPushConstants(cb, ctx.voxelPipelineLayout,
-        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-        0, sizeof(float) * 20, pcData);
+    cmdBindVoxelState(ctx, scb, mvp);
 
     if (ctx.vertexBuffer && ctx.indexBuffer && ctx.indexCount > 0) {
         VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(cb, 0, 1, &ctx.vertexBuffer, offsets);
-        vkCmdBindIndexBuffer(cb, ctx.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(cb, ctx.indexCount, 1, 0, 0, 0);
+        vkCmdBindVertexBuffers(scb, 0, 1, &ctx.vertexBuffer, offsets);
+        vkCmdBindIndexBuffer(scb, ctx.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(scb, ctx.indexCount, 1, 0, 0, 0);
     }
 
     // >>> draw your scene (chunks) here <<<
-    if (drawScene) drawScene(cb);
+    if (drawScene) drawScene(scb);
+
+    if (secondary) {
+        if (vkEndCommandBuffer(scb) != VK_SUCCESS) return false;
+        secondaries.push_back(scb);
+        vkCmdExecuteCommands(cb, (uint32_t)secondaries.size(), secondaries.data());
+    }
+
+    if (split) {
+        vkCmdEndRenderPass(cb);
+        betweenPasses(cb);
+
+        // color z opaque priechodu -> LOAD v druhom (depth synchronizuje betweenPasses)
+        VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        mb.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 1, &mb, 0, nullptr, 0, nullptr);
+
+        rp.renderPass = ctx.renderPassResume;
+        rp.clearValueCount = 0;
+        rp.pClearValues = nullptr;
+        vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
+        cmdBindVoxelState(ctx, cb, mvp);   // stav grafickej pipeline sa cez render pass neprenasa
+        if (drawSceneLate) drawSceneLate(cb);
+    }
 
     vkCmdEndRenderPass(cb);
     if (vkEndCommandBuffer(cb) != VK_SUCCESS) return false;
 
-    // submit
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    // submit: + pockaj na uploady, ktore tento frame uz kresli, a posun frame timeline
+    VkSemaphore waitSems[2] = { fr.imageAvailable, ctx.uploadTimeline };
+    uint64_t waitValues[2] = { 0, ctx.uploadWaitValue };
+    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT };
+    VkSemaphore signalSems[2] = { ctx.renderFinishedSemaphores[imageIndex], ctx.frameTimeline };
+    uint64_t signalValues[2] = { 0, ctx.frameSerial + 1 };
+
     VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submit.waitSemaphoreCount = 1;
-    submit.pWaitSemaphores = &ctx.imageAvailableSemaphore;
+    submit.waitSemaphoreCount = (ctx.uploadTimeline && ctx.uploadWaitValue) ? 2 : 1;
+    submit.pWaitSemaphores = waitSems;
     submit.pWaitDstStageMask = waitStages;
     submit.commandBufferCount = 1;
     submit.pCommandBuffers = &cb;
-    submit.signalSemaphoreCount = 1;
-    submit.pSignalSemaphores = &ctx.renderFinishedSemaphore;
-
-    if (vkQueueSubmit(ctx.graphicsQueue, 1, &submit, ctx.inFlightFence) != VK_SUCCESS) return false;
+    submit.signalSemaphoreCount = ctx.frameTimeline ? 2 : 1;
+    submit.pSignalSemaphores = signalSems;
+
+    VkTimelineSemaphoreSubmitInfo tsi{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+    tsi.waitSemaphoreValueCount = submit.waitSemaphoreCount;
+    tsi.pWaitSemaphoreValues = waitValues;      // binarne semafory hodnotu ignoruju
+    tsi.signalSemaphoreValueCount = submit.signalSemaphoreCount;
+    tsi.pSignalSemaphoreValues = signalValues;
+    if (ctx.timelineSemaphores) submit.pNext = &tsi;
+
+    if (vkResetFences(ctx.device, 1, &fr.inFlight) != VK_SUCCESS) return false;
+    if (vkQueueSubmit(ctx.graphicsQueue, 1, &submit, fr.inFlight) != VK_SUCCESS) return false;
+    fr.serial = ++ctx.frameSerial;
+    ctx.currentFrame = (ctx.currentFrame + 1) % ctx.framesInFlight;
+    const auto t2 = clock::now();
+    ctx.frameWaitMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+    ctx.frameRecordMs = std::chrono::duration<float, std::milli>(t2 - t1).count();
 
     // present
     VkPresentInfoKHR present{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
     present.waitSemaphoreCount = 1;
-    present.pWaitSemaphores = &ctx.renderFinishedSemaphore;
+    present.pWaitSemaphores = &ctx.renderFinishedSemaphores[imageIndex];
     present.swapchainCount = 1;
     present.pSwapchains = &ctx.swapchain;
     present.pImageIndices = &imageIndex;
@@ -386,6 +436,8 @@ void cleanupSwapchain(VulkanContext& ctx) {
     for (auto fb : ctx.framebuffers) if (fb) vkDestroyFramebuffer(ctx.device, fb, nullptr);
     ctx.framebuffers.clear();
     if (ctx.renderPass) vkDestroyRenderPass(ctx.device, ctx.renderPass, nullptr); ctx.renderPass = VK_NULL_HANDLE;
+    if (ctx.renderPassOpaque) { vkDestroyRenderPass(ctx.device, ctx.renderPassOpaque, nullptr); ctx.renderPassOpaque = VK_NULL_HANDLE; }
+    if (ctx.renderPassResume) { vkDestroyRenderPass(ctx.device, ctx.renderPassResume, nullptr); ctx.renderPassResume = VK_NULL_HANDLE; }
     for (auto iv : ctx.swapchainImageViews) if (iv) vkDestroyImageView(ctx.device, iv, nullptr);
     ctx.swapchainImageViews.clear();
     if (ctx.swapchain) vkDestroySwapchainKHR(ctx.device, ctx.swapchain, nullptr); ctx.swapchain = VK_NULL_HANDLE;
@@ -393,11 +445,14 @@ void cleanupSwapchain(VulkanContext& ctx) {
     if (ctx.commandPool) {
         vkDestroyCommandPool(ctx.device, ctx.commandPool, nullptr);
         ctx.commandPool = VK_NULL_HANDLE;
-        ctx.commandBuffers.clear();
+        for (FrameResources& fr : ctx.frames) fr.cmd = fr.cmdSecondary = VK_NULL_HANDLE;
     }
-    if (ctx.imageAvailableSemaphore) { vkDestroySemaphore(ctx.device, ctx.imageAvailableSemaphore, nullptr); ctx.imageAvailableSemaphore = VK_NULL_HANDLE; }
-    if (ctx.renderFinishedSemaphore) { vkDestroySemaphore(ctx.device, ctx.renderFinishedSemaphore, nullptr); ctx.renderFinishedSemaphore = VK_NULL_HANDLE; }
-    if (ctx.inFlightFence) { vkDestroyFence(ctx.device, ctx.inFlightFence, nullptr); ctx.inFlightFence = VK_NULL_HANDLE; }
+    for (FrameResources& fr : ctx.frames) {
+        if (fr.imageAvailable) { vkDestroySemaphore(ctx.device, fr.imageAvailable, nullptr); fr.imageAvailable = VK_NULL_HANDLE; }
+        if (fr.inFlight) { vkDestroyFence(ctx.device, fr.inFlight, nullptr); fr.inFlight = VK_NULL_HANDLE; }
+    }
+    for (VkSemaphore s : ctx.renderFinishedSemaphores) if (s) vkDestroySemaphore(ctx.device, s, nullptr);
+    ctx.renderFinishedSemaphores.clear();
 }
 
 
@@ -512,12 +567,41 @@ bool pickPhysicalDevice(VulkanContext& ctx) {
     return false;
 }
 
+// Rodina pre uploady: ciste transfer (DMA engine) > transfer bez graphics > graphics rodina
+static uint32_t pickTransferFamily(VulkanContext& ctx) {
+    uint32_t count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &count, nullptr);
+    std::vector<VkQueueFamilyProperties> props(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &count, props.data());
+
+    const VkQueueFlags gc = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+    for (uint32_t i = 0; i < count; ++i)
+        if ((props[i].queueFlags & VK_QUEUE_TRANSFER_BIT) && !(props[i].queueFlags & gc) && props[i].queueCount > 0)
+            return i;
+    for (uint32_t i = 0; i < count; ++i)
+        if ((props[i].queueFlags & VK_QUEUE_TRANSFER_BIT) && !(props[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) && props[i].queueCount > 0)
+            return i;
+    return ctx.graphicsQueueFamily;
+}
+
+bool createTimelineSemaphore(VkDevice device, uint64_t initialValue, VkSemaphore& out) {
+    VkSemaphoreTypeCreateInfo ti{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    ti.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    ti.initialValue = initialValue;
+    VkSemaphoreCreateInfo si{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    si.pNext = &ti;
+    return vkCreateSemaphore(device, &si, nullptr, &out) == VK_SUCCESS;
+}
+
 bool createDevice(VulkanContext& ctx) {
     float prio = 1.0f;
     std::vector<VkDeviceQueueCreateInfo> qcis;
     std::vector<uint32_t> uniq = { ctx.graphicsQueueFamily };
     if (ctx.presentQueueFamily != ctx.graphicsQueueFamily)
         uniq.push_back(ctx.presentQueueFamily);
+    ctx.transferQueueFamily = pickTransferFamily(ctx);
+    if (std::find(uniq.begin(), uniq.end(), ctx.transferQueueFamily) == uniq.end())
+        uniq.push_back(ctx.transferQueueFamily);
 
     for (uint32_t fam : uniq) {
         VkDeviceQueueCreateInfo qci{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
@@ -536,8 +620,23 @@ bool createDevice(VulkanContext& ctx) {
     if (supported.samplerAnisotropy) {
         feats.samplerAnisotropy = VK_TRUE;      // ask for it
     }
+    feats.multiDrawIndirect = supported.multiDrawIndirect;
+
+    // timeline semafory (core 1.2) => uploady bez cakania na idle
+    VkPhysicalDeviceProperties devProps{};
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &devProps);
+    VkPhysicalDeviceVulkan12Features have12{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_12_FEATURES };
+    if (devProps.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceFeatures2 f2{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        f2.pNext = &have12;
+        vkGetPhysicalDeviceFeatures2(ctx.physicalDevice, &f2);
+    }
+    VkPhysicalDeviceVulkan12Features feats12{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_12_FEATURES };
+    feats12.timelineSemaphore = have12.timelineSemaphore;
+    feats12.drawIndirectCount = have12.drawIndirectCount;   // GPU culling (GpuCuller)
 
     VkDeviceCreateInfo dci{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+    if (devProps.apiVersion >= VK_API_VERSION_1_2) dci.pNext = &feats12;
     dci.queueCreateInfoCount = (uint32_t)qcis.size();
     dci.pQueueCreateInfos = qcis.data();
     dci.pEnabledFeatures = &feats;
@@ -553,10 +652,26 @@ bool createDevice(VulkanContext& ctx) {
     vkGetDeviceQueue(ctx.device, ctx.graphicsQueueFamily, 0, &ctx.graphicsQueue);
     vkGetDeviceQueue(ctx.device, ctx.presentQueueFamily, 0, &ctx.presentQueue);
 
+    vkGetDeviceQueue(ctx.device, ctx.transferQueueFamily, 0, &ctx.transferQueue);
+
     if (ctx.graphicsQueueFamily == ctx.presentQueueFamily)
         ctx.presentQueue = ctx.graphicsQueue;
-
-    return ctx.graphicsQueue && ctx.presentQueue;
+    if (ctx.graphicsQueueFamily == ctx.transferQueueFamily)
+        ctx.transferQueue = ctx.graphicsQueue;
+
+    ctx.timelineSemaphores = feats12.timelineSemaphore == VK_TRUE;
+    ctx.multiDrawIndirect = feats.multiDrawIndirect == VK_TRUE;
+    ctx.drawIndirectCount = devProps.apiVersion >= VK_API_VERSION_1_2 && feats12.drawIndirectCount == VK_TRUE;
+    ctx.frameSerial = 0;
+    ctx.frameCompleted = 0;
+    if (ctx.timelineSemaphores && !createTimelineSemaphore(ctx.device, 0, ctx.frameTimeline))
+        ctx.timelineSemaphores = false;
+    printf("[Vulkan] transfer queue family %u (%s), timeline semaphores %s, indirect count %s\n",
+        ctx.transferQueueFamily,
+        ctx.transferQueueFamily != ctx.graphicsQueueFamily ? "dedicated" : "shared with graphics",
+        ctx.timelineSemaphores ? "on" : "off", ctx.drawIndirectCount ? "on" : "off");
+
+    return ctx.graphicsQueue && ctx.presentQueue && ctx.transferQueue;
 }
 
 std::vector<char> readFile(const std::string& path) {
@@ -686,11 +801,18 @@ uint32_t findMemoryType(VkPhysicalDevice phys, uint32_t typeFilter, VkMemoryProp
 }
 
 bool createBuffer(VulkanContext& ctx, VkDeviceSize size, VkBufferUsageFlags usage,
-    VkMemoryPropertyFlags props, VkBuffer& buf, VkDeviceMemory& mem) {
+    VkMemoryPropertyFlags props, VkBuffer& buf, VkDeviceMemory& mem, bool sharedWithTransfer) {
     VkBufferCreateInfo bi{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
     bi.size = size;
     bi.usage = usage;
     bi.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // CONCURRENT namiesto ownership transferu (release/acquire bariery na oboch queue)
+    const uint32_t families[2] = { ctx.graphicsQueueFamily, ctx.transferQueueFamily };
+    if (sharedWithTransfer && families[0] != families[1]) {
+        bi.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bi.queueFamilyIndexCount = 2;
+        bi.pQueueFamilyIndices = families;
+    }
     if (vkCreateBuffer(ctx.device, &bi, nullptr, &buf) != VK_SUCCESS) return false;
 
     VkMemoryRequirements req{};
@@ -734,6 +856,21 @@ bool copyBuffer(VulkanContext& ctx, VkBuffer src, VkBuffer dst, VkDeviceSize siz
     return true;
 }
 
+bool copyBufferRegions(VulkanContext& ctx, VkBuffer src, VkBuffer dst,
+    const VkBufferCopy* regions, uint32_t count) {
+    if (count == 0) return true;
+    VkCommandBuffer cmd = beginOneShot(ctx);
+    // dst sa prepisuje na mieste => pockaj, kym ho skor odoslane drawy docitaju
+    VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    mb.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    mb.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &mb, 0, nullptr, 0, nullptr);
+    vkCmdCopyBuffer(cmd, src, dst, count, regions);
+    endOneShot(ctx, cmd);
+    return true;
+}
+
 bool uploadVoxelMesh(VulkanContext& ctx, const std::vector<float>& verts,
     const std::vector<uint32_t>& indices) {
     ctx.indexCount = static_cast<uint32_t>(indices.size());
@@ -908,12 +1045,104 @@ bool createVoxelPipeline(VulkanContext& ctx, const std::string& shaderDir) {
 
     VkResult r = vkCreateGraphicsPipelines(ctx.device, VK_NULL_HANDLE, 1, &pci, nullptr, &ctx.voxelPipeline);
 
+    // Translucent variant (voda): rovnaky layout, alpha blend, depth test bez zapisu,
+    // bez cullingu (hladinu vidno aj zospodu). Alpha ide cez specialization constant 0.
+    if (r == VK_SUCCESS) {
+        const float alpha = 0.6f;
+        VkSpecializationMapEntry se{ 0, 0, sizeof(float) };
+        VkSpecializationInfo si{};
+        si.mapEntryCount = 1; si.pMapEntries = &se;
+        si.dataSize = sizeof(float); si.pData = &alpha;
+        VkPipelineShaderStageCreateInfo tstages[] = { vs, fs };
+        tstages[1].pSpecializationInfo = &si;
+
+        VkPipelineRasterizationStateCreateInfo trs = rs;
+        trs.cullMode = VK_CULL_MODE_NONE;
+        VkPipelineDepthStencilStateCreateInfo tds = ds;
+        tds.depthWriteEnable = VK_FALSE;
+        VkPipelineColorBlendAttachmentState tcba = cba;
+        tcba.blendEnable = VK_TRUE;
+        tcba.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        tcba.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        tcba.colorBlendOp = VK_BLEND_OP_ADD;
+        tcba.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        tcba.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        tcba.alphaBlendOp = VK_BLEND_OP_ADD;
+        VkPipelineColorBlendStateCreateInfo tcb = cb;
+        tcb.pAttachments = &tcba;
+
+        VkGraphicsPipelineCreateInfo tpci = pci;
+        tpci.pStages = tstages;
+        tpci.pRasterizationState = &trs;
+        tpci.pDepthStencilState = &tds;
+        tpci.pColorBlendState = &tcb;
+        r = vkCreateGraphicsPipelines(ctx.device, VK_NULL_HANDLE, 1, &tpci, nullptr, &ctx.voxelTranslucentPipeline);
+    }
+
+    // Depth prepass: len vertex stage (voxel.frag nema discard), bez zapisu farby
+    if (r == VK_SUCCESS) {
+        VkPipelineColorBlendAttachmentState dcba{};
+        dcba.colorWriteMask = 0;
+        VkPipelineColorBlendStateCreateInfo dcb = cb;
+        dcb.pAttachments = &dcba;
+
+        VkGraphicsPipelineCreateInfo dpci = pci;
+        dpci.stageCount = 1;
+        dpci.pColorBlendState = &dcb;
+        r = vkCreateGraphicsPipelines(ctx.device, VK_NULL_HANDLE, 1, &dpci, nullptr, &ctx.voxelDepthPipeline);
+    }
+    // farba po prepasse: hlbka uz je v bufferi, prejde len najblizsi fragment
+    VkPipelineDepthStencilStateCreateInfo eds = ds;
+    eds.depthWriteEnable = VK_FALSE;
+    eds.depthCompareOp = VK_COMPARE_OP_EQUAL;
+    if (r == VK_SUCCESS) {
+        VkGraphicsPipelineCreateInfo epci = pci;
+        epci.pDepthStencilState = &eds;
+        r = vkCreateGraphicsPipelines(ctx.device, VK_NULL_HANDLE, 1, &epci, nullptr, &ctx.voxelEqualPipeline);
+    }
+
+    // Overdraw (debug): specialization constant 1, aditivny blend; depth test ako farebna
+    // pipeline, ktoru nahradza => pocita fragmenty, ktore by sa naozaj tienovali
+    if (r == VK_SUCCESS) {
+        const VkBool32 overdraw = VK_TRUE;
+        VkSpecializationMapEntry se{ 1, 0, sizeof(VkBool32) };
+        VkSpecializationInfo si{};
+        si.mapEntryCount = 1; si.pMapEntries = &se;
+        si.dataSize = sizeof(VkBool32); si.pData = &overdraw;
+        VkPipelineShaderStageCreateInfo ostages[] = { vs, fs };
+        ostages[1].pSpecializationInfo = &si;
+
+        VkPipelineColorBlendAttachmentState ocba = cba;
+        ocba.blendEnable = VK_TRUE;
+        ocba.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        ocba.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        ocba.colorBlendOp = VK_BLEND_OP_ADD;
+        ocba.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        ocba.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        ocba.alphaBlendOp = VK_BLEND_OP_ADD;
+        VkPipelineColorBlendStateCreateInfo ocb = cb;
+        ocb.pAttachments = &ocba;
+
+        VkGraphicsPipelineCreateInfo opci = pci;
+        opci.pStages = ostages;
+        opci.pColorBlendState = &ocb;
+        for (int i = 0; i < 2 && r == VK_SUCCESS; ++i) {
+            opci.pDepthStencilState = i ? &eds : &ds;
+            r = vkCreateGraphicsPipelines(ctx.device, VK_NULL_HANDLE, 1, &opci, nullptr, &ctx.voxelOverdrawPipeline[i]);
+        }
+    }
+
     vkDestroyShaderModule(ctx.device, fmod, nullptr);
     vkDestroyShaderModule(ctx.device, vmod, nullptr);
     return r == VK_SUCCESS;
 }
 
 void destroyVoxelPipeline(VulkanContext& ctx) {
+    for (VkPipeline& p : ctx.voxelOverdrawPipeline)
+        if (p) { vkDestroyPipeline(ctx.device, p, nullptr); p = VK_NULL_HANDLE; }
+    if (ctx.voxelEqualPipeline) { vkDestroyPipeline(ctx.device, ctx.voxelEqualPipeline, nullptr); ctx.voxelEqualPipeline = VK_NULL_HANDLE; }
+    if (ctx.voxelDepthPipeline) { vkDestroyPipeline(ctx.device, ctx.voxelDepthPipeline, nullptr); ctx.voxelDepthPipeline = VK_NULL_HANDLE; }
+    if (ctx.voxelTranslucentPipeline) { vkDestroyPipeline(ctx.device, ctx.voxelTranslucentPipeline, nullptr); ctx.voxelTranslucentPipeline = VK_NULL_HANDLE; }
     if (ctx.voxelPipeline) { vkDestroyPipeline(ctx.device, ctx.voxelPipeline, nullptr); ctx.voxelPipeline = VK_NULL_HANDLE; }
     if (ctx.voxelPipelineLayout) { vkDestroyPipelineLayout(ctx.device, ctx.voxelPipelineLayout, nullptr); ctx.voxelPipelineLayout = VK_NULL_HANDLE; }
 }
@@ -1343,28 +1572,30 @@ static uint32_t findMemoryTypeOrInvalid(VkPhysicalDevice pd, uint32_t typeBits,
 bool createLightingUBO(VulkanContext& ctx) {
     ctx.lightingUBOSize = sizeof(LightingUBO);
 
-    // 1) Create host-visible, coherent UBO
-    if (!createBuffer(ctx,
-        ctx.lightingUBOSize,                         // size (VkDeviceSize)  not a pointer!
-        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,          // usage
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,        // props
-        ctx.lightingUBO,
-        ctx.lightingUBOMemory))
-    {
-        return false;
-    }
-
-    // 2) Write initial lighting values
+    // 2) Initial lighting values
     LightingUBO init{};
     init.sunDir = { 0.3f, -1.0f, 0.2f, 0.0f };
     init.sunColor = { 1.0f, 0.95f, 0.85f, 0.0f };
     init.ambient = { 0.20f, 0.22f, 0.25f, 0.0f };
 
-    void* dst = nullptr;
-    VK_CHECK(vkMapMemory(ctx.device, ctx.lightingUBOMemory, 0, ctx.lightingUBOSize, 0, &dst));
-    std::memcpy(dst, &init, sizeof(init));
-    vkUnmapMemory(ctx.device, ctx.lightingUBOMemory);
+    // 1) One host-visible, coherent UBO per frame slot (the overlay rewrites it every frame)
+    for (FrameResources& fr : ctx.frames) {
+        if (!createBuffer(ctx,
+            ctx.lightingUBOSize,                         // size (VkDeviceSize), not a pointer!
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,          // usage
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,        // props
+            fr.lightingUBO,
+            fr.lightingUBOMemory))
+        {
+            return false;
+        }
+
+        void* dst = nullptr;
+        VK_CHECK(vkMapMemory(ctx.device, fr.lightingUBOMemory, 0, ctx.lightingUBOSize, 0, &dst));
+        std::memcpy(dst, &init, sizeof(init));
+        vkUnmapMemory(ctx.device, fr.lightingUBOMemory);
+    }
 
     return true;
 }
@@ -1579,9 +1810,11 @@ bool createDescriptors(VulkanContext& ctx) {
     ai.descriptorSetCount = 1;
     ai.pSetLayouts = &ctx.descSetLayout;
 
-    if (vkAllocateDescriptorSets(ctx.device, &ai, &ctx.descSet) != VK_SUCCESS) {
-        std::fprintf(stderr, "Fatal: allocate descriptor set failed\n");
-        return false;
+    for (FrameResources& fr : ctx.frames) {
+        if (vkAllocateDescriptorSets(ctx.device, &ai, &fr.descSet) != VK_SUCCESS) {
+            std::fprintf(stderr, "Fatal: allocate descriptor set failed\n");
+            return false;
+        }
     }
 
     // 4) Update set  REQUIRE valid ctx.materialUBO here
@@ -1600,34 +1833,37 @@ bool createDescriptors(VulkanContext& ctx) {
     uboMat.offset = 0;
     uboMat.range = ctx.materialUBOSize ? ctx.materialUBOSize : sizeof(Material);
 
-    VkDescriptorBufferInfo uboLight{};
-    uboLight.buffer = ctx.lightingUBO;
-    uboLight.offset = 0;
-    uboLight.range = ctx.lightingUBOSize;
-
-    VkWriteDescriptorSet writes[3]{};
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = ctx.descSet;
-    writes[0].dstBinding = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    writes[0].descriptorCount = 1;
-    writes[0].pImageInfo = &ii;
-
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = ctx.descSet;
-    writes[1].dstBinding = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[1].descriptorCount = 1;
-    writes[1].pBufferInfo = &uboMat;
-
-    VkWriteDescriptorSet w2{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-    writes[2].dstSet = ctx.descSet;
-    writes[2].dstBinding = 2;
-    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[2].descriptorCount = 1;
-    writes[2].pBufferInfo = &uboLight;
-
-    vkUpdateDescriptorSets(ctx.device, 3, writes, 0, nullptr);
+    // same atlas + materials in every slot, lighting UBO of that slot
+    for (FrameResources& fr : ctx.frames) {
+        VkDescriptorBufferInfo uboLight{};
+        uboLight.buffer = fr.lightingUBO;
+        uboLight.offset = 0;
+        uboLight.range = ctx.lightingUBOSize;
+
+        VkWriteDescriptorSet writes[3]{};
+        writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet = fr.descSet;
+        writes[0].dstBinding = 0;
+        writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[0].descriptorCount = 1;
+        writes[0].pImageInfo = &ii;
+
+        writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet = fr.descSet;
+        writes[1].dstBinding = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[1].descriptorCount = 1;
+        writes[1].pBufferInfo = &uboMat;
+
+        writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[2].dstSet = fr.descSet;
+        writes[2].dstBinding = 2;
+        writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writes[2].descriptorCount = 1;
+        writes[2].pBufferInfo = &uboLight;
+
+        vkUpdateDescriptorSets(ctx.device, 3, writes, 0, nullptr);
+    }
     return true;
 }
 
@@ -1679,10 +1915,15 @@ bool createDepthResources(VulkanContext& ctx, uint32_t width, uint32_t height) {
     // Pick a supported depth format (also stores ctx.depthFormat)
     VkFormat fmt = findDepthFormat(ctx);
 
+    // HiZPyramid cita depth v compute => SAMPLED, ak to format vie
+    VkFormatProperties fp{};
+    vkGetPhysicalDeviceFormatProperties(ctx.physicalDevice, fmt, &fp);
+    ctx.depthSampled = (fp.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+
     // Create depth image (device-local)
     if (!createImage(ctx, width, height, fmt,
         VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (ctx.depthSampled ? VK_IMAGE_USAGE_SAMPLED_BIT : 0),
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         /*mipLevels*/ 1,
         ctx.depthImage, ctx.depthMemory)) {
@@ -1709,10 +1950,21 @@ bool createDepthResources(VulkanContext& ctx, uint32_t width, uint32_t height) {
         std::cerr << "[VK] Depth: vkCreateImageView failed, r=" << (int)r << "\n";
         return false;
     }
+
+    // samplovany view smie mat len jeden aspekt
+    if (ctx.depthSampled) {
+        iv.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        if (vkCreateImageView(ctx.device, &iv, nullptr, &ctx.depthSampleView) != VK_SUCCESS) {
+            ctx.depthSampleView = VK_NULL_HANDLE;
+            ctx.depthSampled = false;
+        }
+    }
+    return true;
 }
 
 void destroyDepthResources(VulkanContext& ctx) {
     if (ctx.depthView) { vkDestroyImageView(ctx.device, ctx.depthView, nullptr); ctx.depthView = VK_NULL_HANDLE; }
+    if (ctx.depthSampleView) { vkDestroyImageView(ctx.device, ctx.depthSampleView, nullptr); ctx.depthSampleView = VK_NULL_HANDLE; }
     if (ctx.depthImage) { vkDestroyImage(ctx.device, ctx.depthImage, nullptr);    ctx.depthImage = VK_NULL_HANDLE; }
     if (ctx.depthMemory) { vkFreeMemory(ctx.device, ctx.depthMemory, nullptr);     ctx.depthMemory = VK_NULL_HANDLE; }
 }
@@ -1759,15 +2011,17 @@ bool recreateAtlasSampler(VulkanContext& ctx, float anisoLevel) {
     ii.imageView = ctx.atlasView;
     ii.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-    VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-    write.dstSet = ctx.descSet;
-    write.dstBinding = 0;
-    write.dstArrayElement = 0;
-    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    write.descriptorCount = 1;
-    write.pImageInfo = &ii;
+    for (FrameResources& fr : ctx.frames) {
+        VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = fr.descSet;
+        write.dstBinding = 0;
+        write.dstArrayElement = 0;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &ii;
 
-    vkUpdateDescriptorSets(ctx.device, 1, &write, 0, nullptr);
+        vkUpdateDescriptorSets(ctx.device, 1, &write, 0, nullptr);
+    }
 
     // Destroy the old sampler (now its guaranteed not in use)
     if (ctx.atlasSampler) vkDestroySampler(ctx.device, ctx.atlasSampler, nullptr);
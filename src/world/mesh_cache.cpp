@@ -0,0 +1,359 @@
+#include "world/mesh_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// --- hash: 64-bit slova (4 voxely naraz), FNV-style nasobenie + splitmix finalizer ---
+static inline uint64_t hashWord(uint64_t h, uint64_t w) {
+    h ^= w;
+    h *= 0x100000001b3ull;
+    h ^= h >> 29;
+    return h;
+}
+static inline uint64_t finalize64(uint64_t h) {
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27; h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return h;
+}
+
+uint64_t meshCacheKey(const MeshVolume& vol, const MeshBox& box, int lod, int cx, int cy, int cz)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    const int32_t head[] = { (int32_t)MESHER_VERSION, lod, cx, cy, cz,
+        box.x0, box.y0, box.z0, box.x1, box.y1, box.z1,
+        vol.ox, vol.oy, vol.oz, vol.sx, vol.sy, vol.sz };
+    for (int32_t v : head) h = hashWord(h, (uint64_t)(uint32_t)v);
+
+    const BlockID* p = vol.cells.data();
+    const size_t n = vol.cells.size();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint64_t w;
+        std::memcpy(&w, p + i, sizeof(w));
+        h = hashWord(h, w);
+    }
+    for (; i < n; ++i) h = hashWord(h, p[i]);
+    return finalize64(h ^ n);
+}
+
+// --- disk format (.vmc, little-endian) ---
+#pragma pack(push, 1)
+struct MeshCacheFileHeader {
+    char     magic[4];          // "VMC1"
+    uint32_t mesherVersion;
+    uint64_t key;
+    float    meshMs;
+    uint32_t vertexFloats;
+    uint32_t indexCount;
+    uint32_t opaqueIndexCount;
+    uint32_t dirIndexCount[FACE_DIR_COUNT];
+    float    aabbMin[3], aabbMax[3];
+};
+#pragma pack(pop)
+
+static std::string cachePath(const std::string& dir, uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.vmc", (unsigned long long)key);
+    return (std::filesystem::path(dir) / name).string();
+}
+
+static uint64_t meshBytes(const MeshData& m) {
+    return m.vertices.size() * sizeof(float) + m.indices.size() * sizeof(uint32_t) + sizeof(MeshData);
+}
+
+bool MeshCache::readDisk(const std::string& dir, uint64_t key, Entry& e) const
+{
+    std::ifstream f(cachePath(dir, key), std::ios::binary);
+    if (!f) return false;
+    MeshCacheFileHeader hdr{};
+    if (!f.read((char*)&hdr, sizeof(hdr))) return false;
+    if (std::memcmp(hdr.magic, "VMC1", 4) != 0 || hdr.mesherVersion != MESHER_VERSION || hdr.key != key)
+        return false;
+
+    e.key = key;
+    e.meshMs = hdr.meshMs;
+    e.mesh.vertices.resize(hdr.vertexFloats);
+    e.mesh.indices.resize(hdr.indexCount);
+    e.mesh.opaqueIndexCount = hdr.opaqueIndexCount;
+    for (int d = 0; d < FACE_DIR_COUNT; ++d) e.mesh.dirIndexCount[d] = hdr.dirIndexCount[d];
+    for (int a = 0; a < 3; ++a) { e.mesh.aabbMin[a] = hdr.aabbMin[a]; e.mesh.aabbMax[a] = hdr.aabbMax[a]; }
+    if (!f.read((char*)e.mesh.vertices.data(), std::streamsize(hdr.vertexFloats * sizeof(float))) ||
+        !f.read((char*)e.mesh.indices.data(), std::streamsize(hdr.indexCount * sizeof(uint32_t))))
+        return false;
+    e.bytes = meshBytes(e.mesh);
+    return true;
+}
+
+bool MeshCache::writeDisk(const std::string& dir, const Entry& e) const
+{
+    // zapis do .tmp a premenuj, nech iny worker/proces nikdy nevidi polovicny subor
+    const std::string path = cachePath(dir, e.key);
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        if (!f) return false;
+        MeshCacheFileHeader hdr{};
+        std::memcpy(hdr.magic, "VMC1", 4);
+        hdr.mesherVersion = MESHER_VERSION;
+        hdr.key = e.key;
+        hdr.meshMs = e.meshMs;
+        hdr.vertexFloats = (uint32_t)e.mesh.vertices.size();
+        hdr.indexCount = (uint32_t)e.mesh.indices.size();
+        hdr.opaqueIndexCount = e.mesh.opaqueIndexCount;
+        for (int d = 0; d < FACE_DIR_COUNT; ++d) hdr.dirIndexCount[d] = e.mesh.dirIndexCount[d];
+        for (int a = 0; a < 3; ++a) { hdr.aabbMin[a] = e.mesh.aabbMin[a]; hdr.aabbMax[a] = e.mesh.aabbMax[a]; }
+        f.write((const char*)&hdr, sizeof(hdr));
+        f.write((const char*)e.mesh.vertices.data(), std::streamsize(e.mesh.vertices.size() * sizeof(float)));
+        f.write((const char*)e.mesh.indices.data(), std::streamsize(e.mesh.indices.size() * sizeof(uint32_t)));
+        if (!f) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) { std::filesystem::remove(tmp, ec); return false; }
+    return true;
+}
+
+void MeshCache::setBudget(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    budget = bytes;
+    while (!lru.empty() && st.bytes > budget) {
+        st.bytes -= lru.back().bytes;
+        index.erase(lru.back().key);
+        lru.pop_back();
+        ++st.evictions;
+    }
+}
+
+void MeshCache::touchDiskLocked(uint64_t key, uint64_t bytes)
+{
+    auto it = diskIndex.find(key);
+    if (it != diskIndex.end()) {
+        st.diskUsed -= it->second->bytes;
+        it->second->bytes = bytes;
+        diskLru.splice(diskLru.begin(), diskLru, it->second);
+    }
+    else {
+        diskLru.push_front({ key, bytes });
+        diskIndex[key] = diskLru.begin();
+    }
+    st.diskUsed += bytes;
+}
+
+void MeshCache::evictDiskLocked(std::vector<uint64_t>& victims)
+{
+    while (!diskLru.empty() && st.diskUsed > diskBudget) {
+        st.diskUsed -= diskLru.back().bytes;
+        victims.push_back(diskLru.back().key);
+        diskIndex.erase(diskLru.back().key);
+        diskLru.pop_back();
+        ++st.diskEvictions;
+    }
+}
+
+void MeshCache::removeDisk(const std::string& dir, const std::vector<uint64_t>& victims) const
+{
+    std::error_code ec;
+    for (uint64_t key : victims) std::filesystem::remove(cachePath(dir, key), ec);
+}
+
+void MeshCache::setDiskDir(const std::string& dir)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!dir.empty() && !fs::exists(dir, ec) && !fs::create_directories(dir, ec)) {
+        fprintf(stderr, "[MeshCache] cannot create '%s': %s (disk cache off)\n", dir.c_str(), ec.message().c_str());
+        std::lock_guard<std::mutex> lk(mtx);
+        diskDir.clear();
+        diskLru.clear();
+        diskIndex.clear();
+        st.diskUsed = 0;
+        return;
+    }
+
+    // index mimo zamku (vola sa pri starte pred prvym streamovanim, ziadny mesh job este nebezi):
+    // hlavicky suborov, ina MESHER_VERSION, cudzie meno alebo polovicny .tmp ide prec
+    struct Found {
+        fs::file_time_type time;
+        DiskFile file;
+    };
+    std::vector<Found> found;
+    uint64_t stale = 0;
+    if (!dir.empty())
+        for (const fs::directory_entry& de : fs::directory_iterator(dir, ec)) {
+            const fs::path& p = de.path();
+            std::error_code fec;
+            if (p.extension() == ".tmp") { fs::remove(p, fec); continue; }
+            if (p.extension() != ".vmc") continue;
+            MeshCacheFileHeader hdr{};
+            bool ok;
+            {
+                std::ifstream f(p, std::ios::binary);
+                ok = f.read((char*)&hdr, sizeof(hdr)) && std::memcmp(hdr.magic, "VMC1", 4) == 0 &&
+                     hdr.mesherVersion == MESHER_VERSION &&
+                     fs::path(cachePath(dir, hdr.key)).filename() == p.filename();
+            }
+            Found fd;
+            if (ok) {
+                fd.time = de.last_write_time(fec);
+                fd.file.key = hdr.key;
+                fd.file.bytes = de.file_size(fec);
+                ok = !fec;
+            }
+            if (!ok) { fs::remove(p, fec); ++stale; continue; }
+            found.push_back(fd);
+        }
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time > b.time; });
+
+    std::vector<uint64_t> victims;
+    uint64_t used = 0, cap = 0;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        diskDir = dir;
+        diskLru.clear();
+        diskIndex.clear();
+        st.diskUsed = 0;
+        st.diskEvictions += stale;
+        for (const Found& fd : found) {   // od najnovsieho => back je najstarsi
+            diskLru.push_back(fd.file);
+            diskIndex[fd.file.key] = std::prev(diskLru.end());
+            st.diskUsed += fd.file.bytes;
+        }
+        evictDiskLocked(victims);
+        used = st.diskUsed;
+        cap = diskBudget;
+    }
+    removeDisk(dir, victims);
+    if (!dir.empty())
+        printf("[MeshCache] disk '%s': %zu files %.1f MB (budget %.0f MB), %llu stale + %zu over budget removed\n",
+            dir.c_str(), found.size() - victims.size(), used / (1024.0 * 1024.0),
+            cap / (1024.0 * 1024.0), (unsigned long long)stale, victims.size());
+}
+
+void MeshCache::setDiskBudget(uint64_t bytes)
+{
+    std::vector<uint64_t> victims;
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        diskBudget = bytes;
+        evictDiskLocked(victims);
+        dir = diskDir;
+    }
+    if (!dir.empty()) removeDisk(dir, victims);
+}
+
+void MeshCache::insertLocked(Entry&& e)
+{
+    auto it = index.find(e.key);
+    if (it != index.end()) {
+        st.bytes -= it->second->bytes;
+        lru.erase(it->second);
+        index.erase(it);
+    }
+    st.bytes += e.bytes;
+    lru.push_front(std::move(e));
+    index[lru.front().key] = lru.begin();
+    while (lru.size() > 1 && st.bytes > budget) {
+        st.bytes -= lru.back().bytes;
+        index.erase(lru.back().key);
+        lru.pop_back();
+        ++st.evictions;
+    }
+}
+
+bool MeshCache::lookup(uint64_t key, MeshData& out, float& meshMs)
+{
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (budget == 0) return false;
+        ++st.lookups;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            out = it->second->mesh;
+            meshMs = it->second->meshMs;
+            ++st.hits;
+            return true;
+        }
+        // len zaindexovane subory => miss neotvara subor
+        if (diskIndex.find(key) == diskIndex.end()) return false;
+        dir = diskDir;
+    }
+    if (dir.empty()) return false;
+
+    // disk mimo zamku; nacitany zaznam ide aj do pamate
+    Entry e;
+    if (!readDisk(dir, key, e)) {
+        // zmazany / poskodeny medzicasom => vyrad z indexu
+        std::lock_guard<std::mutex> lk(mtx);
+        auto it = diskIndex.find(key);
+        if (it != diskIndex.end()) {
+            st.diskUsed -= it->second->bytes;
+            diskLru.erase(it->second);
+            diskIndex.erase(it);
+        }
+        return false;
+    }
+    // cas zapisu je poradie LRU aj po restarte (setDiskDir)
+    std::error_code ec;
+    std::filesystem::last_write_time(cachePath(dir, key), std::filesystem::file_time_type::clock::now(), ec);
+    out = e.mesh;
+    meshMs = e.meshMs;
+    std::lock_guard<std::mutex> lk(mtx);
+    ++st.hits;
+    ++st.diskHits;
+    auto it = diskIndex.find(key);
+    if (it != diskIndex.end()) diskLru.splice(diskLru.begin(), diskLru, it->second);
+    insertLocked(std::move(e));
+    return true;
+}
+
+void MeshCache::insert(uint64_t key, const MeshData& mesh, float meshMs)
+{
+    Entry e;
+    e.key = key;
+    e.mesh = mesh;
+    e.meshMs = meshMs;
+    e.bytes = meshBytes(mesh);
+
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (budget == 0) return;
+        if (diskIndex.find(key) == diskIndex.end()) dir = diskDir;   // uz na disku => nezapisuj znova
+    }
+    const bool wrote = !dir.empty() && writeDisk(dir, e);
+    const uint64_t fileBytes = sizeof(MeshCacheFileHeader) + e.bytes - sizeof(MeshData);
+
+    std::vector<uint64_t> victims;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        ++st.inserts;
+        if (wrote) {
+            st.diskBytes += fileBytes;
+            touchDiskLocked(key, fileBytes);
+            evictDiskLocked(victims);
+        }
+        insertLocked(std::move(e));
+    }
+    if (!victims.empty()) removeDisk(dir, victims);
+}
+
+void MeshCache::clear()
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    lru.clear();
+    index.clear();
+    st.bytes = 0;
+}
+
+MeshCacheStats MeshCache::stats() const
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    return st;
+}
@@ -0,0 +1,139 @@
+#include "world/mesh_workers.hpp"
+#include "world/mesher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+MeshWorkerPool::~MeshWorkerPool() {
+    stop();
+}
+
+void MeshWorkerPool::start(int n) {
+    if (!threads.empty()) return;
+    if (n <= 0) {
+        int hw = (int)std::thread::hardware_concurrency();
+        n = std::max(1, hw - 1); // jedno jadro nechaj render loopu
+    }
+    quit = false;
+    threads.reserve(n);
+    for (int i = 0; i < n; ++i)
+        threads.emplace_back([this] { workerMain(); });
+    printf("[Mesh] %d worker thread(s)\n", n);
+}
+
+void MeshWorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        quit = true;
+        jobs.clear();
+    }
+    cvJob.notify_all();
+    for (auto& t : threads) if (t.joinable()) t.join();
+    threads.clear();
+}
+
+void MeshWorkerPool::submit(MeshJob job) {
+    if (threads.empty()) start();
+    ++stats.submitted;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        for (auto& j : jobs) {
+            if (j.cx == job.cx && j.cy == job.cy && j.cz == job.cz && j.part == job.part) {
+                j = std::move(job);   // este nezacala => netreba meshovat staru verziu
+                ++stats.replaced;
+                return;
+            }
+        }
+        jobs.push_back(std::move(job));
+    }
+    cvJob.notify_one();
+}
+
+size_t MeshWorkerPool::drain(std::vector<MeshResult>& out) {
+    std::lock_guard<std::mutex> lk(mtx);
+    size_t n = done.size();
+    for (auto& r : done) {
+        stats.lastMs = r.ms;
+        stats.totalMs += r.ms;
+        stats.quads += r.quads;
+        stats.allocs += r.allocs;
+        if (r.cacheHit) { ++stats.cacheHits; stats.cacheMsSaved += r.savedMs; }
+        out.push_back(std::move(r));
+    }
+    done.clear();
+    stats.completed += n;
+    return n;
+}
+
+void MeshWorkerPool::waitIdle() {
+    std::unique_lock<std::mutex> lk(mtx);
+    cvIdle.wait(lk, [this] { return jobs.empty() && busy == 0; });
+}
+
+size_t MeshWorkerPool::pending() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return jobs.size() + (size_t)busy;
+}
+
+void MeshWorkerPool::workerMain() {
+    for (;;) {
+        MeshJob job;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cvJob.wait(lk, [this] { return quit || !jobs.empty(); });
+            if (quit) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            ++busy;
+        }
+
+        MeshResult r;
+        r.cx = job.cx; r.cy = job.cy; r.cz = job.cz;
+        r.part = job.part;
+        r.version = job.version;
+
+        // mesher spocita quady a zapise rovno do presne velkeho r.mesh (2 alokacie,
+        // scratch je per-thread), takze netreba arenu ani kopiu von
+        auto t0 = std::chrono::high_resolution_clock::now();
+        uint64_t key = 0;
+        float cachedMs = 0.0f;
+        if (job.cache) {
+            key = meshCacheKey(*job.volume, job.box, job.lod, job.cx, job.cy, job.cz);
+            r.cacheHit = job.cache->lookup(key, r.mesh, cachedMs);
+        }
+        if (r.cacheHit) {
+            auto t1 = std::chrono::high_resolution_clock::now();
+            r.quads = (uint32_t)(r.mesh.indices.size() / 6);
+            r.ms = std::chrono::duration<float, std::milli>(t1 - t0).count();
+            r.savedMs = std::max(0.0f, cachedMs - r.ms);
+        }
+        else {
+            MeshEmitStats es;
+            if (job.lod > 0) meshVolumeLodInto(*job.volume, job.box, job.lod, job.cx, job.cy, job.cz, r.mesh, &es);
+            else             meshVolumeInto(*job.volume, job.box, job.cx, job.cy, job.cz, r.mesh, &es);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            r.quads = es.quads;
+            r.allocs = es.allocs;
+            r.ms = std::chrono::duration<float, std::milli>(t1 - t0).count();
+            if (job.cache) job.cache->insert(key, r.mesh, r.ms);
+        }
+
+        // prepojenie stien sekcie pre cave culling (snapshot regionu ju pokryva celu aj s rimami)
+        if (job.section >= 0) {
+            const int rx = job.section % REGIONS_X;
+            const int rz = (job.section / REGIONS_X) % REGIONS_Z;
+            const int ry = job.section / (REGIONS_X * REGIONS_Z);
+            r.section = job.section;
+            r.sectionConn = sectionConnectivity(*job.volume, rx * REGION_SIZE, ry * REGION_SIZE, rz * REGION_SIZE);
+        }
+
+        job.volume.reset(); // uvolni snapshot este mimo zamku
+
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            done.push_back(std::move(r));
+            --busy;
+            if (jobs.empty() && busy == 0) cvIdle.notify_all();
+        }
+    }
+}
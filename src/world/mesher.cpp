@@ -1,25 +1,34 @@
 #include "world/mesher.hpp"
 #include "world/world_config.hpp"
+#include "world/block_props.hpp"
 #include <vector>
 #include <array>
 #include <algorithm>
 #include <cstdint>
 
 static inline bool isAir(BlockID id) { return id == 0; }
-static inline bool isSolid(BlockID id) { return id != 0; }
 
-// --- Ambient Occlusion helpers ---
-static inline int occ(const Chunk& c, int x, int y, int z) {
-    // solid? adapt if your "air" id differs
-    return c.get(x, y, z) != BLOCK_AIR;
+// Stena bloku a smerom k susedovi b. Opaque blok je vidno cez vsetko, co nie je opaque;
+// priesvitny len do vzduchu alebo inej priesvitnej latky => voda-voda ani voda-kamen
+// sa nekresli a z oceanu ostane iba hladina (dno kresli opaque strana).
+static inline bool showsFace(BlockID a, BlockID b) {
+    if (isAir(a) || blockOpaque(b)) return false;
+    return blockOpaque(a) || a != b;
 }
 
-// Bounds-safe occupancy for AO
-static inline int occSafe(const Chunk& c, int x, int y, int z) {
-    if (x < 0 || y < 0 || z < 0 ||
-        x >= CHUNK_SIZE || y >= CHUNK_HEIGHT || z >= CHUNK_SIZE) return 0;
-    return c.get(x, y, z) != BLOCK_AIR;
-}
+// --- Voxel sources for the greedy core ---
+// Chunk bez susedov: mimo chunku je vzduch
+struct ChunkGet {
+    const Chunk& c;
+    BlockID operator()(int x, int y, int z) const { return inChunk(x, y, z) ? c.get(x, y, z) : BLOCK_AIR; }
+};
+// Padded snapshot (vlastny chunk + okraj susedov)
+struct VolumeGet {
+    const MeshVolume& v;
+    BlockID operator()(int x, int y, int z) const { return v.get(x, y, z); }
+};
+
+// --- Ambient Occlusion helpers ---
 
 // Map 0..3 occluders ? AO factor (tweak to taste)
 static inline float aoFactor(int side1, int side2, int corner) {
@@ -56,60 +65,60 @@ static inline void pickTile(BlockID id, int /*faceDir*/, int /*axis*/, float& ti
     tileV = ty * (1.0f / float(ATLAS_N));
 }
 
+// Jeden greedy obdlznik z prveho prechodu; vertexy sa z neho pisu az ked vieme presny pocet
+struct QuadRec {
+    BlockID id;
+    int8_t  axis, faceDir;   // 0=x,1=y,2=z ; +1/-1
+    int16_t k;               // slice index (between k-1 and k)
+    int16_t i0, j0;          // start in plane (u,v)
+    int16_t du, dv;          // width/height in voxels
+    uint8_t ao;              // 8-susedstvo na vzduchovej strane (rovnake pre cely quad)
+};
+
+// AO bajt: bity = opaque susedia bunky v rovine vzduchovej vrstvy (du,dv okolo stredu)
+//   bit0 (-1,-1)  bit1 (0,-1)  bit2 (+1,-1)
+//   bit3 (-1, 0)               bit4 (+1, 0)
+//   bit5 (-1,+1)  bit6 (0,+1)  bit7 (+1,+1)
+// Tabulka -> AO faktor pre 4 rohy v poradi ij[] vo writeQuad: (0,0) (0,dv) (du,dv) (du,0)
+struct AoCorners { float c[4]; };
+static const std::array<AoCorners, 256> AO_TABLE = [] {
+    std::array<AoCorners, 256> t{};
+    for (int b = 0; b < 256; ++b) {
+        auto bit = [b](int i) { return (b >> i) & 1; };
+        t[b].c[0] = aoFactor(bit(3), bit(1), bit(0));
+        t[b].c[1] = aoFactor(bit(3), bit(6), bit(5));
+        t[b].c[2] = aoFactor(bit(4), bit(6), bit(7));
+        t[b].c[3] = aoFactor(bit(4), bit(1), bit(2));
+    }
+    return t;
+}();
+
+static constexpr int VERT_FLOATS = 11;   // pos3 normal3 uv2 tile2 ao1
+
 // Vype jeden ve?k obd?nik (du x dv voxelov) na hranici slice-u k.
+// Pise priamo na finalne miesto (vp: 4*11 floatov, ip: 6 indexov), uz aj s world offsetom.
 // Pozcie sedia s tvojm starm +/-0.5 layoutom.
-static inline void emitQuad(class MeshData& m, const Chunk& chunk,
-    int axis, int faceDir,        // 0=x,1=y,2=z ; +1/-1
-    int k,                        // slice index (between k-1 and k)
-    int i0, int j0,               // start in plane (u,v)
-    int du, int dv,               // width/height in voxels
-    float tileU, float tileV)
+// scale = kolko voxelov ma jedna bunka mriezky (LOD: 2/4/8, inak 1)
+static inline void writeQuad(float* vp, uint32_t* ip, uint32_t base,
+    const QuadRec& q, const float off[3], int scale)
 {
     static constexpr float VOXEL_SCALE = 0.25f;
 
+    const int axis = q.axis, faceDir = q.faceDir, k = q.k;
+    const int i0 = q.i0, j0 = q.j0, du = q.du, dv = q.dv;
+
     // In-plane axes
     int u = (axis + 1) % 3;
     int v = (axis + 2) % 3;
 
-    // Index of the "solid" layer along the slicing axis (see how faceDir is chosen in your mask)
-    const int solidLayer = (faceDir > 0) ? (k - 1) : (k);
+    float tileU, tileV;
+    pickTile(q.id, faceDir, axis, tileU, tileV);
 
-    // Helper to translate (iu,iv,axisLayer) into (x,y,z)
-    auto pack = [&](int iu, int iv, int axVal, int& X, int& Y, int& Z) {
-        int a[3]; a[axis] = axVal; a[u] = iu; a[v] = iv; X = a[0]; Y = a[1]; Z = a[2];
-        };
-
-    // AO for a corner: look at two orthogonal neighbors + the diagonal on the SOLID side
-    auto cornerAO = [&](int iu0, int iv0, int duSign, int dvSign)->float {
-        int Xs, Ys, Zs;
-        int s1x, s1y, s1z; // neighbor along +/?u
-        int s2x, s2y, s2z; // neighbor along +/?v
-        int crx, cry, crz; // diagonal (+/?u, +/?v)
-
-        pack(iu0, iv0, solidLayer, Xs, Ys, Zs);
-        pack(iu0 + duSign, iv0, solidLayer, s1x, s1y, s1z);
-        pack(iu0, iv0 + dvSign, solidLayer, s2x, s2y, s2z);
-        pack(iu0 + duSign, iv0 + dvSign, solidLayer, crx, cry, crz);
-
-        int s1 = occSafe(chunk, s1x, s1y, s1z);
-        int s2 = occSafe(chunk, s2x, s2y, s2z);
-        int cr = occSafe(chunk, crx, cry, crz);
-        // Map 0..3 occluders ? AO factor (reuse your aoFactor)
-        return aoFactor(s1, s2, cr);
-        };
-
-    // AO for the 4 quad corners (match the same corner order as ij[])
-    // ij[] = { {0,0}, {0,dv}, {du,dv}, {du,0} }
-    float ao00 = cornerAO(i0, j0, -1, -1); // (0,0)   bottom-left
-    float ao0V = cornerAO(i0, j0 + dv - 1, -1, +1); // (0,dv)  top-left
-    float aoUV = cornerAO(i0 + du - 1, j0 + dv - 1, +1, +1); // (du,dv) top-right
-    float aoU0 = cornerAO(i0 + du - 1, j0, +1, -1); // (du,0)  bottom-right
-
-    // Map those AO values to the vertex emit order
-    float aoCorner[4] = { ao00, ao0V, aoUV, aoU0 };
+    // AO rohov z bajtu susedstva (greedy zlucuje len bunky s rovnakym bajtom)
+    const float* aoCorner = AO_TABLE[q.ao].c;
 
     // Fixed plane coordinate at the face
-    const float plane = ((float)k - 0.5f) * VOXEL_SCALE;
+    const float plane = ((float)(k * scale) - 0.5f) * VOXEL_SCALE;
 
     // Normal
     float nx = 0, ny = 0, nz = 0;
@@ -121,91 +130,138 @@ static inline void emitQuad(class MeshData& m, const Chunk& chunk,
     int ij[4][2] = { {0,0},{0,dv},{du,dv},{du,0} };
 
     // 4 vertices: pos3 normal3 uv2 tile2 + AO(1) => 11 floats
-    uint32_t base = static_cast<uint32_t>(m.vertices.size() / 11);
-    for (int idx = 0; idx < 4; ++idx) {
+    for (int idx = 0; idx < 4; ++idx, vp += VERT_FLOATS) {
         int offU = ij[idx][0];
         int offV = ij[idx][1];
 
         float pos[3];
         pos[axis] = plane;
-        pos[u] = ((float)(i0 + offU) - 0.5f) * VOXEL_SCALE;
-        pos[v] = ((float)(j0 + offV) - 0.5f) * VOXEL_SCALE;
+        pos[u] = ((float)((i0 + offU) * scale) - 0.5f) * VOXEL_SCALE;
+        pos[v] = ((float)((j0 + offV) * scale) - 0.5f) * VOXEL_SCALE;
 
-        // pos
-        m.vertices.push_back(pos[0]);
-        m.vertices.push_back(pos[1]);
-        m.vertices.push_back(pos[2]);
+        // pos (world space)
+        vp[0] = pos[0] + off[0];
+        vp[1] = pos[1] + off[1];
+        vp[2] = pos[2] + off[2];
         // normal
-        m.vertices.push_back(nx);
-        m.vertices.push_back(ny);
-        m.vertices.push_back(nz);
-        // uv in voxel units (0..du, 0..dv)
-        m.vertices.push_back((float)offU);
-        m.vertices.push_back((float)offV);
+        vp[3] = nx; vp[4] = ny; vp[5] = nz;
+        // uv in voxel units (0..du, 0..dv), LOD bunka = scale voxelov
+        vp[6] = (float)(offU * scale);
+        vp[7] = (float)(offV * scale);
         // tile offset (atlas cell)
-        m.vertices.push_back(tileU);
-        m.vertices.push_back(tileV);
-        // NEW: AO
-        m.vertices.push_back(aoCorner[idx]);
+        vp[8] = tileU;
+        vp[9] = tileV;
+        // AO
+        vp[10] = aoCorner[idx];
     }
 
     // indices (same winding you already had)
     if (faceDir > 0) {
-        m.indices.push_back(base + 0); m.indices.push_back(base + 1); m.indices.push_back(base + 2);
-        m.indices.push_back(base + 0); m.indices.push_back(base + 2); m.indices.push_back(base + 3);
+        ip[0] = base + 0; ip[1] = base + 1; ip[2] = base + 2;
+        ip[3] = base + 0; ip[4] = base + 2; ip[5] = base + 3;
     }
     else {
-        m.indices.push_back(base + 0); m.indices.push_back(base + 2); m.indices.push_back(base + 1);
-        m.indices.push_back(base + 0); m.indices.push_back(base + 3); m.indices.push_back(base + 2);
+        ip[0] = base + 0; ip[1] = base + 2; ip[2] = base + 1;
+        ip[3] = base + 0; ip[4] = base + 3; ip[5] = base + 2;
     }
 }
 
 struct MaskCell {
     BlockID id{};
     int8_t  faceDir{}; // +1 alebo -1 (0 = ni?)
+    uint8_t ao{};      // AO bajt susedstva (len pre faceDir != 0)
 };
 
 static inline bool sameCell(const MaskCell& a, const MaskCell& b) {
-    return a.id == b.id && a.faceDir == b.faceDir;
+    return a.id == b.id && a.faceDir == b.faceDir && a.ao == b.ao;
 }
 
 // Greedy mesher  nahrdza pvodn meshChunk
-MeshData meshChunk(const Chunk& c) {
-    MeshData out;
-    out.vertices.clear(); out.indices.clear();
+// Ohranien na box [lo,hi) v loklnych sradniciach chunku. Box "vlastn" iba steny,
+// ktorch SOLID voxel le v boxe => susedn boxy/chunky nikdy nevypu t ist stenu
+// dvakrt a stena na hranici chunku zmizne, ke je sused pln.
+// Prvy prechod: iba zbiera obdlzniky do quads (pripisuje, nic nemaze).
+template<class Get>
+static void greedyBox(const Get& get, const MeshBox& box, std::vector<QuadRec>& quads, uint32_t& allocs)
+{
+    const int lo[3] = { box.x0, box.y0, box.z0 };
+    const int hi[3] = { box.x1, box.y1, box.z1 };
 
-    const int dims[3] = { CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE };
+    // maska je per-thread, aby workery nealokovali 3x za chunk
+    static thread_local std::vector<MaskCell> mask;
+    // vrstvy k-1 a k s 1-voxel okrajom v rovine: kazdy voxel sa precita raz za os,
+    // mask aj AO susedstvo citaju uz len z nich
+    static thread_local std::vector<BlockID> layerA, layerB;
 
-    // Pre kad axis vykreslme plty medzi slice-ami k-1 a k
+    // Pre kad axis vykreslme plty medzi slice-ami k-1 a k
     for (int axis = 0; axis < 3; ++axis) {
         int u = (axis + 1) % 3;
         int v = (axis + 2) % 3;
-        int du = dims[u], dv = dims[v], dw = dims[axis];
 
-        std::vector<MaskCell> mask(du * dv);
+        // in-plane extents for this axis
+        int u0 = lo[u], v0 = lo[v];
+        int du = std::max(0, hi[u] - lo[u]);
+        int dv = std::max(0, hi[v] - lo[v]);
+        if (du == 0 || dv == 0 || hi[axis] <= lo[axis]) continue;
+
+        if (size_t(du) * dv > mask.capacity()) ++allocs;
+        mask.assign(size_t(du) * dv, MaskCell{});
+
+        const int pw = du + 2;
+        const size_t plane = size_t(pw) * (dv + 2);
+        if (plane > layerA.capacity()) ++allocs;
+        if (plane > layerB.capacity()) ++allocs;
+        layerA.resize(plane);
+        layerB.resize(plane);
+        auto loadLayer = [&](std::vector<BlockID>& L, int layer) {
+            int c[3];
+            c[axis] = layer;
+            for (int j = -1; j <= dv; ++j) {
+                c[v] = v0 + j;
+                BlockID* row = &L[size_t(j + 1) * pw];
+                for (int i = -1; i <= du; ++i) {
+                    c[u] = u0 + i;
+                    row[i + 1] = get(c[0], c[1], c[2]);
+                }
+            }
+        };
+        // 8-susedstvo bunky (i,j) vo vrstve L ako AO bajt (poradie bitov pri AO_TABLE)
+        auto aoBits = [pw](const std::vector<BlockID>& L, int i, int j) -> uint8_t {
+            const BlockID* r0 = &L[size_t(j) * pw + i];   // riadok j-1, stlpec i-1
+            const BlockID* r1 = r0 + pw;
+            const BlockID* r2 = r1 + pw;
+            return uint8_t(
+                (blockOpaque(r0[0]) << 0) | (blockOpaque(r0[1]) << 1) | (blockOpaque(r0[2]) << 2) |
+                (blockOpaque(r1[0]) << 3) | (blockOpaque(r1[2]) << 4) |
+                (blockOpaque(r2[0]) << 5) | (blockOpaque(r2[1]) << 6) | (blockOpaque(r2[2]) << 7));
+        };
+        loadLayer(layerA, lo[axis] - 1);
+
+        // faces lie between k-1 and k; both box ends are needed
+        for (int k = lo[axis]; k <= hi[axis]; ++k) {
+            const bool ownA = (k - 1 >= lo[axis]); // voxel k-1 je v boxe
+            const bool ownB = (k < hi[axis]);      // voxel k je v boxe
 
-        for (int k = 0; k <= dw; ++k) {
-            // Vypo?taj masku tvr medzi k-1 a k
+            // Vypotaj masku tvr medzi k-1 a k
+            loadLayer(layerB, k);
             for (int j = 0; j < dv; ++j) {
                 for (int i = 0; i < du; ++i) {
-                    int a[3] = { 0,0,0 }, b[3] = { 0,0,0 };
-                    a[axis] = k - 1; b[axis] = k;
-                    a[u] = i; a[v] = j; b[u] = i; b[v] = j;
-
-                    BlockID va = (k > 0 ? c.get((axis == 0 ? a[0] : a[0]), (axis == 1 ? a[1] : a[1]), (axis == 2 ? a[2] : a[2])) : 0);
-                    BlockID vb = (k < dw ? c.get((axis == 0 ? b[0] : b[0]), (axis == 1 ? b[1] : b[1]), (axis == 2 ? b[2] : b[2])) : 0);
+                    const size_t c = size_t(j + 1) * pw + (i + 1);
+                    const BlockID va = layerA[c];
+                    const BlockID vb = layerB[c];
 
                     MaskCell cell{};
-                    if (isSolid(va) != isSolid(vb)) {
-                        // Normla smerom od SOLID do AIR => ak je va solid, je to +face; inak -face.
-                        cell.id = isSolid(va) ? va : vb;
-                        cell.faceDir = isSolid(va) ? +1 : -1;
-                    }
+                    // Normla smerom od SOLID do AIR => ak je va solid, je to +face; inak -face.
+                    // (dve rozne priesvitne latky vedla seba: kresli sa len jedna strana)
+                    // AO sa cita na vzduchovej strane steny (+face: vrstva k, -face: k-1)
+                    if (ownA && showsFace(va, vb)) { cell.id = va; cell.faceDir = +1; cell.ao = aoBits(layerB, i, j); }
+                    else if (ownB && showsFace(vb, va)) { cell.id = vb; cell.faceDir = -1; cell.ao = aoBits(layerA, i, j); }
                     mask[j * du + i] = cell;
                 }
             }
+            std::swap(layerA, layerB);   // vrstva k je v dalsom slice k-1
 
-            // Greedy zl?enie masky do obd?nikov
+            // Greedy zlenie masky do obdnikov
             int i = 0, j = 0;
             while (j < dv) {
                 while (i < du) {
@@ -226,12 +282,12 @@ MeshData meshChunk(const Chunk& c) {
                         if (!stop) ++h;
                     }
 
-                    // emitni quad (i,j) .. (i+w,j+h) na slice k
-                    float tileU, tileV;
-                    pickTile(m0.id, m0.faceDir, axis, tileU, tileV);
-                    emitQuad(out, c, axis, m0.faceDir, k, i, j, w, h, tileU, tileV);
+                    // zapamataj quad (i,j) .. (i+w,j+h) na slice k, v absolutnych suradniciach
+                    if (quads.size() == quads.capacity()) ++allocs;
+                    quads.push_back(QuadRec{ m0.id, (int8_t)axis, m0.faceDir, (int16_t)k,
+                        (int16_t)(u0 + i), (int16_t)(v0 + j), (int16_t)w, (int16_t)h, m0.ao });
 
-                    // vy?isti pouit oblas? v maske
+                    // vyisti pouit oblas v maske
                     for (int y = 0; y < h; ++y)
                         for (int x = 0; x < w; ++x)
                             mask[(j + y) * du + (i + x)] = MaskCell{};
@@ -242,128 +298,158 @@ MeshData meshChunk(const Chunk& c) {
             }
         }
     }
+}
 
-    return out;
+static inline MeshBox fullChunkBox() {
+    return MeshBox{ 0, 0, 0, CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE };
 }
 
-MeshData meshChunkAt(const Chunk& c, int cx, int cy, int cz)
+// Greedy box -> out (out sa vycisti). Dva prechody: najprv zoznam quadov, potom jeden
+// resize na presnu velkost a zapis cez raw pointre aj s world offsetom (ziadny push_back,
+// ziadny druhy prechod cez vertexy). Ked ma out kapacitu (arena), nealokuje sa nic.
+template<class Get>
+static void meshBoxInto(const Get& get, const MeshBox& box, int cx, int cy, int cz,
+    MeshData& m, MeshEmitStats* stats, int scale = 1, const int* originVox = nullptr)
 {
-    MeshData m = meshChunk(c);
-
-    const float xOff = float(cx * CHUNK_SIZE) * VOXEL_SCALE;
-    const float yOff = float(cy * CHUNK_HEIGHT) * VOXEL_SCALE;
-    const float zOff = float(cz * CHUNK_SIZE) * VOXEL_SCALE;
+    static thread_local std::vector<QuadRec> quads;
+    uint32_t allocs = 0;
+    quads.clear();
+    greedyBox(get, box, quads, allocs);
+
+    // bucket sort: opaque po smeroch (FaceDir), priesvitne na koniec => kazdy smer aj
+    // translucent priechod je jeden suvisly rozsah indexov (draw moze smery preskocit)
+    static thread_local std::vector<QuadRec> sorted;
+    auto bucketOf = [](const QuadRec& q) {
+        return blockOpaque(q.id) ? faceDirIndex(q.axis, q.faceDir) : int(FACE_DIR_COUNT);
+    };
+    uint32_t cnt[FACE_DIR_COUNT + 1] = {}, at[FACE_DIR_COUNT + 1];
+    for (const QuadRec& q : quads) ++cnt[bucketOf(q)];
+    for (int b = 0, s = 0; b <= FACE_DIR_COUNT; ++b) { at[b] = s; s += cnt[b]; }
+    if (quads.size() > sorted.capacity()) ++allocs;
+    sorted.resize(quads.size());
+    for (const QuadRec& q : quads) sorted[at[bucketOf(q)]++] = q;
+
+    const size_t nq = sorted.size();
+    const size_t nv = nq * 4 * VERT_FLOATS, ni = nq * 6;
+    if (nv > m.vertices.capacity()) ++allocs;
+    if (ni > m.indices.capacity()) ++allocs;
+    m.vertices.resize(nv);
+    m.indices.resize(ni);
+    m.opaqueIndexCount = 0;
+    for (int d = 0; d < FACE_DIR_COUNT; ++d) {
+        m.dirIndexCount[d] = cnt[d] * 6;
+        m.opaqueIndexCount += cnt[d] * 6;
+    }
 
-    // add offset to every vertex position
-    for (size_t i = 0; i + 2 < m.vertices.size(); i += 11) {
-        m.vertices[i + 0] += xOff; // x
-        m.vertices[i + 1] += yOff; // y
-        m.vertices[i + 2] += zOff; // z
+    // chunk (+ pripadny posun mriezky v voxeloch) -> world
+    const int o[3] = { originVox ? originVox[0] : 0, originVox ? originVox[1] : 0, originVox ? originVox[2] : 0 };
+    const float off[3] = {
+        float(cx * CHUNK_SIZE + o[0]) * VOXEL_SCALE,
+        float(cy * CHUNK_HEIGHT + o[1]) * VOXEL_SCALE,
+        float(cz * CHUNK_SIZE + o[2]) * VOXEL_SCALE };
+    float* vp = m.vertices.data();
+    uint32_t* ip = m.indices.data();
+    for (size_t q = 0; q < nq; ++q, vp += 4 * VERT_FLOATS, ip += 6)
+        writeQuad(vp, ip, uint32_t(q * 4), sorted[q], off, scale);
+
+    // AABB pre culling (smery stien, neskor frustum)
+    for (int a = 0; a < 3; ++a) { m.aabbMin[a] = 0.0f; m.aabbMax[a] = -1.0f; }
+    if (nq) {
+        const float* p = m.vertices.data();
+        for (int a = 0; a < 3; ++a) m.aabbMin[a] = m.aabbMax[a] = p[a];
+        for (size_t i = 1; i < nq * 4; ++i) {
+            p += VERT_FLOATS;
+            for (int a = 0; a < 3; ++a) {
+                m.aabbMin[a] = std::min(m.aabbMin[a], p[a]);
+                m.aabbMax[a] = std::max(m.aabbMax[a], p[a]);
+            }
+        }
     }
-    return m;
+
+    if (stats) { stats->quads = (uint32_t)nq; stats->allocs = allocs; }
 }
 
-// === BOUNDED GREEDY MESHER FOR A SUB-REGION ===
-// x0,y0,z0 inclusive  |  x1,y1,z1 exclusive  (all in smallest-cell coords)
-MeshData meshChunkRegion(const Chunk& c, int x0, int y0, int z0, int x1, int y1, int z1)
-{
+MeshData meshChunk(const Chunk& c) {
     MeshData out;
-    out.vertices.clear(); out.indices.clear();
-
-    const int dims[3] = { CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE };
-
-    auto inBounds = [&](int x, int y, int z)->bool {
-        return (x >= 0 && y >= 0 && z >= 0 && x < dims[0] && y < dims[1] && z < dims[2]);
-        };
-    auto getSafe = [&](int x, int y, int z)->BlockID {
-        return inBounds(x, y, z) ? c.get(x, y, z) : 0;
-        };
-
-    // For each axis we build faces between slices k-1 and k.
-    for (int axis = 0; axis < 3; ++axis) {
-        // map axis->(u,v) in-plane axes and region bounds per axis
-        int u = (axis + 1) % 3;
-        int v = (axis + 2) % 3;
-
-        int lo[3] = { x0,y0,z0 };
-        int hi[3] = { x1,y1,z1 };
-
-        // in-plane extents for this axis
-        int u0 = lo[u], u1 = hi[u];
-        int v0 = lo[v], v1 = hi[v];
-        int du = std::max(0, u1 - u0);
-        int dv = std::max(0, v1 - v0);
-        if (du == 0 || dv == 0) continue;
-
-        // along the slicing axis we need k in [lo[axis] .. hi[axis]]
-        // because faces lie between k-1 and k; both ends are needed.
-        int k0 = lo[axis];
-        int k1 = hi[axis];
-
-        std::vector<MaskCell> mask(du * dv);
-
-        for (int k = k0; k <= k1; ++k) {
-            // build mask for this slice
-            for (int j = 0; j < dv; ++j) {
-                for (int i = 0; i < du; ++i) {
-                    int iu = u0 + i;
-                    int iv = v0 + j;
-
-                    // samples on either side of the plane between k-1 and k
-                    int ax[3] = { 0,0,0 }, bx[3] = { 0,0,0 };
-                    ax[u] = iu; ax[v] = iv; ax[axis] = k - 1;
-                    bx[u] = iu; bx[v] = iv; bx[axis] = k;
+    meshBoxInto(ChunkGet{ c }, fullChunkBox(), 0, 0, 0, out, nullptr);
+    return out;
+}
 
-                    BlockID va = (k > 0 ? getSafe(ax[0], ax[1], ax[2]) : 0);
-                    BlockID vb = (k < dims[axis] ? getSafe(bx[0], bx[1], bx[2]) : 0);
+MeshData meshChunkAt(const Chunk& c, int cx, int cy, int cz)
+{
+    MeshData m;
+    meshChunkInto(c, cx, cy, cz, m);
+    return m;
+}
 
-                    MaskCell cell{}; // default empty
-                    if (isSolid(va) != isSolid(vb)) {
-                        cell.id = isSolid(va) ? va : vb;
-                        cell.faceDir = isSolid(va) ? +1 : -1;
-                    }
-                    mask[j * du + i] = cell;
-                }
-            }
+void meshChunkInto(const Chunk& c, int cx, int cy, int cz, MeshData& m, MeshEmitStats* stats)
+{
+    meshBoxInto(ChunkGet{ c }, fullChunkBox(), cx, cy, cz, m, stats);
+}
 
-            // greedy merge on mask
-            int i = 0, j = 0;
-            while (j < dv) {
-                while (i < du) {
-                    MaskCell m0 = mask[j * du + i];
-                    if (m0.faceDir == 0) { ++i; continue; }
+void meshVolumeInto(const MeshVolume& vol, const MeshBox& box, int cx, int cy, int cz,
+    MeshData& m, MeshEmitStats* stats)
+{
+    meshBoxInto(VolumeGet{ vol }, box, cx, cy, cz, m, stats);
+}
 
-                    // width
-                    int w = 1;
-                    while (i + w < du && sameCell(mask[j * du + i + w], m0)) ++w;
-                    // height
-                    int h = 1; bool stop = false;
-                    while (j + h < dv && !stop) {
-                        for (int x = 0; x < w; ++x) {
-                            if (!sameCell(mask[(j + h) * du + i + x], m0)) { stop = true; break; }
+// LOD: box sa zmensi na mriezku buniek f^3 (f = lodScale). Bunka je plna, ak je plna
+// aspon polovica jej voxelov (majority), material berie z najvyssieho plneho voxela
+// (top-surface, nech travnik ostane travnikom). Opaque ma prednost: bunka dna pod vodou
+// ostane kamenom/pieskom, voda vyhra len ked opaque voxelov nie je dost. Mimo boxu je vzduch => na hranici chunku
+// vzniknu zvisle steny az po povrch, ktore sluzia ako skirt proti trhlinam medzi LOD.
+void meshVolumeLodInto(const MeshVolume& vol, const MeshBox& box, int lod, int cx, int cy, int cz,
+    MeshData& m, MeshEmitStats* stats)
+{
+    const int f = lodScale(lod);
+    if (f <= 1) { meshVolumeInto(vol, box, cx, cy, cz, m, stats); return; }
+
+    static thread_local MeshVolume coarse;
+    coarse.ox = coarse.oy = coarse.oz = 0;
+    coarse.sx = (box.x1 - box.x0 + f - 1) / f;
+    coarse.sy = (box.y1 - box.y0 + f - 1) / f;
+    coarse.sz = (box.z1 - box.z0 + f - 1) / f;
+    coarse.cells.assign(size_t(coarse.sx) * coarse.sy * coarse.sz, BLOCK_AIR);
+
+    const int need = (f * f * f + 1) / 2;
+    for (int Y = 0; Y < coarse.sy; ++Y)
+        for (int Z = 0; Z < coarse.sz; ++Z)
+            for (int X = 0; X < coarse.sx; ++X) {
+                int solid = 0, opaque = 0;
+                BlockID top = BLOCK_AIR, topOpaque = BLOCK_AIR;
+                const int x0 = box.x0 + X * f, y0 = box.y0 + Y * f, z0 = box.z0 + Z * f;
+                for (int y = y0 + f - 1; y >= y0; --y)          // zhora, prvy plny = material
+                    for (int z = z0; z < z0 + f; ++z)
+                        for (int x = x0; x < x0 + f; ++x) {
+                            if (x >= box.x1 || y >= box.y1 || z >= box.z1) continue;
+                            BlockID id = vol.get(x, y, z);
+                            if (isAir(id)) continue;
+                            if (top == BLOCK_AIR) top = id;
+                            ++solid;
+                            if (blockOpaque(id)) {
+                                if (topOpaque == BLOCK_AIR) topOpaque = id;
+                                ++opaque;
+                            }
                         }
-                        if (!stop) ++h;
-                    }
-
-                    // emit quad using ABSOLUTE in-plane coordinates
-                    float tileU, tileV;
-                    pickTile(m0.id, m0.faceDir, axis, tileU, tileV);
-
-                    int i0_abs = u0 + i;
-                    int j0_abs = v0 + j;
-                    emitQuad(out, c, axis, m0.faceDir, k, i0_abs, j0_abs, w, h, tileU, tileV);
-
-                    // clear mask block
-                    for (int y = 0; y < h; ++y)
-                        for (int x = 0; x < w; ++x)
-                            mask[(j + y) * du + (i + x)] = MaskCell{};
-
-                    i += w;
-                }
-                i = 0; ++j;
+                if (solid >= need)
+                    coarse.cells[size_t(X) + size_t(coarse.sx) * (size_t(Z) + size_t(coarse.sz) * size_t(Y))] =
+                        (opaque >= need) ? topOpaque : top;
             }
-        }
-    }
 
+    // mriezka zacina v box.x0/y0/z0 => posun ide do world offsetu
+    const MeshBox cbox{ 0, 0, 0, coarse.sx, coarse.sy, coarse.sz };
+    const int origin[3] = { box.x0, box.y0, box.z0 };
+    meshBoxInto(VolumeGet{ coarse }, cbox, cx, cy, cz, m, stats, f, origin);
+}
+
+// === BOUNDED GREEDY MESHER FOR A SUB-REGION ===
+// x0,y0,z0 inclusive  |  x1,y1,z1 exclusive  (all in smallest-cell coords)
+// Emits only faces of solid voxels inside the region, so adjacent regions never overlap.
+MeshData meshChunkRegion(const Chunk& c, int x0, int y0, int z0, int x1, int y1, int z1)
+{
+    MeshData out;
+    MeshBox box{ std::max(0, x0), std::max(0, y0), std::max(0, z0),
+                 std::min(CHUNK_SIZE, x1), std::min(CHUNK_HEIGHT, y1), std::min(CHUNK_SIZE, z1) };
+    meshBoxInto(ChunkGet{ c }, box, 0, 0, 0, out, nullptr);
     return out;
-}
\ No newline at end of file
+}
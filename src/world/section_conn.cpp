@@ -0,0 +1,55 @@
+#include "world/section_conn.hpp"
+#include "world/block_props.hpp"
+#include <vector>
+
+uint16_t sectionConnectivity(const MeshVolume& vol, int x0, int y0, int z0)
+{
+    constexpr int S = REGION_SIZE;
+    constexpr int N = S * S * S;
+    // 0 = opaque, 1 = volny a nenavstiveny, 2 = navstiveny; index x + S*(z + S*y)
+    static thread_local std::vector<uint8_t> cell;
+    static thread_local std::vector<uint16_t> stack;
+    cell.resize(N);
+    int open = 0;
+    for (int y = 0; y < S; ++y)
+        for (int z = 0; z < S; ++z)
+            for (int x = 0; x < S; ++x) {
+                const bool o = !blockOpaque(vol.get(x0 + x, y0 + y, z0 + z));
+                cell[x + S * (z + S * y)] = o ? 1 : 0;
+                open += o;
+            }
+    if (open == 0) return 0;
+    if (open == N) return SECTION_CONN_ALL;
+
+    uint16_t conn = 0;
+    for (int start = 0; start < N && conn != SECTION_CONN_ALL; ++start) {
+        if (cell[start] != 1) continue;
+        // jedna suvisla oblast: ktorych stien sa dotyka
+        uint32_t faces = 0;
+        stack.clear();
+        stack.push_back((uint16_t)start);
+        cell[start] = 2;
+        while (!stack.empty()) {
+            const int i = stack.back();
+            stack.pop_back();
+            const int x = i % S, z = (i / S) % S, y = i / (S * S);
+            if (x == S - 1) faces |= 1u << FACE_PX;
+            if (x == 0)     faces |= 1u << FACE_NX;
+            if (y == S - 1) faces |= 1u << FACE_PY;
+            if (y == 0)     faces |= 1u << FACE_NY;
+            if (z == S - 1) faces |= 1u << FACE_PZ;
+            if (z == 0)     faces |= 1u << FACE_NZ;
+            auto visit = [&](int j) { if (cell[j] == 1) { cell[j] = 2; stack.push_back((uint16_t)j); } };
+            if (x > 0)     visit(i - 1);
+            if (x < S - 1) visit(i + 1);
+            if (z > 0)     visit(i - S);
+            if (z < S - 1) visit(i + S);
+            if (y > 0)     visit(i - S * S);
+            if (y < S - 1) visit(i + S * S);
+        }
+        for (int a = 0; a < FACE_DIR_COUNT; ++a)
+            for (int b = a + 1; b < FACE_DIR_COUNT; ++b)
+                if ((faces >> a & 1u) && (faces >> b & 1u)) conn |= uint16_t(1u << sectionPairBit(a, b));
+    }
+    return conn;
+}
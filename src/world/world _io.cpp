@@ -103,8 +103,8 @@ bool worldLoadFromFile(World& w, const std::string& path, std::string* err) {
         if (err) *err = "Mismatched chunk dimensions"; return false;
     }
 
-    // Clear current world (defer-destroy GPU buffers if you use that system)
-    w.clearAllChunks();   // implement this: destroy CPU data + enqueue GPU buffers for destroy
+    // Clear current world (GPU rozsahy idu do w.deletions, uvolnia sa po dobehnuti framov)
+    w.clearAllChunks();
 
     for (uint32_t i = 0; i < hdr.chunkCount; ++i) {
         int32_t cx, cy, cz;
@@ -136,9 +136,8 @@ bool worldLoadFromFile(World& w, const std::string& path, std::string* err) {
                     wc->data.set(x, y, z, (BlockID)flat[idx++]);
                 }
 
-        // Rebuild CPU mesh (with offset) and mark for upload
-        wc->meshCPU = meshChunkAt(wc->data, cx, cy, cz);
-        wc->needsUpload = true;
+        // Queue CPU mesh (with offset); upload follows once the worker is done
+        worldChunkArrived(w, key, *wc);
     }
 
     return true;
@@ -2,17 +2,38 @@
 #include "world/world.hpp"
 #include <vector>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
 
-static void destroyChunkGPU(VkDevice dev, ChunkGPU& g) {
-    if (g.vbo) { vkDestroyBuffer(dev, g.vbo, nullptr); g.vbo = VK_NULL_HANDLE; }
-    if (g.vmem) { vkFreeMemory(dev, g.vmem, nullptr); g.vmem = VK_NULL_HANDLE; }
-    if (g.ibo) { vkDestroyBuffer(dev, g.ibo, nullptr); g.ibo = VK_NULL_HANDLE; }
-    if (g.imem) { vkFreeMemory(dev, g.imem, nullptr); g.imem = VK_NULL_HANDLE; }
+static constexpr uint32_t VERT_FLOATS = 11;   // pos3 normal3 uv2 tile2 ao1
+
+static void destroyChunkGPU(VulkanContext& ctx, GeometryPool& pool, ChunkGPU& g) {
+    pool.free(ctx, g.geo);
+    g.vbo = VK_NULL_HANDLE;
+    g.ibo = VK_NULL_HANDLE;
     g.indexCount = 0;
+    g.translucentCount = 0;
 }
 
-static bool createAndFill(VulkanContext& ctx, const void* data, VkDeviceSize bytes,
-    VkBufferUsageFlags usage, VkBuffer& outB, VkDeviceMemory& outM);
+// ako destroyChunkGPU, ale rozsah sa uvolni az ked ho nepouziva ziadny rozbehnuty frame ani upload
+static void retireChunkGPU(World& w, ChunkGPU& g) {
+    if (g.geo) {
+        const uint64_t bytes = uint64_t(g.geo.vertexCount) * VERT_FLOATS * sizeof(float) +
+                               uint64_t(g.geo.indexCount) * sizeof(uint32_t);
+        w.deletions.push(bytes, [&pool = w.geoPool, a = g.geo](VulkanContext& ctx) mutable {
+            pool.free(ctx, a);
+        });
+        g.geo = GeoAlloc{};
+    }
+    g.vbo = VK_NULL_HANDLE;
+    g.ibo = VK_NULL_HANDLE;
+    g.indexCount = 0;
+    g.translucentCount = 0;
+}
 
 // find by key
 WorldChunk* World::find(const WorldKey& k) {
@@ -31,85 +52,710 @@ void World::ensure(VulkanContext& ctx, int centerCx, int centerCz, int radius)
             // generate
             generateChunk(wc->data, { k.cx,k.cy,k.cz }, seed);
 
-            // mesh whole chunk once (reuse your concatenation path)
-            MeshData m = meshChunkAt(wc->data, k.cx, k.cy, k.cz);
-            wc->meshCPU = std::move(m);
-            wc->needsUpload = true;
-
+            // mesh on workers (+ rims of loaded neighbors); upload once all parts are collected
+            WorldChunk& ref = *wc;
             map.emplace(k, std::move(wc));
+            worldChunkArrived(*this, k, ref);
         }
 
-    // upload any new/dirty chunks
-    for (auto& kv : map) {
-        auto& wc = *kv.second;
-        if (!wc.needsUpload) continue;
-        wc.needsUpload = false;
+    worldCollectMeshes(*this);
+    worldUploadDirty(*this, ctx);
+}
 
-        // upload VBO/IBO
-        destroyChunkGPU(ctx.device, wc.gpu);
-        if (!wc.meshCPU.vertices.empty()) {
-            createAndFill(ctx, wc.meshCPU.vertices.data(),
-                VkDeviceSize(wc.meshCPU.vertices.size() * sizeof(float)),
-                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                wc.gpu.vbo, wc.gpu.vmem);
-        }
-        if (!wc.meshCPU.indices.empty()) {
-            createAndFill(ctx, wc.meshCPU.indices.data(),
-                VkDeviceSize(wc.meshCPU.indices.size() * sizeof(uint32_t)),
-                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                wc.gpu.ibo, wc.gpu.imem);
-        }
-        wc.gpu.indexCount = (uint32_t)wc.meshCPU.indices.size();
-        wc.gpu.vertexCount = (uint32_t)(wc.meshCPU.vertices.size() / 10);
-        wc.gpu.faceCount = wc.gpu.indexCount / 6;
-        wc.gpu.coord = { kv.first.cx, kv.first.cy, kv.first.cz };
+// Bitmaska FaceDir smerov, ktore mozu byt z camPos predne: stena s normalou +X lezi
+// v rovine x >= aabbMin.x, takze je predna len ak je kamera za aabbMin.x (a symetricky).
+static inline uint32_t visibleFaceDirs(const ChunkGPUSlot& sl, const glm::vec3& cam) {
+    uint32_t m = 0;
+    for (int a = 0; a < 3; ++a) {
+        if (cam[a] > sl.aabbMin[a]) m |= 1u << (a * 2);       // +a
+        if (cam[a] < sl.aabbMax[a]) m |= 1u << (a * 2 + 1);   // -a
     }
+    return m;
 }
 
-void World::draw(VulkanContext& ctx, VkCommandBuffer cb)
+// jeden draw do indirect bufferu; bez MDI / plny buffer priamo (po uz zaradenych, kvoli poradiu)
+static inline void emitDraw(VkCommandBuffer cb, IndirectDrawRange& batch, uint32_t count,
+    uint32_t first, int32_t vertexOffset, World::DrawStats& st)
 {
-    for (auto& kv : map) {
-        const auto& g = kv.second->gpu;
-        if (!g.vbo || !g.ibo || g.indexCount == 0) continue;
+    if (!batch.push(count, first, vertexOffset)) {
+        st.calls += batch.flush(cb);
+        vkCmdDrawIndexed(cb, count, 1, first, vertexOffset, 0);
+        ++st.calls;
+    }
+    ++st.draws; st.indices += count;
+}
+
+// opaque rozsahy jedneho chunku (VBO/IBO jeho stranky uz su bindnute); parts = casti vo frustum
+static void drawChunkOpaque(VkCommandBuffer cb, IndirectDrawRange& batch, const ChunkGPU& g,
+    const glm::vec3& camPos, const PartSet* parts, World::DrawStats& st)
+{
+    // kazda cast ma vlastny pod-rozsah; indexy su lokalne => vertexOffset
+    // smery su za sebou => susedne viditelne smery idu jednym drawom
+    for (int p = 0; p < PART_COUNT; ++p) {
+        const auto& sl = g.slots[p];
+        if (sl.opaqueCount == 0 || (parts && !parts->test(p))) continue;
+        const uint32_t vis = visibleFaceDirs(sl, camPos);
+        uint32_t at = sl.firstIndex, runStart = at, runLen = 0;
+        for (int d = 0; d < FACE_DIR_COUNT; ++d) {
+            const uint32_t n = sl.dirCount[d];
+            if (vis & (1u << d)) {
+                if (runLen == 0) runStart = at;
+                runLen += n;
+            }
+            else {
+                if (runLen) {
+                    emitDraw(cb, batch, runLen, runStart, (int32_t)sl.firstVertex, st);
+                    runLen = 0;
+                }
+                st.dirSkipped += n;
+            }
+            at += n;
+        }
+        if (runLen) emitDraw(cb, batch, runLen, runStart, (int32_t)sl.firstVertex, st);
+    }
+}
+
+// opaque chunky drawOrder [first, last): bind pri zmene stranky GeometryPool, chunky v nej sa
+// lisia len firstIndex / vertexOffset => drawy stranky idu jednym vkCmdDrawIndexedIndirect.
+// Svet len cita, takze bezi aj vo vlaknach recordParallel (kazde so svojim batch a st).
+static void drawOpaqueEntries(const World& w, VkCommandBuffer cb, IndirectDrawRange& batch,
+    uint32_t first, uint32_t last, const glm::vec3& camPos, World::DrawStats& st)
+{
+    uint32_t page = TlsfAllocator::NONE;
+    for (uint32_t i = first; i < last; ++i) {
+        const World::CullEntry& e = w.cullEntries[w.drawOrder[i]];
+        const ChunkGPU& g = *e.gpu;
+        if (g.geo.page != page) {
+            st.calls += batch.flush(cb);
+            VkDeviceSize off = 0;
+            vkCmdBindVertexBuffers(cb, 0, 1, &g.vbo, &off);
+            vkCmdBindIndexBuffer(cb, g.ibo, 0, VK_INDEX_TYPE_UINT32);
+            ++st.binds;
+            page = g.geo.page;
+        }
+        drawChunkOpaque(cb, batch, g, camPos, w.cullReady ? &e.visible : nullptr, st);
+    }
+    st.calls += batch.flush(cb);
+}
+
+// stabilny LSD radix sort podla hornych 32 bitov (dolne su index), po 8 bitoch;
+// bajt rovnaky pre vsetky kluce (napr. jedina stranka) sa preskoci
+static void radixSortKeys(std::vector<uint64_t>& v, std::vector<uint64_t>& tmp)
+{
+    if (v.size() < 2) return;
+    tmp.resize(v.size());
+    for (int shift = 32; shift < 64; shift += 8) {
+        uint32_t hist[256] = {};
+        for (uint64_t k : v) ++hist[(k >> shift) & 0xFF];
+        if (hist[(v[0] >> shift) & 0xFF] == v.size()) continue;
+        uint32_t sum = 0;
+        for (uint32_t& h : hist) { const uint32_t c = h; h = sum; sum += c; }
+        for (uint64_t k : v) tmp[hist[(k >> shift) & 0xFF]++] = k;
+        v.swap(tmp);
+    }
+}
+
+// viditelne chunky do drawOrder. Kluc: vzdialenost^2 kamery k boxu chunku ako float bity
+// (kladny float => poradie bitov sedi), horne 16 bitov ~ 1 %; jeho exponent je pasmo
+// (vzdialenost x1.41), v pasme stranka a az potom vzdialenost => bindov je najviac
+// pasma x stranky a early-z aj tak zahodi skoro vsetko za blizsimi pasmami
+static void buildDrawOrder(World& w, const glm::vec3& camPos)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    w.drawOrder.clear();
+    const uint32_t n = (uint32_t)w.cullEntries.size();
+    if (!w.frontToBack) {
+        for (uint32_t i = 0; i < n; ++i)
+            if (!w.cullReady || w.cullEntries[i].chunkVisible) w.drawOrder.push_back(i);
+        w.drawStats.sortUs = 0.0f;
+        return;
+    }
+    static thread_local std::vector<uint64_t> keys, tmp;
+    keys.clear();
+    const AabbSoA& cc = w.cullChunks;
+    for (uint32_t i = 0; i < n; ++i) {
+        const World::CullEntry& e = w.cullEntries[i];
+        if (w.cullReady && !e.chunkVisible) continue;
+        // najblizsi bod boxu (kamera vnutri => 0)
+        const float dx = std::max({ cc.minX[i] - camPos.x, 0.0f, camPos.x - cc.maxX[i] });
+        const float dy = std::max({ cc.minY[i] - camPos.y, 0.0f, camPos.y - cc.maxY[i] });
+        const float dz = std::max({ cc.minZ[i] - camPos.z, 0.0f, camPos.z - cc.maxZ[i] });
+        const float d2 = dx * dx + dy * dy + dz * dz;
+        uint32_t bits;
+        std::memcpy(&bits, &d2, sizeof(bits));
+        const uint32_t q = bits >> 16;                          // znamienko 0 | exponent 8 | mantisa 7
+        const uint32_t page = std::min(e.gpu->geo.page, 255u);  // dalsie stranky zdielaju kluc (len viac bindov)
+        const uint32_t key = (q >> 7) << 24 | page << 16 | q;
+        keys.push_back(uint64_t(key) << 32 | i);
+    }
+    radixSortKeys(keys, tmp);
+    w.drawOrder.reserve(keys.size());
+    for (uint64_t k : keys) w.drawOrder.push_back((uint32_t)k);
+    w.drawStats.sortUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// depth prepass ma zmysel len s oboma pipeline (createVoxelPipeline)
+static inline bool prepassReady(const World& w, const VulkanContext& ctx) {
+    return w.depthPrepass && ctx.voxelDepthPipeline && ctx.voxelEqualPipeline;
+}
+
+// chunky s geometriou do cullEntries / SoA poli, zoradene podla stranky GeometryPool
+static void rebuildCull(World& w)
+{
+    struct Item { uint32_t page; const ChunkGPU* gpu; WorldKey key; };
+    static thread_local std::vector<Item> order;
+    order.clear();
+    for (auto& kv : w.map) {
+        const ChunkGPU& g = kv.second->gpu;
+        if (g.vbo && g.indexCount) order.push_back({ g.geo.page, &g, kv.first });
+    }
+    std::sort(order.begin(), order.end(),
+        [](const Item& a, const Item& b) { return a.page < b.page; });
+
+    w.cullEntries.clear();
+    w.cullPartSlot.clear();
+    w.cullChunks.clear();
+    w.cullParts.clear();
+    w.cullRecords.clear();
+    w.cullPages.clear();
+    for (const Item& o : order) {
+        const ChunkGPU& g = *o.gpu;
+        World::CullEntry e;
+        e.key = o.key;
+        e.gpu = &g;
+        e.firstPart = w.cullParts.size();
+        float mn[3] = { 1e30f, 1e30f, 1e30f }, mx[3] = { -1e30f, -1e30f, -1e30f };
+        for (int p = 0; p < PART_COUNT; ++p) {
+            const ChunkGPUSlot& sl = g.slots[p];
+            if (sl.indexCount == 0) continue;
+            w.cullParts.push(sl.aabbMin, sl.aabbMax);
+            w.cullPartSlot.push_back((uint8_t)p);
+            for (int a = 0; a < 3; ++a) {
+                mn[a] = std::min(mn[a], sl.aabbMin[a]);
+                mx[a] = std::max(mx[a], sl.aabbMax[a]);
+            }
+        }
+        e.partCount = w.cullParts.size() - e.firstPart;
+        if (e.partCount == 0) continue;
+        w.cullChunks.push(mn, mx);
+        w.cullEntries.push_back(e);
+
+        // zaznamy pre GpuCuller: kazda stranka ma v draw bufferi miesto na 3 prikazy na cast
+        if (w.cullPages.empty() || w.cullPages.back().vbo != g.vbo) {
+            World::CullPage pg;
+            pg.vbo = g.vbo;
+            pg.ibo = g.ibo;
+            pg.outBase = (uint32_t)w.cullRecords.size() * GPU_CULL_DRAWS_PER_RECORD;
+            w.cullPages.push_back(pg);
+        }
+        World::CullPage& pg = w.cullPages.back();
+        for (int p = 0; p < PART_COUNT; ++p) {
+            const ChunkGPUSlot& sl = g.slots[p];
+            if (sl.opaqueCount == 0) continue;
+            GpuCullRecord r{};
+            for (int a = 0; a < 3; ++a) { r.aabbMin[a] = sl.aabbMin[a]; r.aabbMax[a] = sl.aabbMax[a]; }
+            r.page = (uint32_t)w.cullPages.size() - 1;
+            r.firstIndex = sl.firstIndex;
+            r.vertexOffset = (int32_t)sl.firstVertex;
+            for (int d = 0; d < FACE_DIR_COUNT; ++d) r.dirCount[d] = sl.dirCount[d];
+            r.outBase = pg.outBase;
+            w.cullRecords.push_back(r);
+            pg.maxDraws += GPU_CULL_DRAWS_PER_RECORD;
+        }
+    }
+    w.cullRecordsChanged = true;
+    w.cullDirty = false;
+}
+
+// cave culling: sekcie v obdlzniku nacitanych chunkov (x, z) x cela vyska; bity = steny,
+// ktorymi BFS do sekcie vstupil (0 = nedosiahnuta, kamera ma bit 6)
+struct CaveGrid {
+    int sx0 = 0, sz0 = 0, nsx = 0, nsz = 0;   // v sekciach
+    std::vector<uint8_t> reached;
+    int index(int sx, int sy, int sz) const { return (sx - sx0) + nsx * ((sz - sz0) + nsz * sy); }
+    bool inside(int sx, int sy, int sz) const {
+        return sx >= sx0 && sx < sx0 + nsx && sz >= sz0 && sz < sz0 + nsz && sy >= 0 && sy < REGIONS_Y;
+    }
+};
+
+static int floorDiv(int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+
+static bool sectionInFrustum(const Frustum& f, int sx, int sy, int sz)
+{
+    // sekcia pokryva voxely [s * 32, s * 32 + 32) => world [(v - 0.5) * VOXEL_SCALE, ...]
+    const float mn[3] = { (sx * REGION_SIZE - 0.5f) * VOXEL_SCALE, (sy * REGION_SIZE - 0.5f) * VOXEL_SCALE,
+                          (sz * REGION_SIZE - 0.5f) * VOXEL_SCALE };
+    const float size = REGION_SIZE * VOXEL_SCALE;
+    for (const glm::vec4& p : f.planes) {
+        const float px = p.x >= 0.0f ? mn[0] + size : mn[0];
+        const float py = p.y >= 0.0f ? mn[1] + size : mn[1];
+        const float pz = p.z >= 0.0f ? mn[2] + size : mn[2];
+        if (p.x * px + p.y * py + p.z * pz + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+// BFS od sekcie kamery po stavoch (sekcia, vstupna stena): zo sekcie sa ide stenou d len ked
+// sa prepaja so vstupnou (sectionConn), d smeruje od kamery (v x: sekcia nie je pred kamerou
+// v opacnom smere; podobne y, z) a suseda je vo frustum. Kazda priamka pohladu prechadza
+// sekciami presne takto, takze viditelna sekcia sa vzdy dosiahne - nezavisi to od poradia
+// (preto stav aj so vstupnou stenou, nie len sekcia). Nenacitany chunk v obdlzniku je otvoreny.
+// false => kamera mimo obdlznika (nad svetom, daleko), cave culling sa preskoci.
+static bool caveTraverse(const World& w, const Frustum& f, const glm::vec3& camPos, CaveGrid& g)
+{
+    int minCx = INT32_MAX, minCz = INT32_MAX, maxCx = INT32_MIN, maxCz = INT32_MIN;
+    for (auto& kv : w.map) {
+        if (kv.first.cy != 0) continue;
+        minCx = std::min(minCx, kv.first.cx); maxCx = std::max(maxCx, kv.first.cx);
+        minCz = std::min(minCz, kv.first.cz); maxCz = std::max(maxCz, kv.first.cz);
+    }
+    if (minCx > maxCx) return false;
+    const int ncx = maxCx - minCx + 1, ncz = maxCz - minCz + 1;
+    static thread_local std::vector<const WorldChunk*> chunks;
+    chunks.assign(size_t(ncx) * ncz, nullptr);
+    for (auto& kv : w.map)
+        if (kv.first.cy == 0) chunks[size_t(kv.first.cz - minCz) * ncx + (kv.first.cx - minCx)] = kv.second.get();
+
+    g.sx0 = minCx * REGIONS_X; g.nsx = ncx * REGIONS_X;
+    g.sz0 = minCz * REGIONS_Z; g.nsz = ncz * REGIONS_Z;
+    g.reached.assign(size_t(g.nsx) * g.nsz * REGIONS_Y, 0);
+
+    const glm::vec3 v = camPos / VOXEL_SCALE + glm::vec3(0.5f);   // voxel v pokryva [v - 0.5, v + 0.5]
+    const int csx = floorDiv((int)std::floor(v.x), REGION_SIZE);
+    const int csy = floorDiv((int)std::floor(v.y), REGION_SIZE);
+    const int csz = floorDiv((int)std::floor(v.z), REGION_SIZE);
+    if (!g.inside(csx, csy, csz)) return false;
+
+    auto connAt = [&](int sx, int sy, int sz) -> uint16_t {
+        const int cx = floorDiv(sx, REGIONS_X), cz = floorDiv(sz, REGIONS_Z);
+        const WorldChunk* wc = chunks[size_t(cz - minCz) * ncx + (cx - minCx)];
+        if (!wc) return SECTION_CONN_ALL;
+        return wc->sectionConn[regionIndex(sx - cx * REGIONS_X, sy, sz - cz * REGIONS_Z)];
+    };
+
+    struct Node { int sx, sy, sz; int8_t in; };
+    static thread_local std::vector<Node> queue;
+    queue.clear();
+    queue.push_back({ csx, csy, csz, -1 });
+    g.reached[g.index(csx, csy, csz)] = 1u << FACE_DIR_COUNT;
+    static constexpr int DIR[FACE_DIR_COUNT][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };   // FaceDir
+    const int cam[3] = { csx, csy, csz };
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Node n = queue[head];
+        const int at[3] = { n.sx, n.sy, n.sz };
+        const uint16_t conn = connAt(n.sx, n.sy, n.sz);
+        for (int d = 0; d < FACE_DIR_COUNT; ++d) {
+            const int axis = d >> 1, step = DIR[d][axis];
+            if ((at[axis] - cam[axis]) * step < 0) continue;               // spat ku kamere
+            if (n.in >= 0 && !sectionConnected(conn, n.in, d)) continue;   // vnutri sekcie zavrete
+            const int sx = n.sx + DIR[d][0], sy = n.sy + DIR[d][1], sz = n.sz + DIR[d][2];
+            if (!g.inside(sx, sy, sz)) continue;
+            uint8_t& r = g.reached[g.index(sx, sy, sz)];
+            const int in = d ^ 1;
+            if (r & (1u << in)) continue;
+            if (!r && !sectionInFrustum(f, sx, sy, sz)) continue;
+            r |= uint8_t(1u << in);
+            queue.push_back({ sx, sy, sz, int8_t(in) });
+        }
+    }
+    return true;
+}
+
+// casti chunku, ktorych sekcia bola dosiahnuta (rim = niektora sekcia jeho stlpca, LOD = hocijaka)
+static PartSet caveReachedParts(const CaveGrid& g, const WorldKey& k)
+{
+    PartSet s;
+    for (int ry = 0; ry < REGIONS_Y; ++ry)
+        for (int rz = 0; rz < REGIONS_Z; ++rz)
+            for (int rx = 0; rx < REGIONS_X; ++rx) {
+                const int sx = k.cx * REGIONS_X + rx, sz = k.cz * REGIONS_Z + rz;
+                if (!g.inside(sx, ry, sz) || !g.reached[g.index(sx, ry, sz)]) continue;
+                s.set(PART_REGION0 + regionIndex(rx, ry, rz));
+                if (rx == 0) s.set(PART_RIM_NX);
+                if (rx == REGIONS_X - 1) s.set(PART_RIM_PX);
+                if (rz == 0) s.set(PART_RIM_NZ);
+                if (rz == REGIONS_Z - 1) s.set(PART_RIM_PZ);
+                s.set(PART_LOD);
+            }
+    return s;
+}
+
+// occludery len z chunkov, ktorych mesh na GPU zodpoveda datam (edit/upload nedobehol =>
+// boxy by mohli zakryvat dieru, ktoru este nevidno, alebo naopak)
+static bool occluderReady(const WorldChunk& wc)
+{
+    return wc.lod == 0 && wc.gpu.indexCount > 0 && wc.pendingParts.none() && wc.dirtyParts.none() &&
+        !wc.needsUpload && wc.uploadTicket == 0 && !wc.uploadStream;
+}
+
+static constexpr int OCCLUDER_REBUILDS_PER_FRAME = 2;   // chunkOccluders ~0.25 ms/chunk
+
+// po frustum teste: zakryte chunky/casti z e.visible von
+static void cullOcclusion(World& w, const glm::mat4& viewProj, const glm::vec3& camPos)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    SoftOcclusion& occ = w.softOcc;
+    occ.begin(viewProj, camPos);
+    const int ccx = (int)std::floor((camPos.x / VOXEL_SCALE + 0.5f) / CHUNK_SIZE);
+    const int ccz = (int)std::floor((camPos.z / VOXEL_SCALE + 0.5f) / CHUNK_SIZE);
+    int rebuilds = 0;
+    for (auto& kv : w.map) {
+        WorldChunk& wc = *kv.second;
+        if (std::abs(kv.first.cx - ccx) > w.occluderRadius || std::abs(kv.first.cz - ccz) > w.occluderRadius) continue;
+        if (!occluderReady(wc)) continue;
+        if (wc.occludersDirty) {
+            if (rebuilds >= OCCLUDER_REBUILDS_PER_FRAME) continue;
+            ++rebuilds;
+            wc.occluders.clear();
+            chunkOccluders(wc.data, wc.topY, kv.first.cx, kv.first.cy, kv.first.cz, wc.occluders);
+            wc.occludersDirty = false;
+        }
+        for (const OccluderBox& b : wc.occluders) occ.addOccluder(b);
+    }
+    occ.rasterize();
+
+    auto boxAt = [](const AabbSoA& s, uint32_t i, float mn[3], float mx[3]) {
+        mn[0] = s.minX[i]; mn[1] = s.minY[i]; mn[2] = s.minZ[i];
+        mx[0] = s.maxX[i]; mx[1] = s.maxY[i]; mx[2] = s.maxZ[i];
+    };
+    float mn[3], mx[3];
+    for (size_t i = 0; i < w.cullEntries.size(); ++i) {
+        World::CullEntry& e = w.cullEntries[i];
+        if (!e.chunkVisible) continue;
+        const uint32_t drawn = (uint32_t)e.visible.count();
+        boxAt(w.cullChunks, (uint32_t)i, mn, mx);
+        uint32_t hidden = 0;
+        if (occ.occluded(mn, mx)) {
+            hidden = drawn;
+            e.visible.reset();
+        }
+        else {
+            for (uint32_t j = 0; j < e.partCount; ++j) {
+                const uint8_t slot = w.cullPartSlot[e.firstPart + j];
+                if (!e.visible.test(slot)) continue;
+                boxAt(w.cullParts, e.firstPart + j, mn, mx);
+                if (occ.occluded(mn, mx)) { e.visible.reset(slot); ++hidden; }
+            }
+        }
+        if (hidden == 0) continue;
+        w.cullStats.partsOccluded += hidden;
+        w.cullStats.partsDrawn -= hidden;
+        w.cullStats.partsCulled += hidden;
+        if (e.visible.none()) {
+            e.chunkVisible = false;
+            ++w.cullStats.chunksOccluded;
+            --w.cullStats.chunksDrawn;
+            ++w.cullStats.chunksCulled;
+        }
+    }
+    w.cullStats.occUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void World::cull(const glm::mat4& viewProj, const glm::vec3& camPos)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    if (cullDirty) rebuildCull(*this);
+    const Frustum f = frustumFromMatrix(viewProj);
+    cullFrustum = f;
+    cullViewProj = viewProj;
+
+    // najprv boxy chunkov, potom casti len v chunkoch, ktore presli
+    static thread_local std::vector<uint8_t> chunkVis, partVis;
+    chunkVis.resize(cullEntries.size());
+    frustumCullAabbs(f, cullChunks, 0, (uint32_t)cullEntries.size(), chunkVis.data());
+    cullStats = {};
+
+    // cave culling: dosiahnute sekcie, casti mimo nich ani netestuj
+    static thread_local CaveGrid cave;
+    bool caveOn = false;
+    if (caveCulling) {
+        const auto c0 = std::chrono::steady_clock::now();
+        caveOn = caveTraverse(*this, f, camPos, cave);
+        if (caveOn)
+            for (uint8_t r : cave.reached) cullStats.sectionsVisited += r != 0;
+        cullStats.caveUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - c0).count();
+    }
+
+    for (size_t i = 0; i < cullEntries.size(); ++i) {
+        CullEntry& e = cullEntries[i];
+        e.visible.reset();
+        e.chunkVisible = chunkVis[i] != 0;
+        if (!e.chunkVisible) {
+            ++cullStats.chunksCulled;
+            cullStats.partsCulled += e.partCount;
+            continue;
+        }
+        PartSet reach;
+        if (caveOn) {
+            reach = caveReachedParts(cave, e.key);
+            if (reach.none()) {
+                e.chunkVisible = false;
+                ++cullStats.chunksCulled; ++cullStats.chunksCave;
+                cullStats.partsCulled += e.partCount; cullStats.partsCave += e.partCount;
+                continue;
+            }
+        }
+        partVis.resize(e.partCount);
+        uint32_t n = frustumCullAabbs(f, cullParts, e.firstPart, e.partCount, partVis.data());
+        uint32_t caved = 0;
+        for (uint32_t j = 0; j < e.partCount; ++j) {
+            if (!partVis[j]) continue;
+            const uint8_t slot = cullPartSlot[e.firstPart + j];
+            if (caveOn && !reach.test(slot)) { ++caved; continue; }
+            e.visible.set(slot);
+        }
+        n -= caved;
+        cullStats.partsCave += caved;
+        e.chunkVisible = n > 0;
+        if (!e.chunkVisible && caved) ++cullStats.chunksCave;
+        ++(e.chunkVisible ? cullStats.chunksDrawn : cullStats.chunksCulled);
+        cullStats.partsDrawn += n;
+        cullStats.partsCulled += e.partCount - n;
+    }
+    if (softOcclusion) cullOcclusion(*this, viewProj, camPos);
+    cullReady = true;
+    cullStats.us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void World::recordGpuCull(VulkanContext& ctx, VkCommandBuffer cb, const glm::vec3& camPos)
+{
+    gpuCullRecorded = false;
+    gpuCullLate = false;
+    if (!gpuCulling || !gpuCuller.ready() || !cullReady) return;
+    // pred prepare: ten prepise descriptor slotu, inak by po resize ukazoval na zniceny view
+    if (hiz.generation() != hizGeneration) {
+        gpuCuller.setHiZ(hiz.ready() ? hiz.view() : VK_NULL_HANDLE, hiz.levels(),
+            hiz.depthWidth(), hiz.depthHeight());
+        hizGeneration = hiz.generation();
+    }
+    if (!gpuCuller.prepare(ctx, cullRecords.data(), (uint32_t)cullRecords.size(),
+            (uint32_t)cullPages.size(), cullRecordsChanged)) return;
+    cullRecordsChanged = false;
+    gpuCullPhase = occlusionActive() ? GpuCullPhase::Early : GpuCullPhase::All;
+    gpuCuller.setView(cullFrustum, cullViewProj, camPos);
+    gpuCuller.record(cb, gpuCullPhase);
+    gpuCullRecorded = true;
+}
+
+void World::recordOcclusion(VulkanContext& ctx, VkCommandBuffer cb)
+{
+    if (!gpuCullRecorded || gpuCullPhase != GpuCullPhase::Early) return;
+    hiz.build(cb, ctx);
+    gpuCuller.record(cb, GpuCullPhase::Late);
+    gpuCullLate = true;
+}
+
+// prikazy aj ich pocet zapisal cull.comp; CPU len binduje stranky
+static void drawCullPages(World& w, VkCommandBuffer cb, GpuCullPhase phase, World::DrawStats& st)
+{
+    for (uint32_t i = 0; i < (uint32_t)w.cullPages.size(); ++i) {
+        const World::CullPage& pg = w.cullPages[i];
         VkDeviceSize off = 0;
-        vkCmdBindVertexBuffers(cb, 0, 1, &g.vbo, &off);
-        vkCmdBindIndexBuffer(cb, g.ibo, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(cb, g.indexCount, 1, 0, 0, 0);
+        vkCmdBindVertexBuffers(cb, 0, 1, &pg.vbo, &off);
+        vkCmdBindIndexBuffer(cb, pg.ibo, 0, VK_INDEX_TYPE_UINT32);
+        w.gpuCuller.drawPage(cb, phase, i, pg.outBase, pg.maxDraws);
+        ++st.binds;
+        ++st.calls;
     }
 }
 
-void World::destroyGPU(VulkanContext& ctx) {
-    for (auto& kv : map) destroyChunkGPU(ctx.device, kv.second->gpu);
+void World::drawLate(VkCommandBuffer cb)
+{
+    if (!gpuCullLate) return;
+    gpuCullLate = false;
+    drawCullPages(*this, cb, GpuCullPhase::Late, drawStats);
+}
+
+// menej viditelnych chunkov na ulohu => secondary buffer + bind stavu stoji viac, ako usetri
+static constexpr uint32_t PARALLEL_MIN_CHUNKS = 64;
+
+// casti, ktore draw chunku naozaj nahra (po frustum / cave / occlusion culling)
+static inline uint32_t drawnParts(const World& w, const World::CullEntry& e) {
+    return w.cullReady ? (uint32_t)e.visible.count() : e.partCount;
 }
 
-//  minimal staging uploader (uses your createBuffer/copyBuffer)
-static bool createAndFill(VulkanContext& ctx, const void* data, VkDeviceSize bytes,
-    VkBufferUsageFlags usage, VkBuffer& outB, VkDeviceMemory& outM)
+void World::recordParallel(VulkanContext& ctx, const VkCommandBufferInheritanceInfo& inh, const float* mvp,
+    const glm::vec3& camPos, std::vector<VkCommandBuffer>& out)
 {
-    if (bytes == 0) { outB = VK_NULL_HANDLE; outM = VK_NULL_HANDLE; return true; }
-    VkBuffer staging = VK_NULL_HANDLE; VkDeviceMemory smem = VK_NULL_HANDLE;
-    if (!createBuffer(ctx, bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, staging, smem))
-        return false;
-    void* mapped = nullptr; vkMapMemory(ctx.device, smem, 0, bytes, 0, &mapped);
-    std::memcpy(mapped, data, (size_t)bytes); vkUnmapMemory(ctx.device, smem);
+    parallelRecorded = false;
+    if (!parallelRecording || !recorder.ready() || gpuCullRecorded) return;
+    if (cullDirty) rebuildCull(*this);
+    uint32_t visible = 0, parts = 0;
+    for (const CullEntry& e : cullEntries)
+        if (!cullReady || e.chunkVisible) { ++visible; parts += drawnParts(*this, e); }
+    const uint32_t jobs = std::min((uint32_t)recorder.threadCount(), visible / PARALLEL_MIN_CHUNKS);
+    if (jobs < 2) return;
 
-    if (!createBuffer(ctx, bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outB, outM))
-    {
-        vkDestroyBuffer(ctx.device, staging, nullptr); vkFreeMemory(ctx.device, smem, nullptr); return false;
+    // suvisle kusy drawOrder s podobnym poctom kreslenych casti (poradie ostava => bind na stranku
+    // v kazdom kuse); kazdy dostane vlastny kus indirect bufferu, najviac 3 prikazy na cast
+    // s prepassom su ulohy dvakrat: [0, jobs) len hlbka, [jobs, 2 * jobs) farba tych istych kusov;
+    // secondary buffery sa vykonaju v poradi uloh => cela hlbka je pred prvou farbou
+    struct Job {
+        uint32_t first = 0, last = 0;   // rozsah v drawOrder
+        IndirectDrawRange batch, preBatch;
+        DrawStats st, pre;
+    };
+    std::vector<Job> jobList(jobs);   // nie thread_local: citaju ho vlakna recorder
+    const bool prepass = prepassReady(*this, ctx);
+    drawStats = {};
+    drawIndirect.begin(ctx);
+    buildDrawOrder(*this, camPos);
+    uint32_t at = 0, acc = 0;
+    for (uint32_t j = 0; j < jobs; ++j) {
+        Job& jb = jobList[j];
+        const uint32_t target = uint32_t(uint64_t(parts) * (j + 1) / jobs);
+        uint32_t n = 0;
+        jb.first = at;
+        while (at < (uint32_t)drawOrder.size() && (acc < target || j + 1 == jobs)) {
+            const CullEntry& e = cullEntries[drawOrder[at++]];
+            const uint32_t np = drawnParts(*this, e);
+            acc += np;
+            n += np;
+        }
+        jb.last = at;
+        jb.batch = drawIndirect.reserve(n * GPU_CULL_DRAWS_PER_RECORD);
+        if (prepass) jb.preBatch = drawIndirect.reserve(n * GPU_CULL_DRAWS_PER_RECORD);
     }
 
-    if (!copyBuffer(ctx, staging, outB, bytes))
-    {
-        vkDestroyBuffer(ctx.device, outB, nullptr); vkFreeMemory(ctx.device, outM, nullptr);
-        vkDestroyBuffer(ctx.device, staging, nullptr); vkFreeMemory(ctx.device, smem, nullptr); return false;
+    const uint32_t tasks = prepass ? jobs * 2 : jobs;
+    const bool ok = recorder.record(ctx.device, ctx.currentFrame, inh, tasks, [&](VkCommandBuffer scb, uint32_t t) {
+        Job& jb = jobList[t % jobs];
+        const bool depth = prepass && t < jobs;
+        cmdBindVoxelState(ctx, scb, mvp);
+        if (prepass)
+            vkCmdBindPipeline(scb, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                depth ? ctx.voxelDepthPipeline : voxelColorPipeline(ctx, true));
+        if (depth) drawOpaqueEntries(*this, scb, jb.preBatch, jb.first, jb.last, camPos, jb.pre);
+        else       drawOpaqueEntries(*this, scb, jb.batch, jb.first, jb.last, camPos, jb.st);
+        }, out);
+    if (!ok) return;   // draw nahra opaque na hlavnom vlakne (begin znova od zaciatku bufferu)
+    for (const Job& jb : jobList) {
+        drawStats.draws += jb.st.draws;
+        drawStats.calls += jb.st.calls;
+        drawStats.binds += jb.st.binds;
+        drawStats.indices += jb.st.indices;
+        drawStats.dirSkipped += jb.st.dirSkipped;
+        drawStats.prepassCalls += jb.pre.calls;
     }
+    drawStats.secondaries = tasks;
+    drawStats.recordUs = recorder.stats().us;
+    parallelRecorded = true;
+}
 
-    vkDestroyBuffer(ctx.device, staging, nullptr); vkFreeMemory(ctx.device, smem, nullptr);
+void World::draw(VulkanContext& ctx, VkCommandBuffer cb, const glm::vec3& camPos)
+{
+    if (parallelRecorded) {
+        // opaque uz nahrali vlakna (recordParallel), ich secondary buffery sa vykonaju pred cb
+        parallelRecorded = false;
+        return;
+    }
+    drawStats = {};
+    drawIndirect.begin(ctx);   // novy frame: prikazy od zaciatku bufferu
+    // prepass: tie iste drawy najprv len do hlbky, potom farba s EQUAL; layout je rovnaky =>
+    // descriptor set aj push konstanty platia dalej, na konci zase bezna pipeline pre zvysok sceny
+    const bool prepass = prepassReady(*this, ctx);
+    DrawStats pre;
+    if (gpuCullRecorded) {
+        // indirect prikazy z cull.comp sa daju kreslit dvakrat bez CPU prace
+        // (gpuCullRecorded ostava do dalsieho recordGpuCull, recordOcclusion ho este potrebuje)
+        if (prepass) {
+            vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.voxelDepthPipeline);
+            drawCullPages(*this, cb, gpuCullPhase, pre);
+            vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, voxelColorPipeline(ctx, true));
+        }
+        drawCullPages(*this, cb, gpuCullPhase, drawStats);
+    }
+    else {
+        if (cullDirty) rebuildCull(*this);   // bez cull() (napr. predpripraveny zaznam) => vsetko
+        buildDrawOrder(*this, camPos);
+        const uint32_t n = (uint32_t)drawOrder.size();
+        if (prepass) {
+            vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.voxelDepthPipeline);
+            drawOpaqueEntries(*this, cb, drawIndirect.commands(), 0, n, camPos, pre);
+            vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, voxelColorPipeline(ctx, true));
+        }
+        drawOpaqueEntries(*this, cb, drawIndirect.commands(), 0, n, camPos, drawStats);
+    }
+    if (prepass) {
+        drawStats.prepassCalls = pre.calls;
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, voxelColorPipeline(ctx, false));
+    }
+}
+
+void World::drawTranslucent(VulkanContext& ctx, VkCommandBuffer cb, const glm::vec3& camPos)
+{
+    if (!ctx.voxelTranslucentPipeline || ctx.voxelOverdraw) return;   // heatmapa ukazuje len opaque
+
+    // blend nie je komutativny => chunky odzadu dopredu podla stredu chunku
+    // (vnutri chunku sa nesortuje; hladina je takmer rovina, staci to)
+    static thread_local std::vector<std::pair<float, const CullEntry*>> order;
+    order.clear();
+    const float cs = CHUNK_SIZE * VOXEL_SCALE;
+    if (cullDirty) rebuildCull(*this);
+    for (const CullEntry& e : cullEntries) {
+        const auto& g = *e.gpu;
+        if (g.translucentCount == 0 || (cullReady && !e.chunkVisible)) continue;
+        const glm::vec3 c((g.coord.x + 0.5f) * cs, camPos.y, (g.coord.z + 0.5f) * cs);
+        const glm::vec3 d = c - camPos;
+        order.push_back({ glm::dot(d, d), &e });
+    }
+    if (order.empty()) return;
+    std::sort(order.begin(), order.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    // layout je rovnaky ako opaque pipeline => descriptor set aj push konstanty platia dalej
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.voxelTranslucentPipeline);
+    VkBuffer boundVbo = VK_NULL_HANDLE;
+    for (const auto& it : order) {
+        const CullEntry& e = *it.second;
+        const ChunkGPU& g = *e.gpu;
+        if (g.vbo != boundVbo) {   // poradie je podla vzdialenosti => rebind len pri zmene stranky
+            drawStats.calls += drawIndirect.flush(cb);   // indirect prikazy idu v poradi => blend sedi
+            VkDeviceSize off = 0;
+            vkCmdBindVertexBuffers(cb, 0, 1, &g.vbo, &off);
+            vkCmdBindIndexBuffer(cb, g.ibo, 0, VK_INDEX_TYPE_UINT32);
+            ++drawStats.binds;
+            boundVbo = g.vbo;
+        }
+        for (int p = 0; p < PART_COUNT; ++p) {
+            const auto& sl = g.slots[p];
+            const uint32_t n = sl.indexCount - sl.opaqueCount;
+            if (n == 0 || (cullReady && !e.visible.test(p))) continue;
+            emitDraw(cb, drawIndirect.commands(), n, sl.firstIndex + sl.opaqueCount, (int32_t)sl.firstVertex, drawStats);
+        }
+    }
+    drawStats.calls += drawIndirect.flush(cb);
+}
+
+bool World::initGPU(VulkanContext& ctx) {
+    if (!uploader.init(ctx, VkDeviceSize(stream.stagingRingMB) << 20)) return false;
+    gpuHeap.init(ctx, VkDeviceSize(stream.gpuBlockMB) << 20);
+    geoPool.init(gpuHeap, VkDeviceSize(stream.geoPageMB) << 20, VERT_FLOATS * sizeof(float));
+    drawIndirect.init(ctx, 4096);   // volitelne; rastie podla potreby
+    recorder.init(ctx.device, ctx.graphicsQueueFamily, MAX_FRAMES_IN_FLIGHT);   // volitelne (recordParallel)
     return true;
 }
 
+void World::destroyGPU(VulkanContext& ctx) {
+    gpuCuller.shutdown(ctx);
+    hiz.shutdown(ctx);
+    drawIndirect.shutdown(ctx);
+    recorder.shutdown(ctx.device);
+    uploader.shutdown(ctx);   // dobehne rozbehnute kopie do pendingGpu
+    deletions.flush(ctx);     // device uz stoji (vkDeviceWaitIdle v main)
+    for (auto& kv : map) {
+        destroyChunkGPU(ctx, geoPool, kv.second->gpu);
+        destroyChunkGPU(ctx, geoPool, kv.second->pendingGpu);
+        kv.second->uploadTicket = 0;
+        kv.second->uploadStream.reset();
+    }
+    pendingSwaps = 0;
+    invalidateCull();
+    geoPool.shutdown(ctx);
+    gpuHeap.shutdown(ctx);
+}
+
 static inline int floordiv(int a, int b) {
     int q = a / b;
     int r = a % b;
@@ -145,43 +791,581 @@ static inline bool voxelSolidW(const World& w, int x, int y, int z) {
     return worldVoxelSolid(w, x, y, z);
 }
 
+static MeshBox partBox(int part, int topY);
+
+// kapacita slotu v quadoch: +25% a aspon 16 quadov rezervy, nech drobne edity
+// (vykopany voxel v plnom regione) nemusia prekladat cely chunk
+static uint32_t slotQuads(uint32_t quads, bool inBox) {
+    if (!inBox) return 0;
+    return quads + quads / 4 + 16;
+}
+
+// kolko chunkov za frame presunie GeometryPool compaction (kazdy = novy layout + upload celeho chunku)
+static constexpr int COMPACT_PER_FRAME = 2;
+
+// upload scheduler: cos polovice uhla pohladu, v ktorom je chunk "viditelny"
+// (~horizontalne FOV pri 16:9 a 60 st. vertikalne + rezerva na velkost chunku)
+static constexpr float UPLOAD_VIEW_COS = 0.5f;
+
+struct UploadCandidate {
+    float prio;                  // nizsie = skor
+    const WorldKey* key;
+    WorldChunk* wc;
+};
+
+// Editovane chunky pred vsetkym (blizsie skor), potom streaming vo vyhlade, potom mimo neho
+// (4x dalej) a compaction presuny nakoniec - nic z toho neblokuje kreslenie. Posuny su +-1e6:
+// float tam ma krok 1/16 chunku^2, pri 1e9 by bolo 64 a editacie do ~8 chunkov by mali rovnaku prioritu.
+static float uploadPriority(const World& w, const WorldKey& k, const WorldChunk& wc)
+{
+    const float cs = CHUNK_SIZE * VOXEL_SCALE;
+    const glm::vec3& cam = w.uploadView.pos;
+    const glm::vec3 d((k.cx + 0.5f) * cs - cam.x, 0.0f, (k.cz + 0.5f) * cs - cam.z);
+    const float d2 = glm::dot(d, d) / (cs * cs);   // v chunkoch^2
+
+    if (wc.editT0 != std::chrono::steady_clock::time_point{}) return -1e6f + d2;
+    const glm::vec3 f(w.uploadView.fwd.x, 0.0f, w.uploadView.fwd.z);
+    const float fl = std::sqrt(glm::dot(f, f)), dl = std::sqrt(d2) * cs;
+    const bool inView = d2 <= 2.0f || fl < 1e-4f || glm::dot(d, f) >= UPLOAD_VIEW_COS * dl * fl;
+    float prio = inView ? d2 : 4.0f * d2 + 4.0f;
+    if (wc.relocate) prio += 1e6f;
+    return prio;
+}
+
+// bajty vertexov a indexov poslanych casti
+static void sendBytes(const WorldChunk& wc, const PartSet& send, VkDeviceSize& vBytes, VkDeviceSize& iBytes)
+{
+    vBytes = 0; iBytes = 0;
+    for (int p = 0; p < PART_COUNT; ++p) {
+        if (!send.test(p)) continue;
+        vBytes += wc.parts[p].vertices.size() * sizeof(float);
+        iBytes += wc.parts[p].indices.size() * sizeof(uint32_t);
+    }
+}
+
+// staging layout: [vertices casti...][indices casti...] od dst; srcOffset kopii = base + pozicia
+static void packParts(const WorldChunk& wc, const ChunkGPU& g, const PartSet& send, char* dst, VkDeviceSize base,
+    VkDeviceSize vBytes, std::vector<VkBufferCopy>& vCopies, std::vector<VkBufferCopy>& iCopies)
+{
+    vCopies.clear(); iCopies.clear();
+    VkDeviceSize vOff = 0, iOff = vBytes;
+    for (int p = 0; p < PART_COUNT; ++p) {
+        if (!send.test(p)) continue;
+        const MeshData& m = wc.parts[p];
+        const ChunkGPUSlot& sl = g.slots[p];
+        const VkDeviceSize vb = m.vertices.size() * sizeof(float);
+        const VkDeviceSize ib = m.indices.size() * sizeof(uint32_t);
+        if (vb) {
+            std::memcpy(dst + vOff, m.vertices.data(), (size_t)vb);
+            vCopies.push_back({ base + vOff, VkDeviceSize(sl.firstVertex) * VERT_FLOATS * sizeof(float), vb });
+            vOff += vb;
+        }
+        if (ib) {
+            std::memcpy(dst + iOff, m.indices.data(), (size_t)ib);
+            iCopies.push_back({ base + iOff, VkDeviceSize(sl.firstIndex) * sizeof(uint32_t), ib });
+            iOff += ib;
+        }
+    }
+}
+
+// pocty indexov/vertexov a AABB poslanych casti do slotov g
+static void updateSlots(const WorldChunk& wc, ChunkGPU& g, const PartSet& send)
+{
+    uint32_t idx = 0, verts = 0, trans = 0;
+    for (int p = 0; p < PART_COUNT; ++p) {
+        ChunkGPUSlot& sl = g.slots[p];
+        if (send.test(p)) {
+            const MeshData& m = wc.parts[p];
+            sl.indexCount = (uint32_t)m.indices.size();
+            sl.opaqueCount = m.opaqueIndexCount;
+            sl.dirCount = m.dirIndexCount;
+            for (int a = 0; a < 3; ++a) { sl.aabbMin[a] = m.aabbMin[a]; sl.aabbMax[a] = m.aabbMax[a]; }
+        }
+        idx += sl.indexCount;
+        trans += sl.indexCount - sl.opaqueCount;
+        verts += (uint32_t)(wc.parts[p].vertices.size() / VERT_FLOATS);
+    }
+    g.indexCount = idx;
+    g.translucentCount = trans;
+    g.vertexCount = verts;
+    g.faceCount = idx / 6;
+}
+
+// Nahra dirty casti chunku. Ak sa vsetky zmestia do svojich slotov, prepisu sa na mieste
+// (jeden kus staging ringu, jeden copy na VBO a jeden na IBO); inak sa cely chunk preklada
+// do novych bufferov v pendingGpu, ktore sa zacnu kreslit az po dokonceni kopie (uploadTicket).
+// Plny ring: in-place sa odlozi na dalsi frame (deferred), novy layout ide po kuskoch (uploadStream).
+static bool uploadChunkParts(World& w, VulkanContext& ctx, WorldChunk& wc,
+    uint32_t& outParts, uint64_t& outBytes, bool& deferred)
+{
+    static std::vector<VkBufferCopy> vCopies, iCopies;   // reuse capacity across frames
+    GpuUploader& up = w.uploader;
+    deferred = false;
+
+    bool relayout = wc.relocate || !wc.gpu.vbo || !wc.gpu.ibo;
+    wc.relocate = false;
+    for (int p = 0; p < PART_COUNT && !relayout; ++p) {
+        if (!wc.dirtyParts.test(p)) continue;
+        const MeshData& m = wc.parts[p];
+        if (m.vertices.size() / VERT_FLOATS > wc.gpu.slots[p].vertexCap || m.indices.size() > wc.gpu.slots[p].indexCap)
+            relayout = true;
+    }
+
+    PartSet send = wc.dirtyParts;
+    VkDeviceSize vBytes = 0, iBytes = 0;
+    if (!relayout) {
+        sendBytes(wc, send, vBytes, iBytes);
+        VkBuffer staging = VK_NULL_HANDLE;
+        VkDeviceSize base = 0;
+        char* mapped = (vBytes + iBytes) ? up.allocStaging(ctx, vBytes + iBytes, staging, base) : nullptr;
+        if (vBytes + iBytes == 0 || mapped) {
+            outParts = (uint32_t)send.count();
+            outBytes = vBytes + iBytes;
+            if (mapped) {
+                packParts(wc, wc.gpu, send, mapped, base, vBytes, vCopies, iCopies);
+                up.copyInPlace(ctx, staging, wc.gpu.vbo, vCopies.data(), (uint32_t)vCopies.size());
+                up.copyInPlace(ctx, staging, wc.gpu.ibo, iCopies.data(), (uint32_t)iCopies.size());
+            }
+            updateSlots(wc, wc.gpu, send);
+            return true;
+        }
+        // po kuskoch sa na mieste prepisovat neda (frame by videl polovicu)
+        if (vBytes + iBytes <= up.ringCapacity()) { deferred = true; return true; }
+        relayout = true;
+    }
+
+    ChunkGPU& g = wc.pendingGpu;
+    uint32_t v = 0, i = 0;
+    for (int p = 0; p < PART_COUNT; ++p) {
+        const bool used = ((p == PART_LOD) == (wc.lod > 0)) && !partBox(p, wc.topY).empty();
+        const uint32_t q = slotQuads((uint32_t)(wc.parts[p].indices.size() / 6), used);
+        ChunkGPUSlot& sl = g.slots[p];
+        sl = ChunkGPUSlot{};
+        sl.firstVertex = v; sl.vertexCap = q * 4;
+        sl.firstIndex = i;  sl.indexCap = q * 6;
+        v += sl.vertexCap; i += sl.indexCap;
+    }
+    g.vertexCap = v; g.indexCap = i;
+    send.set();
+    sendBytes(wc, send, vBytes, iBytes);
+    outParts = (uint32_t)send.count();
+    outBytes = vBytes + iBytes;
+    if (outBytes == 0) {
+        // prazdny chunk: netreba buffery ani kopiu, prepni hned
+        retireChunkGPU(w, wc.gpu);
+        wc.gpu = g;
+        wc.pendingGpu = ChunkGPU{};
+        wc.gpu.vertexCount = 0; wc.gpu.faceCount = 0;
+        return true;
+    }
+
+    if (!w.geoPool.alloc(ctx, v, i, g.geo)) return false;
+    g.vbo = w.geoPool.vertexBuffer(g.geo.page);
+    g.ibo = w.geoPool.indexBuffer(g.geo.page);
+    for (auto& sl : g.slots) {
+        sl.firstVertex += g.geo.firstVertex;
+        sl.firstIndex += g.geo.firstIndex;
+    }
+
+    VkBuffer staging = VK_NULL_HANDLE;
+    VkDeviceSize base = 0;
+    if (char* mapped = up.allocStaging(ctx, outBytes, staging, base)) {
+        packParts(wc, g, send, mapped, base, vBytes, vCopies, iCopies);
+        up.copy(ctx, staging, g.vbo, vCopies.data(), (uint32_t)vCopies.size());
+        up.copy(ctx, staging, g.ibo, iCopies.data(), (uint32_t)iCopies.size());
+        wc.uploadTicket = up.ticket();
+    }
+    else {
+        // vacsie nez volne miesto: snapshot bokom (parts sa medzitym mozu zmenit), posiela sa po kuskoch
+        auto s = std::make_unique<UploadStream>();
+        s->data.resize((size_t)outBytes);
+        packParts(wc, g, send, s->data.data(), 0, vBytes, vCopies, iCopies);
+        for (auto& c : vCopies) s->ranges.push_back({ g.vbo, c.srcOffset, c.dstOffset, c.size });
+        for (auto& c : iCopies) s->ranges.push_back({ g.ibo, c.srcOffset, c.dstOffset, c.size });
+        if (up.pump(ctx, *s)) wc.uploadTicket = up.ticket();
+        else wc.uploadStream = std::move(s);
+    }
+    updateSlots(wc, g, send);
+    return true;
+}
+
+// edit -> na GPU (vykresli sa v najblizsom frame)
+static void editVisible(World& w, WorldChunk& wc)
+{
+    if (wc.editT0 == std::chrono::steady_clock::time_point{}) return;
+    auto& L = w.editLatency;
+    L.lastMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - wc.editT0).count();
+    L.maxMs = std::max(L.maxMs, L.lastMs);
+    L.avgMs = (L.avgMs * L.samples + L.lastMs) / float(L.samples + 1);
+    ++L.samples;
+    wc.editT0 = {};
+}
+
+// chunky, ktorych novy layout uz dobehol na GPU, prepni na nove buffery
+static void swapCompletedUploads(World& w, VulkanContext& ctx)
+{
+    w.uploader.poll(ctx);
+    if (w.pendingSwaps == 0) return;
+    for (auto& kv : w.map) {
+        WorldChunk& wc = *kv.second;
+        if (!wc.uploadTicket || !w.uploader.done(wc.uploadTicket)) continue;
+        retireChunkGPU(w, wc.gpu);   // posledny frame ho este moze kreslit
+        wc.gpu = wc.pendingGpu;
+        wc.gpu.coord = { kv.first.cx, kv.first.cy, kv.first.cz };
+        wc.pendingGpu = ChunkGPU{};
+        wc.uploadTicket = 0;
+        --w.pendingSwaps;
+        w.invalidateCull();
+        editVisible(w, wc);
+    }
+}
+
 void worldUploadDirty(World& w, VulkanContext& ctx)
 {
+    swapCompletedUploads(w, ctx);
+    w.deletions.collect(ctx, w.uploader);   // pred alokaciami => uvolnene miesto sa hned pouzije
+
+    // rozbehnute viacframeove uploady maju prednost pred novymi
+    if (w.pendingSwaps > 0) {
+        for (auto& kv : w.map) {
+            WorldChunk& wc = *kv.second;
+            if (!wc.uploadStream || !w.uploader.pump(ctx, *wc.uploadStream)) continue;
+            wc.uploadStream.reset();
+            wc.uploadTicket = w.uploader.ticket();
+        }
+    }
+
+    // compaction: par chunkov z vyprazdnovanej stranky za frame do inych stranok
+    w.geoPool.updateCompaction();
+    int relocs = 0;
+    for (auto& kv : w.map) {
+        if (relocs >= COMPACT_PER_FRAME) break;
+        WorldChunk& wc = *kv.second;
+        if (wc.relocate || wc.uploadTicket || wc.uploadStream || wc.pendingParts.any()) continue;
+        if (!w.geoPool.shouldRelocate(wc.gpu.geo)) continue;
+        wc.relocate = true;
+        wc.needsUpload = true;
+        w.geoPool.noteRelocated();
+        ++relocs;
+    }
+
+    // rozpocet plati na frame (worldUploadDirty sa vola aj viackrat za frame, napr. po edite)
+    using clock = std::chrono::steady_clock;
+    World::UploadQueue& Q = w.uploadQueue;
+    if (Q.frame != ctx.frameSerial) {
+        Q.frame = ctx.frameSerial;
+        Q.frameChunks = 0; Q.frameBytes = 0; Q.frameMs = 0.0f;
+    }
+    const auto t0 = clock::now();
+
+    // pripravene chunky (predosly layout este leti => dalsi frame) do min-heapu podla priority
+    static thread_local std::vector<UploadCandidate> queue;
+    queue.clear();
     for (auto& kv : w.map) {
         WorldChunk& wc = *kv.second;
-        if (!wc.needsUpload) continue;
+        if (!wc.needsUpload || wc.uploadTicket || wc.uploadStream) continue;
+        if (wc.queuedT0 == clock::time_point{}) wc.queuedT0 = t0;
+        queue.push_back({ uploadPriority(w, kv.first, wc), &kv.first, &wc });
+    }
+    const auto later = [](const UploadCandidate& a, const UploadCandidate& b) { return a.prio > b.prio; };
+    std::make_heap(queue.begin(), queue.end(), later);
+
+    const uint64_t budgetBytes = uint64_t(w.stream.budgetUploadKB) << 10;
+    while (!queue.empty()) {
+        const UploadCandidate c = queue.front();
+        WorldChunk& wc = *c.wc;
+        const WorldKey& k = *c.key;
+        const bool edit = wc.editT0 != clock::time_point{};
+        // edity idu vzdy, streaming len kym staci rozpocet (prvy chunk framu vzdy => postup)
+        const float ms = Q.frameMs + std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+        if (!edit && Q.frameChunks > 0 &&
+            (Q.frameChunks >= (uint32_t)w.stream.budgetUpload || Q.frameBytes >= budgetBytes || ms >= w.stream.budgetUploadMs)) {
+            ++Q.budgetHits;
+            break;
+        }
+        std::pop_heap(queue.begin(), queue.end(), later);
+        queue.pop_back();
+
+        uint32_t parts = 0; uint64_t bytes = 0;
+        bool deferred = false;
+        w.invalidateCull();   // sloty (boxy, pocty) sa mohli zmenit
+        if (!uploadChunkParts(w, ctx, wc, parts, bytes, deferred)) {
+            wc.needsUpload = false;
+            wc.queuedT0 = {};
+            fprintf(stderr, "[Mesh] upload failed for chunk (%d,%d,%d)\n", k.cx, k.cy, k.cz);
+            continue;
+        }
+        if (deferred) continue;   // staging ring je plny, skusi sa v dalsom frame
         wc.needsUpload = false;
+        wc.dirtyParts.reset();
+        wc.gpu.coord = { k.cx, k.cy, k.cz };
+        if (edit) {
+            w.editLatency.lastParts = parts;
+            w.editLatency.lastBytes = bytes;
+        }
+        if (wc.uploadTicket || wc.uploadStream) ++w.pendingSwaps;
+        else editVisible(w, wc);
 
-        // destroy previous GPU buffers
-        // (assumes you have this helper in world.cpp)
-        destroyChunkGPU(ctx.device, wc.gpu);
+        ++Q.frameChunks;
+        Q.frameBytes += bytes;
+        Q.waitLastMs = std::chrono::duration<float, std::milli>(clock::now() - wc.queuedT0).count();
+        Q.waitMaxMs = std::max(Q.waitMaxMs, Q.waitLastMs);
+        Q.waitAvgMs = (Q.waitAvgMs * Q.samples + Q.waitLastMs) / float(Q.samples + 1);
+        ++Q.samples;
+        wc.queuedT0 = {};
+    }
+    Q.frameMs += std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+    Q.depth = (uint32_t)queue.size();
+    Q.edits = 0;
+    for (const UploadCandidate& c : queue)
+        if (c.wc->editT0 != clock::time_point{}) ++Q.edits;
 
-        // create + fill VBO
-        if (!wc.meshCPU.vertices.empty()) {
-            createAndFill(ctx,
-                wc.meshCPU.vertices.data(),
-                VkDeviceSize(wc.meshCPU.vertices.size() * sizeof(float)),
-                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                wc.gpu.vbo, wc.gpu.vmem);
+    // vsetky kopie tohto volania v jednom submite
+    w.uploader.flush(ctx);
+    swapCompletedUploads(w, ctx);   // synchronny fallback je hotovy hned
+}
+
+void worldSnapshotVolume(const World& w, const WorldKey& k, const MeshBox& box, MeshVolume& vol)
+{
+    vol.ox = box.x0 - 1; vol.oy = box.y0 - 1; vol.oz = box.z0 - 1;
+    vol.sx = box.x1 - box.x0 + 2;
+    vol.sy = box.y1 - box.y0 + 2;
+    vol.sz = box.z1 - box.z0 + 2;
+    vol.cells.assign(size_t(vol.sx) * vol.sy * vol.sz, BLOCK_AIR);
+
+    // 3x3 susedia v XZ; nenacitany sused = vzduch (rovnako ako predtym mimo chunku)
+    const Chunk* nb[3][3];
+    for (int dz = -1; dz <= 1; ++dz)
+        for (int dx = -1; dx <= 1; ++dx) {
+            auto it = w.map.find(WorldKey{ k.cx + dx, k.cy, k.cz + dz });
+            nb[dz + 1][dx + 1] = (it == w.map.end()) ? nullptr : &it->second->data;
         }
 
-        // create + fill IBO
-        if (!wc.meshCPU.indices.empty()) {
-            createAndFill(ctx,
-                wc.meshCPU.indices.data(),
-                VkDeviceSize(wc.meshCPU.indices.size() * sizeof(uint32_t)),
-                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                wc.gpu.ibo, wc.gpu.imem);
+    const int yBeg = std::max(0, vol.oy), yEnd = std::min(CHUNK_HEIGHT, vol.oy + vol.sy);
+    for (int y = yBeg; y < yEnd; ++y)
+        for (int z = vol.oz; z < vol.oz + vol.sz; ++z) {
+            const int dz = (z < 0) ? -1 : (z >= CHUNK_SIZE ? 1 : 0);
+            const int lz = z - dz * CHUNK_SIZE;
+            BlockID* row = &vol.cells[size_t(vol.sx) * (size_t(z - vol.oz) + size_t(vol.sz) * size_t(y - vol.oy))];
+            for (int x = vol.ox; x < vol.ox + vol.sx; ++x) {
+                const int dx = (x < 0) ? -1 : (x >= CHUNK_SIZE ? 1 : 0);
+                const Chunk* c = nb[dz + 1][dx + 1];
+                if (c) row[x - vol.ox] = c->get(x - dx * CHUNK_SIZE, y, lz);
+            }
         }
+}
+
+// box danej casti, orezany na topY
+static MeshBox partBox(int part, int topY)
+{
+    const int N = CHUNK_SIZE;
+    MeshBox b;
+    switch (part) {
+    case PART_RIM_NX: b = { 0,     0, 0,     1,     topY, N     }; break;
+    case PART_RIM_PX: b = { N - 1, 0, 0,     N,     topY, N     }; break;
+    case PART_RIM_NZ: b = { 1,     0, 0,     N - 1, topY, 1     }; break;
+    case PART_RIM_PZ: b = { 1,     0, N - 1, N - 1, topY, N     }; break;
+    case PART_LOD:    b = { 0,     0, 0,     N,     topY, N     }; break;
+    default: {
+        // region (rx,ry,rz) bez okrajovych stlpcov, tie patria rimom
+        const int ri = part - PART_REGION0;
+        const int rx = ri % REGIONS_X;
+        const int rz = (ri / REGIONS_X) % REGIONS_Z;
+        const int ry = ri / (REGIONS_X * REGIONS_Z);
+        b.x0 = std::max(1, rx * REGION_SIZE);     b.x1 = std::min(N - 1, (rx + 1) * REGION_SIZE);
+        b.z0 = std::max(1, rz * REGION_SIZE);     b.z1 = std::min(N - 1, (rz + 1) * REGION_SIZE);
+        b.y0 = ry * REGION_SIZE;                  b.y1 = std::min(topY, (ry + 1) * REGION_SIZE);
+        break;
+    }
+    }
+    return b;
+}
+
+// Vsetky casti hotove => zahod casti druhej LOD vetvy (stary mesh sa kreslil az doteraz)
+static void finishParts(WorldChunk& wc)
+{
+    if (wc.pendingParts.any()) return;
+    for (int p = 0; p < PART_COUNT; ++p) {
+        const bool keep = (wc.lod > 0) == (p == PART_LOD);
+        if (keep || (wc.parts[p].indices.empty() && wc.gpu.slots[p].indexCount == 0)) continue;
+        wc.parts[p] = MeshData{};
+        wc.dirtyParts.set(p);
+    }
+    if (wc.dirtyParts.any()) wc.needsUpload = true;
+}
+
+static void requestPart(World& w, const WorldKey& k, WorldChunk& wc, int p)
+{
+    wc.partVersion[p] = ++w.versionCounter;
+    MeshBox box = partBox(p, wc.topY);
+    if (box.empty()) {
+        // nad topY => nic na meshovanie, rovno prazdna cast
+        wc.pendingParts.reset(p);
+        if (!wc.parts[p].indices.empty() || wc.gpu.slots[p].indexCount) wc.dirtyParts.set(p);
+        wc.parts[p] = MeshData{};
+        if (p >= PART_REGION0 && p < PART_LOD) wc.sectionConn[p - PART_REGION0] = SECTION_CONN_ALL;   // cely vzduch
+        return;
+    }
+
+    auto vol = std::make_shared<MeshVolume>();
+    worldSnapshotVolume(w, k, box, *vol);
+
+    MeshJob job;
+    job.cx = k.cx; job.cy = k.cy; job.cz = k.cz;
+    job.part = p;
+    job.lod = (p == PART_LOD) ? wc.lod : 0;
+    job.version = wc.partVersion[p];
+    job.box = box;
+    job.volume = std::move(vol);
+    job.cache = &w.meshCache;
+    if (p >= PART_REGION0 && p < PART_LOD) job.section = p - PART_REGION0;
+    wc.pendingParts.set(p);
+    w.meshWorkers.submit(std::move(job));
+}
+
+// zahod rozbehnutu cast (jej vysledok pride so starou verziou)
+static void cancelPart(World& w, WorldChunk& wc, int p)
+{
+    if (!wc.pendingParts.test(p)) return;
+    wc.partVersion[p] = ++w.versionCounter;
+    wc.pendingParts.reset(p);
+}
+
+void worldRequestMeshParts(World& w, const WorldKey& k, WorldChunk& wc, const PartSet& parts)
+{
+    if (wc.lod > 0) {
+        // vzdialeny chunk ma jeden LOD mesh so skirtom; samotne rimy (zmena suseda) ho nemenia
+        PartSet body = parts;
+        body.reset(PART_RIM_NX); body.reset(PART_RIM_PX); body.reset(PART_RIM_NZ); body.reset(PART_RIM_PZ);
+        if (body.none()) return;
+        // regiony sa nemeshuju => ich sekcie nemaju nove prepojenie, kym su otvorene
+        for (int p = PART_REGION0; p < PART_LOD; ++p)
+            if (body.test(p)) wc.sectionConn[p - PART_REGION0] = SECTION_CONN_ALL;
+        for (int p = 0; p < PART_LOD; ++p) cancelPart(w, wc, p);
+        requestPart(w, k, wc, PART_LOD);
+    }
+    else {
+        if (parts.test(PART_LOD)) cancelPart(w, wc, PART_LOD);
+        for (int p = 0; p < PART_LOD; ++p)
+            if (parts.test(p)) requestPart(w, k, wc, p);
+    }
+    finishParts(wc);
+}
+
+static int lodForDistance(const World& w, int d)
+{
+    int lod = 0;
+    for (int i = 0; i < MESH_LOD_COUNT - 1; ++i)
+        if (d >= w.stream.lodRing[i]) lod = i + 1;
+    return lod;
+}
+
+int worldLodFor(const World& w, const WorldKey& k)
+{
+    const int d = std::max(std::abs(k.cx - w.lodCx), std::abs(k.cz - w.lodCz));
+    return lodForDistance(w, d);
+}
 
-        wc.gpu.indexCount = static_cast<uint32_t>(wc.meshCPU.indices.size());
-        // wc.gpu.coord already set when chunk was created
+void worldUpdateLod(World& w, int centerCx, int centerCz)
+{
+    if (centerCx == w.lodCx && centerCz == w.lodCz) return;
+    w.lodCx = centerCx; w.lodCz = centerCz;
+
+    int changed = 0;
+    for (auto& kv : w.map) {
+        WorldChunk& wc = *kv.second;
+        const int want = worldLodFor(w, kv.first);
+        if (want == wc.lod) continue;
+        // hrubsi LOD az o chunk dalej nez hranica kruhu, nech pri prechadzani tam a spat neblika
+        const int d = std::max(std::abs(kv.first.cx - centerCx), std::abs(kv.first.cz - centerCz));
+        if (want > wc.lod && lodForDistance(w, d - 1) <= wc.lod) continue;
+        wc.lod = want;
+        worldRequestMesh(w, kv.first, wc);
+        ++changed;
     }
+    if (changed) printf("[Mesh] LOD center (%d,%d): %d chunk(s) changed level\n", centerCx, centerCz, changed);
+}
+
+// rim casti suseda, ktory vidi zmeneny chunk na strane (ex,ez) (z pohladu suseda)
+static PartSet rimPartsFacing(int ex, int ez)
+{
+    PartSet s;
+    if (ex != 0) {
+        s.set(ex < 0 ? PART_RIM_NX : PART_RIM_PX);
+        return s;                                    // X strana / diagonala: rohovy stlpec je v X rime
+    }
+    // Z strana: Z rim + oba X rimy (obsahuju rohy z = 0 / 63)
+    s.set(ez < 0 ? PART_RIM_NZ : PART_RIM_PZ);
+    s.set(PART_RIM_NX); s.set(PART_RIM_PX);
+    return s;
+}
+
+static void requestNeighborRims(World& w, const WorldKey& k, int dx, int dz)
+{
+    WorldKey nk{ k.cx + dx, k.cy, k.cz + dz };
+    WorldChunk* n = w.find(nk);
+    if (!n) return;
+    worldRequestMeshParts(w, nk, *n, rimPartsFacing(-dx, -dz));
+}
+
+void worldNotifyNeighbors(World& w, const WorldKey& k)
+{
+    for (int dz = -1; dz <= 1; ++dz)
+        for (int dx = -1; dx <= 1; ++dx)
+            if (dx || dz) requestNeighborRims(w, k, dx, dz);
+}
+
+void worldNotifyBorderVoxel(World& w, const WorldKey& k, int lx, int lz)
+{
+    const int ex = (lx == 0) ? -1 : (lx == CHUNK_SIZE - 1 ? 1 : 0);
+    const int ez = (lz == 0) ? -1 : (lz == CHUNK_SIZE - 1 ? 1 : 0);
+    if (ex) requestNeighborRims(w, k, ex, 0);
+    if (ez) requestNeighborRims(w, k, 0, ez);
+    if (ex && ez) requestNeighborRims(w, k, ex, ez);
+}
+
+void worldChunkArrived(World& w, const WorldKey& k, WorldChunk& wc)
+{
+    wc.topY = chunkTopY(wc.data);
+    wc.occludersDirty = true;
+    wc.lod = worldLodFor(w, k);
+    worldRequestMesh(w, k, wc);
+    worldNotifyNeighbors(w, k);
+}
+
+int worldCollectMeshes(World& w)
+{
+    static std::vector<MeshResult> results; // reuse capacity across frames
+    results.clear();
+    if (w.meshWorkers.drain(results) == 0) return 0;
+
+    int accepted = 0;
+    for (auto& r : results) {
+        WorldChunk* wc = w.find(WorldKey{ r.cx, r.cy, r.cz });
+        // chunk medzitym odlozeny alebo cast znova zadana => vysledok je stary
+        if (!wc || wc->partVersion[r.part] != r.version) { ++w.meshWorkers.stats.stale; continue; }
+
+        wc->parts[r.part] = std::move(r.mesh);
+        if (r.section >= 0) wc->sectionConn[r.section] = r.sectionConn;
+        wc->pendingParts.reset(r.part);
+        wc->dirtyParts.set(r.part);
+        // upload az ked su hotove vsetky casti (novy chunk bez okraja / polovica editu /
+        // polovica prechodu medzi LOD by blikala)
+        finishParts(*wc);
+        ++accepted;
+    }
+    results.clear();
+    return accepted;
 }
 
 void World::clearAllChunks() {
-    // If you have GPU buffers in chunks, defer-destroy them here
+    for (auto& kv : map) {
+        retireChunkGPU(*this, kv.second->gpu);
+        retireChunkGPU(*this, kv.second->pendingGpu);
+    }
     map.clear();
+    pendingSwaps = 0;
+    invalidateCull();
 }
 
 WorldChunk* World::createChunk(const WorldKey& k) {
@@ -203,8 +1387,14 @@ void World::destroyChunk(const WorldKey& k) {
     auto it = map.find(k);
     if (it == map.end()) return;
 
-    // If you have GPU buffers in it->second->gpu, defer-destroy them here
-    // deferDestroyBuffer(ctx, ...);  // (only if youve got a GC in place)
+    WorldChunk& wc = *it->second;
+    if (wc.uploadTicket || wc.uploadStream) --pendingSwaps;
+    // gpu moze kreslit rozbehnuty frame, do pendingGpu moze este kopirovat upload batch
+    retireChunkGPU(*this, wc.gpu);
+    retireChunkGPU(*this, wc.pendingGpu);
 
     map.erase(it);
+    invalidateCull();
+    // susedia mali tuto stranu zakrytu => ich okraje treba premeshovat
+    worldNotifyNeighbors(*this, k);
 }
\ No newline at end of file
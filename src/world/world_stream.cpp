@@ -13,13 +13,13 @@ static inline bool hasChunk(const World& w, const WorldKey& k) {
     return w.map.find(k) != w.map.end();
 }
 
-// create + generate + mesh + flag upload
+// create + generate + queue mesh (upload after worldCollectMeshes)
 static void createOne(World& w, VulkanContext& ctx, const WorldKey& k) {
     auto wc = std::make_unique<WorldChunk>();
     generateChunk(wc->data, { k.cx, k.cy, k.cz }, w.seed);
-    wc->meshCPU = meshChunkAt(wc->data, k.cx, k.cy, k.cz);
-    wc->needsUpload = true;
+    WorldChunk& ref = *wc;
     w.map.emplace(k, std::move(wc));
+    worldChunkArrived(w, k, ref);   // + okraje susedov
     printf("[Stream] + chunk (%d,%d,%d)\n", k.cx, k.cy, k.cz);
 }
 
@@ -33,8 +33,7 @@ int ensureChunkColumn(World& w, VulkanContext& ctx, int cx, int cz) {
             ++made;
         }
     }
-    if (made) worldUploadDirty(w, ctx); // compact upload of anything flagged
-    return made;
+    return made; // meshe pridu cez worldCollectMeshes v dalsom ticku
 }
 
 int streamEnsureAround(World& w, VulkanContext& ctx, int centerCx, int centerCz, int view) {
@@ -72,7 +71,7 @@ int streamUnloadFar(World& w, int centerCx, int centerCz, int view) {
 
 // ===== THE MISSING FUNCTION THAT TIES EVERYTHING TOGETHER =====
 void worldStreamTick(World& w, VulkanContext& ctx,
-    const glm::vec3& camPos, const glm::vec3& /*camFwd*/) {
+    const glm::vec3& camPos, const glm::vec3& camFwd) {
 
     // Convert player world position to chunk coordinates
     // camPos is in world space (scaled by VOXEL_SCALE = 0.25)
@@ -102,12 +101,22 @@ void worldStreamTick(World& w, VulkanContext& ctx,
             camPos.x, camPos.y, camPos.z, vx, vz, cx, cz, w.map.size());
     }
 
+    // LOD rings follow the camera chunk (before loading, so new chunks pick the right level)
+    worldUpdateLod(w, cx, cz);
+    // upload priority: distance to the camera + whether the chunk is in front of it
+    w.uploadView.pos = camPos;
+    w.uploadView.fwd = camFwd;
+
     // Load chunks around player position
     int loaded = streamEnsureAround(w, ctx, cx, cz, viewRadius);
 
     // Unload chunks beyond keep radius
     int unloaded = streamUnloadFar(w, cx, cz, keepRadius);
 
+    // Finished meshes from the worker pool (stale ones are dropped) -> GPU
+    worldCollectMeshes(w);
+    worldUploadDirty(w, ctx);
+
     // Optional: Log when chunks are created/destroyed
     if (loaded > 0 || unloaded > 0) {
         printf("[Stream] Tick: loaded=%d, unloaded=%d, total=%zu\n",